@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace jarvis {
+
+/**
+ * @brief Cheap energy gate in front of an expensive detector
+ *
+ * Each frame costs one integer sum of squares. The gate opens when a frame
+ * is louder than both an absolute minimum and the tracked background by a
+ * margin, and holds open long enough to cover a whole keyword. On opening
+ * the caller replays lookbackSamples() of audio before the frame, so the
+ * quiet onset of a word that triggered it part-way is not lost.
+ */
+class ActivityGate {
+public:
+    struct Params {
+        float minRms = 0.003f;          // never opens below this level
+        float openMarginDb = 9.0f;      // opens this far above the background
+        int holdMs = 1500;              // stays open this long after the last loud frame
+        int lookbackMs = 500;           // audio replayed when it opens
+        float floorRiseDbPerSecond = 6.0f;
+    };
+
+    // Counters may be read from any thread
+    struct Stats {
+        uint64_t frames = 0;
+        uint64_t openFrames = 0;        // frames passed to the detector
+        uint64_t openings = 0;
+
+        // Fraction of frames the gate was open
+        double dutyCycle() const { return frames ? static_cast<double>(openFrames) / frames : 0.0; }
+    };
+
+    explicit ActivityGate(int sampleRate);
+    ActivityGate(int sampleRate, const Params& params);
+
+    void setParams(const Params& params);
+    const Params& getParams() const { return params_; }
+
+    /**
+     * @brief Classify one frame
+     * @return true if the frame should go to the detector
+     */
+    bool process(const int16_t* frame, size_t frameSize);
+
+    /**
+     * @brief True if the last process() call opened the gate
+     */
+    bool justOpened() const { return justOpened_; }
+
+    size_t lookbackSamples() const;
+
+    /**
+     * @brief Count frames replayed to the detector on opening
+     *
+     * They passed through process() while the gate was closed, so without
+     * this the duty cycle leaves out the detector's work on the lookback.
+     */
+    void countReplayed(uint64_t frames);
+
+    bool isOpen() const { return open_; }
+
+    // Background level in mean-square 16-bit units
+    double backgroundLevel() const { return background_; }
+
+    Stats getStats() const;
+
+    // Close the gate and forget the background; counters are kept
+    void reset();
+
+private:
+    int sampleRate_;
+    Params params_;
+
+    // Precomputed from params_
+    uint64_t minimumSquared_ = 0;   // (minRms * 32768)^2
+    double openRatio_ = 1.0;
+    double riseFactorPerSample_ = 1.0;
+    uint64_t holdSamples_ = 0;
+
+    double background_ = -1.0;      // tracked mean square; negative until the first frame
+    bool open_ = false;
+    bool justOpened_ = false;
+    uint64_t sinceLoud_ = 0;
+
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> openFrames_{0};
+    std::atomic<uint64_t> openings_{0};
+};
+
+} // namespace jarvis
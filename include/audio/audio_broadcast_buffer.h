@@ -0,0 +1,190 @@
+#pragma once
+
+#include "audio/audio_ring_buffer.h"
+#include "audio/audio_timestamp.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace jarvis {
+
+/**
+ * @brief Single-writer, multi-reader broadcast ring for audio
+ *
+ * The writer publishes each sample once and never waits for readers.
+ * Every reader owns a cursor into the shared storage, so fan-out to wake
+ * word, VAD, STT, recording etc. needs neither extra copies nor duplicate
+ * buffers. A reader that falls more than capacity() samples behind is
+ * overrun: its cursor jumps to the oldest sample still in the ring and
+ * the skipped samples are counted.
+ *
+ * Readers can copy out with read() or work in place with peek()/consume();
+ * consume() reports whether the peeked region was overwritten while it was
+ * being used.
+ *
+ * Writes may carry the capture timestamp of their first frame; any bus
+ * position still in the ring can then be mapped back onto the capture
+ * timeline with timestampAt().
+ */
+class AudioBroadcastBuffer {
+public:
+    using ReaderId = size_t;
+
+    static constexpr size_t kMaxReaders = 8;
+    static constexpr ReaderId kInvalidReader = static_cast<ReaderId>(-1);
+
+    struct ReaderStats {
+        std::string name;
+        size_t lagSamples = 0;
+        size_t maxLagSamples = 0;   // high-water mark of lagSamples
+        uint64_t overruns = 0;
+        uint64_t droppedSamples = 0;
+    };
+
+    /**
+     * @param capacity Ring size in samples (rounded up to a power of two)
+     * @param sampleRate Frame rate used to interpolate timestamps
+     * @param channels Interleaved samples per frame
+     */
+    explicit AudioBroadcastBuffer(size_t capacity, int sampleRate = 16000, int channels = 1);
+    ~AudioBroadcastBuffer();
+
+    AudioBroadcastBuffer(const AudioBroadcastBuffer&) = delete;
+    AudioBroadcastBuffer& operator=(const AudioBroadcastBuffer&) = delete;
+
+    /**
+     * @brief Register a consumer; its cursor starts at the current write position
+     * @return Reader id, or kInvalidReader if all slots are taken
+     */
+    ReaderId addReader(const std::string& name);
+    void removeReader(ReaderId reader);
+
+    /**
+     * @brief Publish samples to all readers (writer thread only)
+     */
+    void write(const int16_t* data, size_t count);
+
+    /**
+     * @brief Publish samples whose first frame was captured at stamp
+     */
+    void write(const int16_t* data, size_t count, const AudioTimestamp& stamp);
+
+    /**
+     * @brief Capture timestamp of the sample at an absolute bus position
+     * @return Timestamp interpolated from the nearest stamped write, or an
+     *         invalid one if nothing stamped has been written
+     */
+    AudioTimestamp timestampAt(uint64_t position) const;
+
+    /**
+     * @brief Copy up to count samples for this reader and advance its cursor
+     * @return Number of samples read
+     */
+    size_t read(ReaderId reader, int16_t* buffer, size_t count);
+
+    /**
+     * @brief Contiguous region of up to count unread samples, without copying
+     */
+    std::span<const int16_t> peek(ReaderId reader, size_t count);
+
+    /**
+     * @brief Advance past count peeked samples
+     * @return false if the region was overwritten before it was consumed
+     */
+    bool consume(ReaderId reader, size_t count);
+
+    /**
+     * @brief Move a reader's cursor to an absolute sample position
+     */
+    void seek(ReaderId reader, uint64_t position);
+
+    /**
+     * @brief Skip everything a reader has not read yet
+     */
+    void seekToLatest(ReaderId reader);
+
+    /**
+     * @brief Block until this reader has count samples available
+     * @return true if they are; false on timeout or interrupt()
+     */
+    bool waitForAvailable(ReaderId reader, size_t count, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Writer side: block until a reader is at most maxLag samples behind
+     *
+     * Lets a free-running producer (file or synthetic source) go exactly as
+     * fast as a consumer keeps up instead of overrunning it.
+     * @return true if caught up; false on timeout or interrupt()
+     */
+    bool waitForReader(ReaderId reader, size_t maxLag, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Wake every thread blocked in waitForAvailable() or waitForReader()
+     */
+    void interrupt() {
+        dataSignal_.interrupt();
+        progressSignal_.interrupt();
+    }
+
+    size_t available(ReaderId reader) const;
+    uint64_t readPosition(ReaderId reader) const {
+        return readers_[reader].position.load(std::memory_order_acquire);
+    }
+    uint64_t writePosition() const { return tail_.load(std::memory_order_acquire); }
+    size_t capacity() const { return capacity_; }
+
+    ReaderStats getReaderStats(ReaderId reader) const;
+    std::vector<ReaderStats> getAllReaderStats() const;
+
+private:
+    struct alignas(kCacheLineSize) Reader {
+        std::atomic<uint64_t> position{0};
+        std::atomic<uint64_t> overruns{0};
+        std::atomic<uint64_t> droppedSamples{0};
+        std::atomic<size_t> maxLag{0};
+        std::atomic<bool> active{false};
+        std::string name;
+    };
+
+    // Bus position of a stamped write; the newest kMaxAnchors are kept
+    struct Anchor {
+        std::atomic<uint64_t> position{0};
+        std::atomic<uint64_t> frameIndex{0};
+        std::atomic<int64_t> captureTicks{0};
+    };
+    static constexpr size_t kMaxAnchors = 1024;
+
+    // Clamp an overrun cursor to the oldest intact sample
+    uint64_t validPosition(Reader& reader);
+    void recordOverrun(Reader& reader, uint64_t from, uint64_t to);
+    void recordLag(Reader& reader, uint64_t pos, uint64_t tail);
+
+    const size_t capacity_;
+    const size_t mask_;
+    const int sampleRate_;
+    const int channels_;
+    std::vector<int16_t> buffer_;
+
+    std::array<Anchor, kMaxAnchors> anchors_;
+    // Like writeStart_/tail_: a slot is being rewritten once anchorStart_ passes it
+    std::atomic<uint64_t> anchorStart_{0};
+    std::atomic<uint64_t> anchorCount_{0};
+
+    // writeStart_ is published before the copy, tail_ after it
+    alignas(kCacheLineSize) std::atomic<uint64_t> writeStart_{0};
+    std::atomic<uint64_t> tail_{0};
+
+    FillLevelSignal dataSignal_;
+    FillLevelSignal progressSignal_;
+
+    std::array<Reader, kMaxReaders> readers_;
+    mutable std::mutex readersMutex_;
+};
+
+} // namespace jarvis
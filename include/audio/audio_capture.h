@@ -1,23 +1,40 @@
 #pragma once
 
+#include "audio/audio_ring_buffer.h"
+#include "audio/audio_source.h"
+#include "audio/audio_timestamp.h"
+#include <cstdint>
 #include <functional>
 #include <vector>
 #include <memory>
-
-// Forward declaration for PortAudio
-typedef struct PaStream PaStream;
+#include <string>
 
 namespace jarvis {
 
+class AudioPlayer;
+
+/**
+ * @brief How captured audio reaches the AudioCallback
+ */
+enum class CaptureMode {
+    // Device callback only copies into a preallocated lock-free queue;
+    // a separate delivery thread invokes the AudioCallback
+    RealTimeSafe,
+    // AudioCallback runs directly on the device's real-time thread
+    Direct
+};
+
 /**
  * @brief Audio capture using PortAudio
- * 
+ *
  * This class provides cross-platform audio capture functionality
- * using the PortAudio library.
+ * using the PortAudio library. An AudioSource can replace the device,
+ * e.g. to run from files or generated audio on headless machines.
  */
 class AudioCapture {
 public:
     using AudioCallback = std::function<void(const std::vector<int16_t>&)>;
+    using TimedAudioCallback = std::function<void(const std::vector<int16_t>&, const AudioTimestamp&)>;
 
     AudioCapture();
     ~AudioCapture();
@@ -29,16 +46,48 @@ public:
      * @param framesPerBuffer Buffer size (default: 1024)
      * @return true if initialization successful, false otherwise
      */
-    bool initialize(int sampleRate = 16000, 
-                   int channels = 1, 
+    bool initialize(int sampleRate = 16000,
+                   int channels = 1,
                    int framesPerBuffer = 1024);
 
+    /**
+     * @brief Select how audio is delivered (default: RealTimeSafe)
+     * @param mode Capture mode; takes effect on the next startCapture()
+     */
+    void setCaptureMode(CaptureMode mode);
+
+    /**
+     * @brief Capture from a source instead of the default input device
+     * @param source Audio source; its sample rate and channels are used
+     * @param pacing Real-time clocking, or as fast as the callback returns
+     */
+    void setSource(std::unique_ptr<AudioSource> source,
+                   SourcePacing pacing = SourcePacing::RealTime);
+
+    /**
+     * @brief Drive a player from this capture's stream (full duplex)
+     *
+     * Input and output then share one device clock and each output buffer
+     * is rendered in the same callback as the input it lines up with, before
+     * that input is delivered. With a source, the player is clocked by the
+     * source instead. Call before startCapture(); the player must use the
+     * capture's sample rate.
+     * @param player Player to drive, or nullptr to detach
+     */
+    void attachPlayer(AudioPlayer* player);
+
     /**
      * @brief Start audio capture
      * @param callback Function to call with audio data
      */
     void startCapture(AudioCallback callback);
 
+    /**
+     * @brief Start audio capture with the timestamp of each block's first frame
+     * @param callback Function to call with audio data and its capture timestamp
+     */
+    void startCapture(TimedAudioCallback callback);
+
     /**
      * @brief Stop audio capture
      */
@@ -46,21 +95,39 @@ public:
 
     /**
      * @brief Check if capture is running
-     * @return true if running, false otherwise
+     * @return true if running, false otherwise (including when a source is exhausted)
      */
-    bool isRunning() const { return running_; }
+    bool isRunning() const;
 
     /**
      * @brief Get sample rate
      * @return Current sample rate in Hz
      */
-    int getSampleRate() const { return sampleRate_; }
+    int getSampleRate() const;
 
     /**
      * @brief Get number of channels
      * @return Number of channels
      */
-    int getChannels() const { return channels_; }
+    int getChannels() const;
+
+    /**
+     * @brief Samples dropped because the delivery thread fell behind
+     * @return Dropped sample count since startCapture()
+     */
+    uint64_t getDroppedSamples() const;
+
+    /**
+     * @brief Input overflows reported by the device
+     * @return Overflow count since startCapture()
+     */
+    uint64_t getInputOverflows() const;
+
+    /**
+     * @brief Drop, high-water and stall counters of the capture queue
+     * @return Counters since startCapture(); all zero in Direct mode
+     */
+    AudioRingBuffer::Stats getBufferStats() const;
 
     /**
      * @brief Get available audio devices
@@ -69,21 +136,8 @@ public:
     static std::vector<std::string> getAudioDevices();
 
 private:
-    PaStream* stream_;
-    AudioCallback callback_;
-    bool running_;
-    int sampleRate_;
-    int channels_;
-    int framesPerBuffer_;
-
-    static int portAudioCallback(const void* input,
-                                void* output,
-                                unsigned long frameCount,
-                                const void* timeInfo,
-                                void* statusFlags,
-                                void* userData);
-
-    void processAudioData(const int16_t* input, unsigned long frameCount);
+    class AudioCaptureImpl;
+    std::unique_ptr<AudioCaptureImpl> impl_;
 };
 
-} // namespace jarvis
\ No newline at end of file
+} // namespace jarvis
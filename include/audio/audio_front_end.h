@@ -0,0 +1,94 @@
+#pragma once
+
+#include "audio/audio_resampler.h"
+#include "audio/audio_timestamp.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace jarvis {
+
+/**
+ * @brief Shared conditioning stage between capture and every consumer
+ *
+ * Runs once per captured mono block on the capture thread: converts to
+ * the processing rate, removes DC with a one-pole highpass and produces
+ * the block both as 16-bit PCM (for the bus, wake word and STT engines)
+ * and as float in [-1, 1) for DSP stages. Every consumer therefore sees
+ * the same samples at the same bus positions, and the resampling is done
+ * once rather than once per consumer.
+ *
+ * Output views are valid until the next process() call.
+ */
+class AudioFrontEnd {
+public:
+    // Rate the wake word and speech engines run at
+    static constexpr int kProcessingRate = 16000;
+
+    /**
+     * @param inputRate Capture rate
+     * @param maxFrames Capture block size to preallocate for; larger blocks grow the buffers
+     * @param outputRate Processing rate
+     */
+    AudioFrontEnd(int inputRate, size_t maxFrames = 0, int outputRate = kProcessingRate);
+
+    /**
+     * @brief Condition one captured block
+     * @param input Mono frames at the input rate
+     * @param stamp Capture timestamp of the first input frame
+     * @return Frames produced at the output rate
+     */
+    size_t process(std::span<const int16_t> input, const AudioTimestamp& stamp);
+
+    // Views of the last processed block
+    std::span<const int16_t> pcm() const { return {pcm_.data(), frames_}; }
+    std::span<const float> samples() const { return {samples_.data(), frames_}; }
+
+    /**
+     * @brief Timestamp of the first output frame, on the output-rate timeline
+     *
+     * frameIndex counts output-rate frames since capture started, dropped
+     * capture frames included; captureTime is when the input the frame was
+     * filtered from was captured, net of the filter delay.
+     */
+    const AudioTimestamp& timestamp() const { return stamp_; }
+
+    /**
+     * @brief Enable or disable DC removal (on by default)
+     * @param cutoffHz Highpass corner frequency
+     */
+    void setDcRemoval(bool enabled, double cutoffHz = 10.0);
+
+    /**
+     * @brief Forget filter state, e.g. after a capture restart
+     */
+    void reset();
+
+    int getInputRate() const { return inputRate_; }
+    int getOutputRate() const { return outputRate_; }
+
+private:
+    void reserve(size_t frames);
+
+    int inputRate_;
+    int outputRate_;
+    AudioResampler resampler_;
+
+    std::vector<int16_t> pcm_;
+    std::vector<float> samples_;
+    size_t frames_ = 0;
+    AudioTimestamp stamp_;
+
+    // Input and output frames since the last reset; locate each output block on the input timeline
+    uint64_t inputFrames_ = 0;
+    uint64_t outputFrames_ = 0;
+
+    // DC blocker y[n] = x[n] - x[n-1] + pole * y[n-1]
+    bool dcRemoval_ = true;
+    float pole_ = 1.0f;
+    float lastInput_ = 0.0f;
+    float lastOutput_ = 0.0f;
+};
+
+} // namespace jarvis
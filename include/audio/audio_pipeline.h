@@ -1,10 +1,21 @@
 #pragma once
 
+#include "audio/activity_gate.h"
+#include "audio/audio_broadcast_buffer.h"
+#include "audio/audio_front_end.h"
+#include "audio/channel_mixer.h"
+#include "audio/echo_canceller.h"
+#include "audio/endpointer.h"
+#include "audio/audio_source.h"
+#include "audio/spectral_features.h"
+#include "audio/voice_activity_detector.h"
+#include "speech/wake_word_detector.h"
 #include <atomic>
 #include <cstdint>
 #include <vector>
 #include <functional>
 #include <memory>
+#include <string>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -12,10 +23,11 @@
 namespace jarvis {
 
 // Forward declarations
-class WakeWordDetector;
 class SpeechRecognizer;
 class TextToSpeech;
 class AudioCapture;
+class AudioPlayer;
+class ConfigManager;
 
 enum class PipelineState {
     IDLE,
@@ -25,124 +37,288 @@ enum class PipelineState {
     ERROR
 };
 
-// Lock-free ring buffer for audio data
-class AudioRingBuffer {
-public:
-    AudioRingBuffer(size_t capacity);
-    ~AudioRingBuffer();
-
-    bool write(const int16_t* data, size_t count);
-    size_t read(int16_t* buffer, size_t count);
-    size_t available() const;
-    size_t freeSpace() const;
-    void clear();
-
-private:
-    std::vector<int16_t> buffer_;
-    std::atomic<size_t> head_{0};
-    std::atomic<size_t> tail_{0};
-    const size_t capacity_;
-};
-
-// Audio resampler for format normalization
-class AudioResampler {
-public:
-    AudioResampler(int inputRate, int outputRate, int channels = 1);
-    ~AudioResampler();
-
-    std::vector<int16_t> resample(const int16_t* input, size_t inputFrames);
-    void reset();
-
-private:
-    int inputRate_;
-    int outputRate_;
-    int channels_;
-    double ratio_;
-    double accumulator_;
-};
-
-// Voice Activity Detection (VAD)
-class VoiceActivityDetector {
-public:
-    VoiceActivityDetector(int sampleRate, int frameSize);
-    ~VoiceActivityDetector();
-
-    bool processFrame(const int16_t* frame, size_t frameSize);
-    void setThreshold(float threshold);
-    void setSilenceTimeout(int ms);
-
-private:
-    int sampleRate_;
-    int frameSize_;
-    float threshold_;
-    int silenceTimeoutMs_;
-    int silentFrames_;
-    bool voiceDetected_;
-};
-
 // Audio pipeline manager
 class AudioPipeline {
 public:
     using WakeWordCallback = std::function<void()>;
     using SpeechCallback = std::function<void(const std::string&)>;
     using TTSCallback = std::function<void(const std::string&)>;
+    // A command keyword (any but the first) with its index and name
+    using KeywordCallback = std::function<void(int, const std::string&)>;
+    // Per-channel planes of each captured block, before the downmix reaches the bus
+    using ChannelCallback = std::function<void(const ChannelMixer&, const AudioTimestamp&)>;
+    // Each conditioned 16 kHz block, as captured: echo is cancelled after it
+    using FrontEndCallback = std::function<void(const AudioFrontEnd&)>;
 
     AudioPipeline();
     ~AudioPipeline();
 
     bool initialize(int sampleRate, int channels, int frameSize);
+
+    /**
+     * @brief Read pipeline settings (history length, pre-roll, downmix, echo
+     *        cancellation, wake gate, barge-in, spectral features, VAD,
+     *        endpointing) from config
+     *
+     * Must be called before initialize() for the history length to apply.
+     */
+    void configure(ConfigManager& config);
+
+    /**
+     * @brief Feed the pipeline from a source instead of the input device
+     *
+     * Must be called before initialize(). With FreeRun pacing capture only
+     * runs ahead of the active consumer by a bounded amount, so a corpus
+     * is processed as fast as the pipeline can keep up.
+     */
+    void setAudioSource(std::unique_ptr<AudioSource> source,
+                        SourcePacing pacing = SourcePacing::RealTime);
     void start();
     void stop();
     void setWakeWordCallback(WakeWordCallback callback);
     void setSpeechCallback(SpeechCallback callback);
+
+    /**
+     * @brief Receive each response as it goes to the player
+     *
+     * The pipeline renders and plays the response itself, through the
+     * player the echo canceller takes its reference from; the callback is
+     * for display or logging and must not speak the text.
+     */
     void setTTSCallback(TTSCallback callback);
 
+    /**
+     * @brief Receive command keywords such as "stop" or "cancel"
+     *
+     * The first keyword wakes the pipeline; every other one cuts off a
+     * playing response and is reported here, without a turn for STT and NLU.
+     * @param callback Called on the wake word thread
+     */
+    void setKeywordCallback(KeywordCallback callback);
+
     PipelineState getState() const;
     void setState(PipelineState state);
 
-    // Configuration
+    /**
+     * @brief Player sharing the capture's full-duplex stream
+     *
+     * Responses queued here play on the same clock as capture; the first
+     * sample of each is reported to reportPlaybackStarted().
+     */
+    AudioPlayer* getAudioPlayer() const;
+
+    // Sensitivity of the wake word (the first keyword), over the configured one; takes effect on the next initialize()
     void setWakeWordSensitivity(float sensitivity);
+
+    /**
+     * @brief Keywords to listen for, the wake word first
+     * @param keywords Each with its own sensitivity; takes effect on the next initialize()
+     */
+    void setKeywords(const std::vector<WakeWordDetector::Keyword>& keywords);
+
+    /**
+     * @brief Only run the wake word engine on acoustic activity
+     * @param enabled With the gate off every frame goes to the engine
+     * @param params Levels, hold and lookback; takes effect on the next initialize()
+     */
+    void setWakeWordGate(bool enabled, const ActivityGate::Params& params = ActivityGate::Params());
+
+    /**
+     * @brief Cancel the echo of the player's output before any consumer hears it
+     * @param enabled Off, the bus carries the microphone as captured
+     * @param params Filter length, delay and step; takes effect on the next initialize()
+     */
+    void setEchoCancellation(bool enabled, const EchoCanceller::Params& params = EchoCanceller::Params());
+
+    /**
+     * @brief Keep listening for the wake word while a response plays
+     *
+     * A detection then cuts the response off and starts a new turn. Only
+     * useful with echo cancellation, or the response can wake itself.
+     */
+    void setBargeIn(bool enabled);
+    // Pause after which a turn ends even while the transcript is still changing
     void setSilenceTimeout(int ms);
+    // Audio after speech starts at which a turn ends regardless
     void setMaxUtteranceDuration(int ms);
 
+    /**
+     * @brief Set the endpointing limits together
+     */
+    void setEndpointing(const Endpointer::Params& params);
+
+    /**
+     * @brief Audio before the end of the wake word that is replayed to STT
+     * @param ms Pre-roll in milliseconds; 0 starts exactly at the keyword end
+     */
+    void setPreRoll(int ms);
+
+    /**
+     * @brief Gain of each capture channel in the mono mix fed to consumers
+     * @param weights One weight per channel; equal weights by default
+     * @return false if the count does not match the capture channels
+     */
+    bool setDownmixWeights(const std::vector<float>& weights);
+
+    /**
+     * @brief Receive every captured block as per-channel views
+     * @param callback Called on the capture thread; the views are valid only during the call
+     */
+    void setChannelCallback(ChannelCallback callback);
+
+    /**
+     * @brief Receive every front-end block, as PCM and as float
+     * @param callback Called on the capture thread; the views are valid only during the call
+     */
+    void setFrontEndCallback(FrontEndCallback callback);
+
+    /**
+     * @brief Capture history kept on the audio bus for lookback
+     * @param seconds History length; takes effect on the next initialize()
+     */
+    void setHistoryLength(int seconds);
+
+    /**
+     * @brief Report when the first sample of a response reached the output
+     * @param firstSampleTime Steady-clock time the sample was played
+     */
+    void reportPlaybackStarted(AudioTimestamp::Clock::time_point firstSampleTime);
+
+    /**
+     * @brief Report the recognizer's partial hypothesis for the current turn
+     *
+     * Once it stops changing, a short pause ends the turn instead of the
+     * full silence timeout. The pipeline's own recognizer reports here as
+     * it decodes; call it only when recognizing elsewhere.
+     */
+    void reportPartialResult(const std::string& text);
+
     // Debug and metrics
+    // Latencies are measured from capture timestamps, so they include
+    // buffering as well as compute
     struct Metrics {
-        double wakeToStartMs = 0.0;
-        double speechDurationMs = 0.0;
-        double sttLatencyMs = 0.0;
-        double nluLatencyMs = 0.0;
-        double ttsLatencyMs = 0.0;
+        double wakeToStartMs = 0.0;     // keyword end captured -> STT reads its first frame
+        double speechDurationMs = 0.0;  // utterance length in audio time
+        double endpointMs = 0.0;        // end of speech -> end of turn decided, in audio time
+        double sttLatencyMs = 0.0;      // end of speech captured -> final transcript
+        double nluLatencyMs = 0.0;      // final transcript -> response ready
+        double ttsLatencyMs = 0.0;      // response ready -> first TTS sample played
         int falseWakes = 0;
+
+        // Wake detection split into waiting for audio and processing it
+        double wakeBufferingMs = 0.0;   // keyword end captured -> detector has the frame
+        double wakeComputeMs = 0.0;     // detector has the frame -> detection
+
+        // Share of wake word frames the activity gate let through to the engine
+        double wakeGateDutyCycle = 1.0;
+        uint64_t wakeGateOpenings = 0;
+
+        // Echo removed from the microphone while the player plays
+        double echoErleDb = 0.0;
+        // Responses cut off by the wake word
+        int bargeIns = 0;
+
+        // Last interaction on the capture timeline
+        AudioTimestamp keywordEnd;
+        AudioTimestamp speechStart;
+        AudioTimestamp speechEnd;
+
+        // Per-consumer lag and overrun on the shared audio bus
+        std::vector<AudioBroadcastBuffer::ReaderStats> consumers;
+
+        // Capture queue between the device and the bus
+        AudioRingBuffer::Stats captureBuffer;
     };
 
     Metrics getMetrics() const;
 
+    /**
+     * @brief STFT and log-mel frames of the bus audio, on bus positions
+     *
+     * Published by the capture thread before the matching audio reaches the
+     * bus, so a consumer that has read up to a position finds its frames.
+     */
+    const SpectralFeatures* getSpectralFeatures() const { return spectralFeatures_.get(); }
+
 private:
-    void audioCaptureLoop();
+    void onCapturedAudio(const std::vector<int16_t>& block, const AudioTimestamp& stamp);
     void wakeWordLoop();
     void speechRecognitionLoop();
     void ttsLoop();
 
-    void handleWakeWord();
-    void handleSpeechEnd();
+    // Block until the pipeline enters state (or either state); false once stopped
+    bool waitForState(PipelineState state);
+    bool waitForState(PipelineState state, PipelineState other);
+
+    // Move from one state to another unless something else moved it first
+    bool setStateIf(PipelineState expected, PipelineState state);
+
+    // Read what the player played alongside a captured block, at the capture rate
+    void readPlaybackReference(const AudioTimestamp& stamp, size_t frames);
+
+    void handleWakeWord(uint64_t keywordEndPosition, AudioTimestamp::Clock::time_point frameReadAt);
+    void handleKeyword(int keyword);
+    void handleSpeechEnd(const AudioTimestamp& speechEnd);
+
+    // Recognize one STT read and pass the hypothesis so far to the endpointer
+    void feedRecognizer(const std::vector<int16_t>& frame);
     void handleTTSComplete();
 
     // Core components
+    std::unique_ptr<AudioPlayer> audioPlayer_;     // outlives the capture stream that drives it
     std::unique_ptr<AudioCapture> audioCapture_;
     std::unique_ptr<WakeWordDetector> wakeWordDetector_;
     std::unique_ptr<SpeechRecognizer> speechRecognizer_;
     std::unique_ptr<TextToSpeech> textToSpeech_;
 
-    // Audio buffers
-    std::unique_ptr<AudioRingBuffer> rawAudioBuffer_;
-    std::unique_ptr<AudioRingBuffer> wakeWordBuffer_;
-    std::unique_ptr<AudioRingBuffer> sttBuffer_;
-    std::unique_ptr<AudioResampler> wakeWordResampler_;
-    std::unique_ptr<AudioResampler> sttResampler_;
+    // Capture channels are split and mixed to mono before the bus
+    std::unique_ptr<ChannelMixer> channelMixer_;
+    std::vector<float> downmixWeights_;
+    ChannelCallback channelCallback_;
+
+    // The mix is resampled and conditioned once, on the capture thread, for all consumers
+    std::unique_ptr<AudioFrontEnd> frontEnd_;
+    FrontEndCallback frontEndCallback_;
+
+    // Echo of the player's output removed after the front end; the reference
+    // is the player's history, read on the capture timeline and conditioned
+    // like the microphone
+    std::unique_ptr<EchoCanceller> echoCanceller_;
+    EchoCanceller::Params echoParams_;
+    bool echoCancellationEnabled_ = true;
+    std::unique_ptr<AudioFrontEnd> referenceFrontEnd_;
+    AudioBroadcastBuffer* playbackHistory_ = nullptr;
+    AudioBroadcastBuffer::ReaderId referenceReader_ = AudioBroadcastBuffer::kInvalidReader;
+    uint64_t referenceOrigin_ = 0;      // history position of capture frame 0
+    std::vector<int16_t> referenceBlock_;
+
+    // Audio bus: front-end output written once by capture, read by each consumer's cursor
+    std::unique_ptr<AudioBroadcastBuffer> audioBus_;
+    AudioBroadcastBuffer::ReaderId wakeWordReader_ = AudioBroadcastBuffer::kInvalidReader;
+    AudioBroadcastBuffer::ReaderId sttReader_ = AudioBroadcastBuffer::kInvalidReader;
+
+    // Spectra computed once per hop alongside the bus, for every spectral consumer
+    std::unique_ptr<SpectralFeatures> spectralFeatures_;
+    SpectralFeatures::Params featureParams_;
+
+    // Keeps the wake word engine idle in silence; the bus history is its lookback
+    std::unique_ptr<ActivityGate> wakeGate_;
+    ActivityGate::Params wakeGateParams_;
+    bool wakeGateEnabled_ = true;
     std::unique_ptr<VoiceActivityDetector> vad_;
+    VoiceActivityDetector::Params vadParams_;
+
+    // Ends each turn from the VAD and the recognizer's partials; positions
+    // are relative to where STT started reading the bus
+    Endpointer endpointer_{AudioFrontEnd::kProcessingRate};
+    std::mutex endpointerMutex_;
+    uint64_t utteranceStartPosition_ = 0;
+
+    // Pending source for the next initialize()
+    std::unique_ptr<AudioSource> audioSource_;
+    SourcePacing sourcePacing_ = SourcePacing::RealTime;
 
     // Threading
-    std::thread audioThread_;
     std::thread wakeWordThread_;
     std::thread sttThread_;
     std::thread ttsThread_;
@@ -152,25 +328,32 @@ private:
     std::atomic<PipelineState> state_{PipelineState::IDLE};
     std::mutex stateMutex_;
     std::condition_variable stateCV_;
+    std::string pendingResponse_;   // rendered by the TTS thread once SPEAKING begins; under stateMutex_
 
     // Callbacks
     WakeWordCallback wakeWordCallback_;
     SpeechCallback speechCallback_;
     TTSCallback ttsCallback_;
+    KeywordCallback keywordCallback_;
 
     // Configuration
     int sampleRate_;
     int channels_;
     int frameSize_;
-    float wakeWordSensitivity_;
-    int silenceTimeoutMs_;
-    int maxUtteranceDurationMs_;
+    WakeWordDetector::Settings wakeSettings_;
+    float wakeWordSensitivity_ = -1.0f;     // negative until setWakeWordSensitivity()
+    bool wakeWordReady_ = false;
+    std::string sttModelPath_ = "models/vosk-model-en-us-0.22";
+    bool sttReady_ = false;
+    std::string transcript_;    // segments the recognizer closed this turn; STT thread only
+    int preRollMs_ = 200;
+    int historySeconds_ = 30;
+    bool bargeInEnabled_ = true;
 
     // Metrics
     mutable std::mutex metricsMutex_;
     Metrics metrics_;
-    std::chrono::steady_clock::time_point wakeStartTime_;
-    std::chrono::steady_clock::time_point speechStartTime_;
+    AudioTimestamp::Clock::time_point responseReadyTime_;
 };
 
 } // namespace jarvis
\ No newline at end of file
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "audio/audio_timestamp.h"
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace jarvis {
+
+class AudioBroadcastBuffer;
+
+/**
+ * @brief Playback progress reported by AudioPlayer
+ *
+ * outputFrame is on the player's output timeline (frames rendered since
+ * start()); time is when that frame reaches the DAC.
+ */
+struct PlaybackEvent {
+    enum class Type {
+        Started,    // first frame of a chunk
+        Progress,   // once per device buffer while a chunk plays
+        Finished,   // chunk played to its end
+        Stopped     // chunk cut off (or never started) by stopAt()
+    };
+
+    Type type = Type::Progress;
+    uint64_t chunkId = 0;
+    uint64_t chunkFrame = 0;
+    uint64_t outputFrame = 0;
+    AudioTimestamp::Clock::time_point time{};
+};
+
+/**
+ * @brief PCM playback engine using PortAudio
+ *
+ * Chunks of interleaved 16-bit PCM are handed to the device thread
+ * through a lock-free queue; the device thread never allocates, frees or
+ * locks. Each chunk can start at an exact output frame, and playback can
+ * be cut off at an exact frame with stopAt(). Progress is reported from a
+ * separate notifier thread so callbacks may block.
+ *
+ * A player attached to an AudioCapture (AudioCapture::attachPlayer) is
+ * driven by the capture's full-duplex stream: one device, one clock, and
+ * output frames that line up with captured frames. Otherwise start()
+ * opens an output-only stream.
+ */
+class AudioPlayer {
+public:
+    using PositionCallback = std::function<void(const PlaybackEvent&)>;
+
+    // Start a chunk right after everything already queued
+    static constexpr uint64_t kAfterQueued = std::numeric_limits<uint64_t>::max();
+
+    AudioPlayer();
+    ~AudioPlayer();
+
+    /**
+     * @brief Initialize playback
+     * @param sampleRate Sample rate in Hz (default: 16000)
+     * @param channels Number of output channels (default: 1)
+     * @param framesPerBuffer Buffer size for a standalone stream (default: 256)
+     * @param maxChunks Chunks that may be queued at once (default: 64)
+     * @return true if initialization successful, false otherwise
+     */
+    bool initialize(int sampleRate = 16000,
+                    int channels = 1,
+                    int framesPerBuffer = 256,
+                    size_t maxChunks = 64);
+
+    /**
+     * @brief Start playback (opens an output stream unless attached to a capture)
+     * @return true if started, false otherwise
+     */
+    bool start();
+
+    /**
+     * @brief Stop playback and discard queued chunks
+     */
+    void stop();
+
+    /**
+     * @brief Queue a chunk of interleaved PCM
+     * @param samples PCM in the player's format
+     * @param startFrame Output frame to start at, or kAfterQueued
+     * @return Chunk id, or 0 if the queue is full
+     */
+    uint64_t enqueue(std::vector<int16_t> samples, uint64_t startFrame = kAfterQueued);
+
+    /**
+     * @brief Silence output from an exact frame and drop everything queued
+     * @param outputFrame Frame at which to stop; 0 (or any past frame) stops at the next buffer
+     */
+    void stopAt(uint64_t outputFrame = 0);
+
+    /**
+     * @brief Set the function called with playback progress
+     * @param callback Called on the notifier thread, never the device thread
+     */
+    void setPositionCallback(PositionCallback callback);
+
+    /**
+     * @brief Publish every rendered buffer, silence included, to a history bus
+     *
+     * The bus advances by every frame the stream plays, so an attached
+     * player's history moves in step with the capture: the reference an
+     * echo canceller needs. Written from the device thread, so readers must
+     * not wait on it. Call after initialize(), before start().
+     * @param frames History length in frames
+     * @return The history bus, owned by the player
+     */
+    AudioBroadcastBuffer* enableOutputHistory(size_t frames);
+
+    /**
+     * @brief Frames rendered so far on the output timeline
+     */
+    uint64_t getOutputPosition() const;
+
+    /**
+     * @brief Check if a chunk is playing or queued
+     */
+    bool isPlaying() const;
+
+    bool isRunning() const;
+    int getSampleRate() const;
+    int getChannels() const;
+
+private:
+    friend class AudioCapture;
+
+    /**
+     * @brief Device thread: fill one output buffer
+     * @param dacTime When the first frame of output reaches the DAC
+     */
+    void render(int16_t* output, unsigned long frames,
+                AudioTimestamp::Clock::time_point dacTime) noexcept;
+
+    // Set by AudioCapture; an attached player opens no stream of its own
+    void setAttached(bool attached);
+
+    class AudioPlayerImpl;
+    std::unique_ptr<AudioPlayerImpl> impl_;
+};
+
+} // namespace jarvis
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace jarvis {
+
+/**
+ * @brief Streaming polyphase windowed-sinc sample rate converter
+ *
+ * Converts by the reduced rational ratio outputRate/inputRate (48k->16k is
+ * 1/3, 44.1k->16k is 160/441). Each output sample is one dot product of
+ * 16-bit input history with one phase of a Kaiser-windowed sinc lowpass
+ * stored as 16-bit fixed-point coefficients, run with SIMD
+ * multiply-accumulate.
+ *
+ * History and phase carry over between resample() calls, so any split of
+ * a stream into blocks gives the same output as a single call. Filter
+ * banks are built once per (rates, quality) and shared by every
+ * resampler in the process. Pure 2:1 and 3:1 decimation (32k and 48k to
+ * 16k) runs kernels specialized at compile time for the factor and filter
+ * length; other ratios get the filter length fixed at compile time when it
+ * is one the quality levels commonly produce.
+ */
+class AudioResampler {
+public:
+    enum class Quality {
+        Fast,       // shortest filter; passband to ~80% of Nyquist
+        Balanced,   // default; ~70 dB stopband
+        High        // longest filter; passband to ~92% of Nyquist
+    };
+
+    AudioResampler(int inputRate, int outputRate, int channels = 1,
+                   Quality quality = Quality::Balanced);
+    ~AudioResampler();
+
+    /**
+     * @brief Convert the next block of the stream into a caller-owned buffer
+     * @param input Interleaved frames at the input rate
+     * @param output Room for at least maxOutputFrames(frames) interleaved frames
+     * @return Frames written; the count varies by a frame between calls. 0 and
+     *         nothing consumed if output is too small
+     *
+     * Does not allocate once the history has grown to the block size. With
+     * equal rates this is a copy, or nothing at all when output is input.
+     */
+    size_t resample(std::span<const int16_t> input, std::span<int16_t> output);
+
+    /**
+     * @brief Convert the next block of the stream
+     * @param input Interleaved frames at the input rate
+     * @param inputFrames Number of frames
+     * @return Interleaved frames at the output rate
+     */
+    std::vector<int16_t> resample(const int16_t* input, size_t inputFrames);
+
+    /**
+     * @brief Drop history and restart at phase zero
+     */
+    void reset();
+
+    /**
+     * @brief Upper bound on the frames one call can return
+     */
+    size_t maxOutputFrames(size_t inputFrames) const;
+
+    /**
+     * @brief Filter delay in input frames
+     */
+    double getLatencyFrames() const;
+
+    /**
+     * @brief True when the rates match and output is the input unchanged;
+     *        callers can then skip the resampler and use their input
+     */
+    bool isPassthrough() const { return !bank_; }
+
+    int getInputRate() const { return inputRate_; }
+    int getOutputRate() const { return outputRate_; }
+    int getChannels() const { return channels_; }
+    Quality getQuality() const { return quality_; }
+
+    /**
+     * @brief Taps per output sample for a conversion at a quality level
+     */
+    static int filterLength(int inputRate, int outputRate, Quality quality);
+
+private:
+    struct FilterBank;
+
+    static std::shared_ptr<const FilterBank> getFilterBank(int inputRate, int outputRate, Quality quality);
+
+    int inputRate_;
+    int outputRate_;
+    int channels_;
+    Quality quality_;
+    std::shared_ptr<const FilterBank> bank_;
+
+    // Per-channel input history; the last taps-1 frames of one call are the head of the next
+    std::vector<std::vector<int16_t>> history_;
+    size_t kept_ = 0;    // frames of history carried into the next call
+    size_t next_ = 0;    // history index of the newest frame under the next output's window
+    int phase_ = 0;      // filter phase of the next output
+};
+
+} // namespace jarvis
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace jarvis {
+
+// Keeps producer and consumer indices on separate cache lines
+inline constexpr size_t kCacheLineSize = 64;
+
+/**
+ * @brief Wakes consumers blocked on a buffer's fill level
+ *
+ * A waiter registers the write position it needs; the producer only takes
+ * the mutex and signals once that position has been published, so a
+ * consumer waiting for a full frame is woken once per frame rather than
+ * once per write. With no waiters, notify() costs a fence and two loads.
+ */
+class FillLevelSignal {
+public:
+    /**
+     * @brief Block until ready() holds, the timeout expires or interrupt() is called
+     * @param target Write position at which ready() is expected to hold
+     * @return Value of ready() on return
+     */
+    template <typename Ready>
+    bool wait(uint64_t target, Ready ready, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        uint64_t generation = interrupts_;
+        cv_.wait_for(lock, timeout, [&]() {
+            if (interrupts_ != generation) return true;
+            lowerTarget(target);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return ready();
+        });
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+        return ready();
+    }
+
+    /**
+     * @brief Producer side: call after publishing data up to position
+     */
+    void notify(uint64_t position) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) == 0 ||
+            position < target_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            target_.store(kNoTarget, std::memory_order_relaxed);
+        }
+        cv_.notify_all();
+    }
+
+    /**
+     * @brief Wake every waiter regardless of fill level (state change, shutdown)
+     */
+    void interrupt() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++interrupts_;
+        }
+        cv_.notify_all();
+    }
+
+private:
+    static constexpr uint64_t kNoTarget = std::numeric_limits<uint64_t>::max();
+
+    void lowerTarget(uint64_t target) {
+        if (target < target_.load(std::memory_order_relaxed)) {
+            target_.store(target, std::memory_order_seq_cst);
+        }
+    }
+
+    std::atomic<int> waiters_{0};
+    std::atomic<uint64_t> target_{kNoTarget};
+    uint64_t interrupts_ = 0;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+/**
+ * @brief What AudioRingBuffer::write() does when the samples do not fit
+ */
+enum class OverflowPolicy {
+    // Reject the write; the buffered audio is kept (never blocks, RT-safe)
+    DropNewest,
+    // Advance the read side to make room; the freshest audio is kept (never blocks)
+    DropOldest,
+    // Wait for the consumer up to a timeout, then drop the write
+    Block
+};
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring buffer for audio
+ *
+ * Capacity is rounded up to a power of two so indices wrap with a mask.
+ * Indices grow monotonically; the occupied range is [head, tail). Bulk
+ * read/write copy with at most two memcpy calls (split at the wrap point).
+ *
+ * The acquire/commit API hands out contiguous regions of the underlying
+ * storage so the producer can fill and the consumer can process samples
+ * in place. A region never spans the wrap point, so it may be shorter
+ * than requested; call again after committing to get the remainder.
+ *
+ * Overflow is never silent: every dropped sample, the high-water mark and
+ * the time the producer spent blocked are counted and reported by
+ * getStats(). Under DropOldest the producer may move the read index, so
+ * the consumer commits with a compare-and-swap and retries (read()) or
+ * reports the loss (commitRead()) if its region was discarded.
+ */
+class AudioRingBuffer {
+public:
+    struct Stats {
+        uint64_t droppedSamples = 0;
+        uint64_t overflows = 0;              // writes that did not fit
+        size_t highWaterMark = 0;            // highest fill level seen, in samples
+        std::chrono::nanoseconds stallTime{0}; // time write() spent blocked
+    };
+
+    /**
+     * @param capacity Size in samples (rounded up to a power of two)
+     * @param policy Overflow policy; set before the buffer is in use
+     * @param blockTimeout Longest a Block-policy write() waits for space
+     */
+    explicit AudioRingBuffer(size_t capacity,
+                             OverflowPolicy policy = OverflowPolicy::DropNewest,
+                             std::chrono::milliseconds blockTimeout = std::chrono::milliseconds(100));
+    ~AudioRingBuffer();
+
+    AudioRingBuffer(const AudioRingBuffer&) = delete;
+    AudioRingBuffer& operator=(const AudioRingBuffer&) = delete;
+
+    /**
+     * @brief Write all samples, applying the overflow policy if they don't fit
+     * @return false if the samples were dropped (DropNewest, or Block timed out);
+     *         DropOldest always writes and returns true
+     */
+    bool write(const int16_t* data, size_t count);
+
+    /**
+     * @brief Read up to count samples
+     * @return Number of samples read
+     */
+    size_t read(int16_t* buffer, size_t count);
+
+    /**
+     * @brief Producer side: contiguous writable region of up to count samples
+     */
+    std::span<int16_t> acquireWrite(size_t count);
+
+    /**
+     * @brief Producer side: publish count samples of the acquired region
+     */
+    void commitWrite(size_t count);
+
+    /**
+     * @brief Consumer side: contiguous readable region of up to count samples
+     */
+    std::span<const int16_t> acquireRead(size_t count);
+
+    /**
+     * @brief Consumer side: release count samples of the acquired region
+     * @return false if the producer discarded the region meanwhile (DropOldest)
+     */
+    bool commitRead(size_t count);
+
+    /**
+     * @brief Consumer side: block until count samples are available
+     * @return true if they are; false on timeout or interrupt()
+     */
+    bool waitForAvailable(size_t count, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Wake a consumer blocked in waitForAvailable() and a blocked write()
+     */
+    void interrupt() {
+        dataSignal_.interrupt();
+        spaceSignal_.interrupt();
+    }
+
+    size_t available() const;
+    size_t freeSpace() const;
+    size_t capacity() const { return capacity_; }
+    OverflowPolicy overflowPolicy() const { return policy_; }
+
+    Stats getStats() const;
+
+    /**
+     * @brief Drop all buffered samples (consumer side)
+     */
+    void clear();
+
+private:
+    // Producer side: make room for count samples per the policy
+    bool makeRoom(size_t tail, size_t count);
+    bool hasRoom(size_t tail, size_t count);
+    void recordOverflow(size_t dropped);
+    void updateHighWater(size_t tail);
+    // Consumer side: move head forward, failing if the producer already has
+    bool advanceHead(size_t head, size_t count);
+
+    const size_t capacity_;
+    const size_t mask_;
+    const OverflowPolicy policy_;
+    const std::chrono::milliseconds blockTimeout_;
+    std::vector<int16_t> buffer_;
+
+    // Consumer-owned line: read index plus the consumer's view of tail
+    alignas(kCacheLineSize) std::atomic<size_t> head_{0};
+    size_t cachedTail_ = 0;
+    size_t acquiredHead_ = 0;
+
+    // Producer-owned line: write index plus the producer's view of head
+    alignas(kCacheLineSize) std::atomic<size_t> tail_{0};
+    size_t cachedHead_ = 0;
+
+    // Written by the producer only, read by anyone
+    std::atomic<uint64_t> droppedSamples_{0};
+    std::atomic<uint64_t> overflows_{0};
+    std::atomic<size_t> highWaterMark_{0};
+    std::atomic<int64_t> stallNanos_{0};
+
+    FillLevelSignal dataSignal_;
+    FillLevelSignal spaceSignal_;
+};
+
+} // namespace jarvis
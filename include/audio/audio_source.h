@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace jarvis {
+
+/**
+ * @brief How a non-device source is clocked by AudioCapture
+ */
+enum class SourcePacing {
+    // One block per block duration, like a sound card
+    RealTime,
+    // Next block as soon as the consumer callback returns
+    FreeRun
+};
+
+/**
+ * @brief Producer of interleaved 16-bit PCM that can stand in for a device
+ *
+ * Sources let AudioCapture (and everything behind it) run on machines
+ * without a sound card, and faster than real time for benchmarks.
+ */
+class AudioSource {
+public:
+    virtual ~AudioSource() = default;
+
+    virtual int getSampleRate() const = 0;
+    virtual int getChannels() const = 0;
+
+    /**
+     * @brief Fill buffer with up to frames frames of interleaved audio
+     * @return Frames written; 0 once the source is exhausted
+     */
+    virtual size_t read(int16_t* buffer, size_t frames) = 0;
+
+    /**
+     * @brief Restart from the beginning
+     * @return false if the source cannot be rewound
+     */
+    virtual bool rewind() { return false; }
+};
+
+/**
+ * @brief WAV (PCM16) or headerless raw PCM16 file
+ */
+class FileAudioSource : public AudioSource {
+public:
+    FileAudioSource();
+    ~FileAudioSource() override;
+
+    /**
+     * @brief Open a file; WAV is detected from its RIFF header
+     * @param path File path
+     * @param rawSampleRate Sample rate to assume for raw PCM
+     * @param rawChannels Channel count to assume for raw PCM
+     * @return true if the file is readable PCM16
+     */
+    bool open(const std::string& path, int rawSampleRate = 16000, int rawChannels = 1);
+    void close();
+
+    int getSampleRate() const override { return sampleRate_; }
+    int getChannels() const override { return channels_; }
+    size_t read(int16_t* buffer, size_t frames) override;
+    bool rewind() override;
+
+    /**
+     * @brief Write interleaved PCM16 as a WAV file
+     * @return true if written successfully
+     */
+    static bool writeWav(const std::string& path, const int16_t* samples, size_t frames,
+                         int sampleRate, int channels);
+
+private:
+    FILE* file_ = nullptr;
+    int sampleRate_ = 16000;
+    int channels_ = 1;
+    long dataOffset_ = 0;
+    size_t dataFrames_ = 0;
+    size_t position_ = 0;
+};
+
+/**
+ * @brief Sine tone generator
+ */
+class ToneSource : public AudioSource {
+public:
+    /**
+     * @param frequencyHz Tone frequency
+     * @param amplitude Peak amplitude [0.0, 1.0]
+     * @param durationMs Length of the tone; 0 for endless
+     */
+    ToneSource(int sampleRate, int channels, double frequencyHz,
+               double amplitude = 0.5, int durationMs = 0);
+
+    int getSampleRate() const override { return sampleRate_; }
+    int getChannels() const override { return channels_; }
+    size_t read(int16_t* buffer, size_t frames) override;
+    bool rewind() override;
+
+private:
+    int sampleRate_;
+    int channels_;
+    double phaseStep_;
+    double amplitude_;
+    size_t totalFrames_;
+    size_t position_ = 0;
+    double phase_ = 0.0;
+};
+
+/**
+ * @brief Gaussian white noise generator
+ */
+class NoiseSource : public AudioSource {
+public:
+    /**
+     * @param amplitude Standard deviation relative to full scale
+     * @param durationMs Length of the noise; 0 for endless
+     * @param seed Random seed, so runs are reproducible
+     */
+    NoiseSource(int sampleRate, int channels, double amplitude = 0.1,
+                int durationMs = 0, uint32_t seed = 1);
+
+    int getSampleRate() const override { return sampleRate_; }
+    int getChannels() const override { return channels_; }
+    size_t read(int16_t* buffer, size_t frames) override;
+    bool rewind() override;
+
+private:
+    int sampleRate_;
+    int channels_;
+    double amplitude_;
+    size_t totalFrames_;
+    size_t position_ = 0;
+    uint32_t seed_;
+    std::mt19937 rng_;
+    std::normal_distribution<double> distribution_{0.0, 1.0};
+};
+
+/**
+ * @brief Plays a list of sources back to back, optionally looping
+ *
+ * All sources must share one sample rate and channel count.
+ */
+class LoopingSource : public AudioSource {
+public:
+    /**
+     * @param sources Corpus to play in order
+     * @param loops Number of passes over the corpus; 0 for endless
+     */
+    explicit LoopingSource(std::vector<std::unique_ptr<AudioSource>> sources, int loops = 0);
+
+    int getSampleRate() const override;
+    int getChannels() const override;
+    size_t read(int16_t* buffer, size_t frames) override;
+    bool rewind() override;
+
+    int getCompletedLoops() const { return completedLoops_; }
+
+private:
+    std::vector<std::unique_ptr<AudioSource>> sources_;
+    int loops_;
+    int completedLoops_ = 0;
+    size_t current_ = 0;
+};
+
+} // namespace jarvis
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace jarvis {
+
+/**
+ * @brief Position of an audio frame on the capture timeline
+ *
+ * frameIndex counts frames since capture started, including frames that
+ * were later dropped, so two indices always differ by exactly the audio
+ * time between them. captureTime is when that frame reached the ADC
+ * (from PortAudio's timeInfo), on the steady clock that the rest of the
+ * pipeline timestamps its events with.
+ */
+struct AudioTimestamp {
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t frameIndex = 0;
+    Clock::time_point captureTime{};
+
+    bool valid() const { return captureTime != Clock::time_point{}; }
+
+    /**
+     * @brief Timestamp of the frame frames after this one
+     */
+    AudioTimestamp advancedBy(uint64_t frames, int sampleRate) const {
+        auto offset = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(frames) / sampleRate));
+        return {frameIndex + frames, captureTime + offset};
+    }
+};
+
+/**
+ * @brief Milliseconds from one pipeline event to a later one
+ */
+inline double elapsedMs(AudioTimestamp::Clock::time_point from, AudioTimestamp::Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace jarvis
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace jarvis {
+
+/**
+ * @brief Split interleaved PCM into one contiguous plane per channel
+ * @param interleaved frames * channels samples
+ * @param planes One destination of at least frames samples per channel
+ *
+ * Stereo and 4-channel input take a vectorized path.
+ */
+void deinterleave(const int16_t* interleaved, size_t frames, int channels, int16_t* const* planes);
+
+/**
+ * @brief Weighted sum of channel planes into one, saturating to 16 bits
+ * @param weights One gain per channel
+ */
+void downmix(const int16_t* const* planes, size_t frames, int channels,
+             const float* weights, int16_t* mono);
+
+/**
+ * @brief Multi-channel front end: per-channel planes plus a mono downmix
+ *
+ * Each process() call deinterleaves one captured block into planes owned
+ * by the mixer and mixes them down with per-channel weights (equal by
+ * default). Later stages read a channel or the mix through spans into
+ * those planes, valid until the next process() call; nothing is copied
+ * out. Mono input at unit weight passes straight through, and the views
+ * then point into the input block.
+ */
+class ChannelMixer {
+public:
+    /**
+     * @param channels Channels in the interleaved input
+     * @param maxFrames Block size to preallocate for; larger blocks grow the planes
+     */
+    ChannelMixer(int channels, size_t maxFrames = 0);
+
+    /**
+     * @brief Set the downmix gain of each channel
+     * @return false (and weights unchanged) unless there is one weight per channel
+     */
+    bool setWeights(const std::vector<float>& weights);
+    const std::vector<float>& getWeights() const { return weights_; }
+
+    /**
+     * @brief Deinterleave and downmix one block
+     * @return Frames in the block
+     */
+    size_t process(const int16_t* interleaved, size_t frames);
+
+    // Views of the last processed block
+    std::span<const int16_t> channel(int index) const;
+    std::span<const int16_t> mono() const;
+
+    int getChannels() const { return channels_; }
+
+private:
+    void reserve(size_t frames);
+
+    int channels_;
+    size_t frames_ = 0;
+    size_t capacity_ = 0;
+    std::vector<float> weights_;
+    std::vector<std::vector<int16_t>> planes_;
+    std::vector<int16_t*> planePointers_;
+    std::vector<int16_t> mono_;
+    const int16_t* passthrough_ = nullptr;
+};
+
+} // namespace jarvis
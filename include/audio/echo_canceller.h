@@ -0,0 +1,152 @@
+#pragma once
+
+#include "dsp/fft.h"
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace jarvis {
+
+/**
+ * @brief Streaming acoustic echo canceller
+ *
+ * Subtracts from the microphone signal its linear echo of a reference
+ * (what the speaker played). The echo path is modelled by a partitioned
+ * block frequency-domain adaptive filter: filterMs of taps split into
+ * block-length partitions, adapted per frequency bin with normalised LMS.
+ * Blocks are about 8 ms; output lags input by the part of a block still
+ * pending.
+ *
+ * Two filters run on the same reference: one adapts on every block, the
+ * other produces the output and only takes the adaptive one's weights once
+ * they leave a smaller residual. The user talking over playback pulls the
+ * adaptive filter off the echo path, but never the one that is heard; a
+ * filter that falls far behind is reset from the heard one. With a silent
+ * reference both are skipped and the microphone passes through.
+ *
+ * Only linear echo is removed; there is no residual echo suppressor.
+ */
+class EchoCanceller {
+public:
+    struct Params {
+        int filterMs = 256;                 // echo path modelled, device latency included
+        int delayMs = 0;                    // bulk delay applied to the reference first
+        float stepSize = 0.5f;              // normalised step, 0..1
+        float minReferenceRms = 1e-4f;      // a quieter reference is silence
+    };
+
+    // May be read from any thread
+    struct Stats {
+        double erleDb = 0.0;                // echo return loss enhancement while the reference plays
+        bool referenceActive = false;
+        bool doubleTalk = false;            // the adaptive filter is off the echo path
+        uint64_t blocks = 0;
+        uint64_t filteredBlocks = 0;        // blocks with an active reference
+        uint64_t adaptedBlocks = 0;
+        uint64_t foregroundUpdates = 0;     // adaptive weights taken over for the output
+        uint64_t restoredBlocks = 0;        // adaptive weights reset from the output filter
+    };
+
+    explicit EchoCanceller(int sampleRate);
+    EchoCanceller(int sampleRate, const Params& params);
+
+    EchoCanceller(const EchoCanceller&) = delete;
+    EchoCanceller& operator=(const EchoCanceller&) = delete;
+
+    /**
+     * @brief Cancel the echo of ref in mic
+     * @param mic Microphone samples in [-1, 1)
+     * @param ref Reference samples for the same positions, same length
+     * @return Output samples produced, whole blocks only
+     */
+    size_t process(std::span<const float> mic, std::span<const float> ref);
+
+    // Output of the last process() call, valid until the next one
+    std::span<const float> samples() const { return {samples_.data(), produced_}; }
+    std::span<const int16_t> pcm() const { return {pcm_.data(), produced_}; }
+
+    // Input samples waiting for a full block; the next output starts this far back
+    size_t pending() const { return pendingCount_; }
+
+    size_t blockSize() const { return blockSize_; }
+    size_t partitions() const { return partitions_; }
+    const Params& getParams() const { return params_; }
+
+    Stats getStats() const;
+
+    // Forget the echo path and all buffered audio; counters are kept
+    void reset();
+
+private:
+    void processBlock(float* out);
+    double cancel(const std::complex<float>* weights, float* out);
+    void adapt();
+    std::complex<float>* spectrum(size_t age) {
+        return spectra_.data() + (newest_ + partitions_ - age) % partitions_ * bins_;
+    }
+
+    int sampleRate_;
+    Params params_;
+    size_t blockSize_;
+    size_t bins_;
+    size_t partitions_;
+    dsp::RealFft fft_;
+
+    // Precomputed from params_
+    float minBlockEnergy_ = 0.0f;
+    float regularisation_ = 0.0f;
+
+    // Reference bulk delay
+    std::vector<float> delayLine_;
+    size_t delayPosition_ = 0;
+
+    // Block being assembled
+    std::vector<float> micBlock_;
+    std::vector<float> refBlock_;
+    size_t pendingCount_ = 0;
+
+    // Overlap-save input: previous and current reference block
+    std::vector<float> refWindow_;
+    float previousEnergy_ = 0.0f;
+
+    // Spectra of the last partitions_ reference windows, newest at newest_
+    std::vector<std::complex<float>> spectra_;
+    size_t newest_ = 0;
+    std::vector<float> blockEnergies_;
+    double referenceEnergy_ = 0.0;          // over the whole filter span
+
+    std::vector<std::complex<float>> weights_;     // adaptive, partitions_ x bins_
+    std::vector<std::complex<float>> foreground_;  // heard, partitions_ x bins_
+    std::vector<float> power_;                     // |X|^2 per bin summed over partitions
+    size_t constrainNext_ = 0;
+
+    std::vector<std::complex<float>> estimate_;
+    std::vector<std::complex<float>> error_;
+    std::vector<float> time_;
+    std::vector<float> residual_;
+
+    // Smoothed input and residual powers comparing the two filters, and for ERLE
+    double inputPower_ = 0.0;
+    double trainingPower_ = 0.0;
+    double outputPower_ = 0.0;
+    double micPower_ = 0.0;
+    double residualPower_ = 0.0;
+
+    std::vector<float> samples_;
+    std::vector<int16_t> pcm_;
+    size_t produced_ = 0;
+
+    std::atomic<double> erleDb_{0.0};
+    std::atomic<bool> referenceActive_{false};
+    std::atomic<bool> doubleTalk_{false};
+    std::atomic<uint64_t> blocks_{0};
+    std::atomic<uint64_t> filteredBlocks_{0};
+    std::atomic<uint64_t> adaptedBlocks_{0};
+    std::atomic<uint64_t> foregroundUpdates_{0};
+    std::atomic<uint64_t> restoredBlocks_{0};
+};
+
+} // namespace jarvis
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace jarvis {
+
+/**
+ * @brief Decides when a spoken turn has ended
+ *
+ * Combines the VAD's per-frame decision with the recognizer's partial
+ * hypotheses. A pause ends the turn early once the partial text has stopped
+ * changing, since the recognizer has nothing left to revise; without that
+ * agreement the turn ends after the longer maximum pause. All time is
+ * audio time, counted in samples, so decisions do not depend on how fast
+ * the audio is processed.
+ */
+class Endpointer {
+public:
+    struct Params {
+        int minPauseMs = 240;           // pause that ends the turn once the partial is stable
+        int maxPauseMs = 800;           // pause that ends the turn regardless
+        int partialStableMs = 200;      // partial unchanged this long counts as stable
+        int minUtteranceMs = 150;       // shorter bursts of speech are discarded as noise
+        int maxUtteranceMs = 10000;     // the turn ends after this much audio, speaking or not
+        int noSpeechTimeoutMs = 5000;   // give up if speech has not started by then
+    };
+
+    enum class Result {
+        Continue,
+        EndOfTurn,      // a pause after speech
+        MaxDuration,    // the utterance reached maxUtteranceMs
+        NoSpeech        // nothing was said
+    };
+
+    explicit Endpointer(int sampleRate);
+    Endpointer(int sampleRate, const Params& params);
+
+    void setParams(const Params& params);
+    const Params& getParams() const { return params_; }
+
+    /**
+     * @brief Start a new turn at sample 0
+     */
+    void reset();
+
+    /**
+     * @brief Advance by a span of audio the VAD has classified
+     * @param samples Samples covered by the decision
+     * @param speech VAD decision for those samples
+     * @return Continue until the turn ends; the result is then held until reset()
+     */
+    Result update(size_t samples, bool speech);
+
+    /**
+     * @brief The recognizer's current partial hypothesis
+     *
+     * Stability is timed from the last change of the text, at the current
+     * position.
+     */
+    void onPartialResult(const std::string& text);
+
+    bool speechStarted() const { return speechStarted_; }
+
+    // Positions in samples since reset()
+    uint64_t position() const { return position_; }
+    uint64_t speechStartSample() const { return speechStart_; }
+    uint64_t speechEndSample() const { return speechEnd_; }
+
+    static const char* resultName(Result result);
+
+private:
+    uint64_t toSamples(int ms) const;
+
+    int sampleRate_;
+    Params params_;
+
+    uint64_t position_ = 0;
+    uint64_t speechStart_ = 0;
+    uint64_t speechEnd_ = 0;
+    bool speechStarted_ = false;
+    bool inSpeech_ = false;
+    uint64_t runStart_ = 0;             // start of the current burst of speech
+
+    std::string partial_;
+    uint64_t partialChanged_ = 0;
+
+    Result result_ = Result::Continue;
+};
+
+} // namespace jarvis
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace jarvis {
+
+/**
+ * @brief Cut a stream of arbitrary blocks into fixed-length frames
+ *
+ * Engines such as Porcupine take exactly one frame per call, while
+ * capture delivers whatever block size the device uses. Each complete
+ * frame is handed out as a pointer: straight into the pushed block when
+ * the frame lies within it, or into the assembler's own frame buffer when
+ * it straddles two blocks. Only those straddling samples are copied, and
+ * nothing is allocated after construction.
+ *
+ * Per-instance and single-threaded: one producer calls push().
+ */
+class FrameAssembler {
+public:
+    // Receives one frame of frameLength() samples, valid only during the call
+    using FrameHandler = std::function<void(const int16_t* frame)>;
+
+    explicit FrameAssembler(size_t frameLength);
+
+    void setFrameHandler(FrameHandler handler);
+
+    /**
+     * @brief Append samples and hand out every frame they complete, in order
+     * @return Frames completed
+     */
+    size_t push(std::span<const int16_t> samples);
+
+    // Samples of the next frame held back until it completes
+    size_t pending() const { return pending_; }
+    size_t frameLength() const { return frame_.size(); }
+
+    // Frames handed out in place, and assembled from two blocks
+    uint64_t directFrames() const { return directFrames_; }
+    uint64_t assembledFrames() const { return assembledFrames_; }
+
+    // Drop the partial frame, e.g. when the stream restarts
+    void reset() { pending_ = 0; }
+
+private:
+    std::vector<int16_t> frame_;
+    size_t pending_ = 0;
+    FrameHandler handler_;
+    uint64_t directFrames_ = 0;
+    uint64_t assembledFrames_ = 0;
+};
+
+} // namespace jarvis
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "audio/audio_ring_buffer.h"
+#include "audio/audio_timestamp.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <semaphore>
+#include <vector>
+
+namespace jarvis {
+
+/**
+ * @brief Hand-off from the real-time audio callback to a delivery thread
+ *
+ * push() is the only method called from the device callback: it copies
+ * into a preallocated ring and posts a semaphore, with no heap allocation,
+ * no locks and no logging. Samples that do not fit are counted, not
+ * reported. A normal thread blocks in waitForData() and drains with pop().
+ *
+ * Each pushed block carries its capture time; the queue numbers frames
+ * itself (dropped ones included) and hands pop() the timestamp of the
+ * first sample it returns.
+ *
+ * Nobody may block on the inner ring's waitForAvailable(); that keeps its
+ * notify path to a fence and a load, so push() never takes a mutex.
+ */
+class RealTimeCaptureQueue {
+public:
+    explicit RealTimeCaptureQueue(size_t capacity, int channels = 1, int sampleRate = 16000);
+    ~RealTimeCaptureQueue();
+
+    RealTimeCaptureQueue(const RealTimeCaptureQueue&) = delete;
+    RealTimeCaptureQueue& operator=(const RealTimeCaptureQueue&) = delete;
+
+    /**
+     * @brief Real-time side: enqueue samples without blocking
+     * @param captureTime When the first sample reached the ADC
+     * @return false if the block was dropped because the queue is full
+     */
+    bool push(const int16_t* data, size_t count,
+              AudioTimestamp::Clock::time_point captureTime = {}) noexcept;
+
+    /**
+     * @brief Real-time side: count a device-reported overflow
+     */
+    void recordDeviceOverflow() noexcept {
+        deviceOverflows_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Delivery side: block until data has been pushed
+     * @return true if woken by push(); false on timeout or interrupt()
+     */
+    bool waitForData(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Delivery side: copy out up to count samples
+     * @param stamp If non-null, receives the timestamp of the first sample
+     */
+    size_t pop(int16_t* buffer, size_t count, AudioTimestamp* stamp = nullptr);
+
+    /**
+     * @brief Wake the delivery thread (e.g. on shutdown)
+     */
+    void interrupt();
+
+    size_t available() const { return ring_.available(); }
+
+    /**
+     * @brief Discard queued audio; only while nothing is pushing
+     */
+    void clear();
+
+    uint64_t droppedSamples() const { return droppedSamples_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Fill and drop counters; push() drops whole blocks, never blocks
+     */
+    AudioRingBuffer::Stats stats() const;
+    uint64_t deviceOverflows() const { return deviceOverflows_.load(std::memory_order_relaxed); }
+
+private:
+    struct BlockStamp {
+        AudioTimestamp stamp;
+        size_t samples = 0;
+    };
+
+    AudioRingBuffer ring_;
+    const int channels_;
+    const int sampleRate_;
+
+    // One entry per accepted push, published before its samples
+    std::vector<BlockStamp> stamps_;
+    const size_t stampMask_;
+    alignas(kCacheLineSize) std::atomic<size_t> stampTail_{0};
+    uint64_t nextFrame_ = 0;                        // real-time side only
+    alignas(kCacheLineSize) std::atomic<size_t> stampHead_{0};
+    size_t stampOffset_ = 0;                        // delivery side only
+
+    std::counting_semaphore<> dataReady_{0};
+    std::atomic<uint64_t> droppedSamples_{0};
+    std::atomic<uint64_t> droppedBlocks_{0};
+    std::atomic<uint64_t> deviceOverflows_{0};
+};
+
+} // namespace jarvis
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "dsp/fft.h"
+#include "dsp/mel_filterbank.h"
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace jarvis {
+
+/**
+ * @brief Streaming STFT and log-mel stage shared by every spectral consumer
+ *
+ * One writer feeds audio in blocks of any size; every hop a Hann-windowed
+ * frame is transformed once and its power spectrum and log-mel energies
+ * are published to a ring. Any number of readers then fetch frames by
+ * index without recomputing a transform. The FFT plan, window and mel
+ * filterbank are built once at construction.
+ *
+ * Frames are placed on the input's sample timeline: frame k covers the
+ * window ending at endPosition(k). Fed the same samples as the audio bus,
+ * frame positions are bus positions.
+ *
+ * Like the audio bus, the writer never waits: a reader that falls more than
+ * capacity() frames behind finds its frames overwritten and read() fails.
+ */
+class SpectralFeatures {
+public:
+    struct Params {
+        int windowMs = 25;
+        int hopMs = 10;
+        int mels = 40;
+        float minFrequency = 20.0f;
+        float maxFrequency = 7600.0f;
+        int historyMs = 5000;           // frames kept for readers that lag
+    };
+
+    struct Frame {
+        uint64_t index = 0;
+        uint64_t endPosition = 0;       // sample just past the frame's window
+        std::vector<float> power;       // numBins() values, |X|^2 of the windowed frame
+        std::vector<float> logMel;      // numMels() values, natural log
+    };
+
+    explicit SpectralFeatures(int sampleRate);
+    SpectralFeatures(int sampleRate, const Params& params);
+    ~SpectralFeatures();
+
+    SpectralFeatures(const SpectralFeatures&) = delete;
+    SpectralFeatures& operator=(const SpectralFeatures&) = delete;
+
+    /**
+     * @brief Append audio and publish every frame it completes (writer only)
+     * @return Frames published
+     */
+    size_t process(std::span<const float> samples);
+
+    /**
+     * @brief Drop buffered audio and restart the timeline at a position (writer only)
+     */
+    void reset(uint64_t position = 0);
+
+    // Frames published so far; the next frame's index
+    uint64_t framesWritten() const { return written_.load(std::memory_order_acquire); }
+
+    // Oldest frame index still in the ring
+    uint64_t oldestFrame() const;
+
+    /**
+     * @brief Copy out a published frame
+     * @return false if it is not published yet or was overwritten
+     */
+    bool read(uint64_t index, Frame& frame) const;
+
+    /**
+     * @brief Read only the power spectrum of a frame into numBins() values
+     */
+    bool readPower(uint64_t index, float* power) const;
+
+    /**
+     * @brief Read only the log-mel energies of a frame into numMels() values
+     */
+    bool readLogMel(uint64_t index, float* logMel) const;
+
+    /**
+     * @brief Last frame whose window ends at or before a position
+     * @return false if no frame ends that early
+     */
+    bool frameEndingBy(uint64_t position, uint64_t& index) const;
+
+    uint64_t endPosition(uint64_t index) const { return origin_ + windowSize_ + index * hopSize_; }
+
+    int getSampleRate() const { return sampleRate_; }
+    size_t windowSize() const { return windowSize_; }
+    size_t hopSize() const { return hopSize_; }
+    size_t fftSize() const { return fft_.size(); }
+    size_t numBins() const { return fft_.bins(); }
+    size_t numMels() const { return filterbank_.numMels(); }
+    size_t capacity() const { return capacity_; }
+
+    // Sum of squared window weights: the power of white noise of unit mean
+    // square in each bin
+    float windowEnergy() const { return windowEnergy_; }
+
+    const dsp::MelFilterbank& filterbank() const { return filterbank_; }
+
+private:
+    bool copyOut(uint64_t index, size_t offset, size_t count, float* out) const;
+    void publish();
+
+    int sampleRate_;
+    size_t windowSize_;
+    size_t hopSize_;
+    dsp::RealFft fft_;
+    dsp::MelFilterbank filterbank_;
+    std::vector<float> window_;
+    float windowEnergy_ = 0.0f;
+
+    // Writer state: the most recent window of input
+    std::vector<float> input_;
+    size_t inputFill_ = 0;
+    std::vector<float> windowed_;
+    std::vector<std::complex<float>> spectrum_;
+    uint64_t origin_ = 0;
+
+    // Published frames, each power spectrum followed by its log-mel energies
+    size_t capacity_;
+    size_t stride_;
+    std::vector<float> storage_;
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> writing_{0};    // written_ + 1 while a slot is being filled
+};
+
+} // namespace jarvis
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "dsp/fft.h"
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+namespace jarvis {
+
+class SpectralFeatures;
+
+// Voice Activity Detection (VAD)
+// Audio is scored in short analysis frames on three features: the SNR of
+// each band against its own tracked noise floor, the spectral flatness of
+// the noise-whitened spectrum, and the zero-crossing rate. These combine
+// into a speech probability, so steady noise of any colour or level is
+// learned and rejected rather than compared with one fixed threshold.
+// Frames below an absolute level are silence without being analysed; that
+// gate stays on integers, one vectorized pass per frame.
+class VoiceActivityDetector {
+public:
+    struct Params {
+        float minRms = 0.002f;              // frames quieter than this are silence
+        float speechThreshold = 0.5f;       // probability at which a frame is speech
+        int frameMs = 16;                   // analysis frame length
+        int bands = 8;                      // log-spaced between the frequencies below
+        float minFrequency = 200.0f;
+        float maxFrequency = 4000.0f;
+        int noiseWindowMs = 1500;           // floor is the band minimum over this long
+        float noiseBiasDb = 1.5f;           // the minimum underestimates the mean by this much
+
+        // Logistic weights, per unit of each feature, and the value at which
+        // each feature alone is neutral
+        float snrWeight = 0.5f;
+        float snrMidpointDb = 8.0f;
+        float flatnessWeight = 0.6f;
+        float flatnessMidpointDb = -4.0f;
+        float zcrWeight = 10.0f;
+        float zcrMidpoint = 0.25f;
+
+        float smoothing = 0.3f;             // weight of the previous probability
+    };
+
+    // Measurements of the last analysed frame
+    struct Features {
+        float snrDb = 0.0f;                 // mean band SNR over the noise floor
+        float flatnessDb = 0.0f;            // 0 for white, negative for tonal or harmonic
+        float zeroCrossingRate = 0.0f;      // crossings per sample
+        float probability = 0.0f;           // smoothed speech probability
+        bool speech = false;
+    };
+
+    explicit VoiceActivityDetector(int sampleRate);
+    VoiceActivityDetector(int sampleRate, const Params& params);
+    ~VoiceActivityDetector();
+
+    /**
+     * @brief Analyse a block of any length
+     * @return true while speech is active, until silenceTimeout of non-speech
+     */
+    bool processFrame(const int16_t* frame, size_t frameSize);
+
+    /**
+     * @brief Take spectra from a shared STFT stage instead of computing them
+     *
+     * Analysis frames become the stage's hops, fed with processSpectrum();
+     * processFrame() is not to be mixed with it.
+     */
+    void useSharedSpectrum(const SpectralFeatures& features);
+
+    /**
+     * @brief Analyse one hop with its published power spectrum
+     * @param hop The hop's samples, for the level gate and zero crossings
+     * @param power Power spectrum of the window ending with the hop
+     * @return As processFrame()
+     */
+    bool processSpectrum(const int16_t* hop, size_t hopSize, const float* power);
+
+    // Absolute RMS below which audio is silence (Params::minRms)
+    void setThreshold(float threshold);
+    void setSilenceTimeout(int ms);
+
+    /**
+     * @brief Replace all parameters; restarts noise tracking
+     */
+    void setParams(const Params& params);
+    const Params& getParams() const { return params_; }
+
+    float getSpeechProbability() const { return features_.probability; }
+    const Features& getFeatures() const { return features_; }
+
+    // Current noise floor of each band, in dB as the level of white noise
+    // with the same energy in that band
+    std::vector<float> getNoiseFloorDb() const;
+
+    // Forget any speech in progress, e.g. at the start of a new utterance;
+    // the noise floor is kept
+    void reset();
+
+private:
+    void configureAnalysis();
+    void analyse(const int16_t* frame, size_t n, const float* power);
+    void decide(size_t n);
+    bool isSilent(uint64_t sumSquares, size_t n) const;
+    void updateNoiseFloor(bool analysed);
+
+    int sampleRate_;
+    Params params_;
+    int silenceTimeoutMs_;
+    bool voiceDetected_;
+
+    // Precomputed from params_ and silenceTimeoutMs_
+    // (minRms * 32768)^2, the mean square of a frame at threshold, held
+    // exactly as whole + fraction / 2^shift
+    uint64_t silenceWhole_ = 0;
+    uint64_t silenceFraction_ = 0;
+    int silenceShift_ = 0;
+    uint64_t silenceTimeoutSamples_;
+    uint64_t silentSamples_ = 0;
+
+    // Layout of a shared STFT stage; fftSize 0 when analysing alone
+    size_t sharedFftSize_ = 0;
+    size_t sharedHopSize_ = 0;
+    float sharedWindowEnergy_ = 0.0f;
+
+    // Analysis frames are assembled from blocks of any size
+    size_t frameLength_ = 0;
+    std::vector<int16_t> pending_;
+    size_t pendingCount_ = 0;
+
+    dsp::RealFft fft_;
+    std::vector<float> window_;
+    std::vector<float> windowed_;
+    std::vector<std::complex<float>> spectrum_;
+    std::vector<float> power_;
+    std::vector<size_t> bandEdges_;     // bins [edge[b], edge[b + 1]) form band b
+
+    // Noise floor per band: minimum of the smoothed band energy over the
+    // window, kept as the minimum of each of a few sub-windows
+    static constexpr int kNoiseSubwindows = 4;
+    std::vector<float> bandEnergy_;
+    std::vector<float> smoothedEnergy_;
+    std::vector<float> currentMinimum_;
+    std::vector<float> subwindowMinima_;    // kNoiseSubwindows per band
+    std::vector<float> noiseFloor_;
+    float windowEnergy_ = 1.0f;             // band energy per unit mean square
+    float minimumFloor_ = 0.0f;             // band energy of audio at minRms
+    float noiseBias_ = 1.0f;
+    int subwindowFrames_ = 1;
+    int subwindowFill_ = 0;
+    int subwindowIndex_ = 0;
+
+    Features features_;
+};
+
+} // namespace jarvis
@@ -4,9 +4,12 @@
 #include <string>
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 namespace jarvis {
 
+class AudioCapture;
 class WakeWordDetector;
 class SpeechRecognizer;
 class TextToSpeech;
@@ -59,6 +62,8 @@ public:
     bool isRunning() const { return running_; }
 
 private:
+    // One capture stream, pushed into the wake word detector
+    std::unique_ptr<AudioCapture> audioCapture_;
     std::unique_ptr<WakeWordDetector> wakeWordDetector_;
     std::unique_ptr<SpeechRecognizer> speechRecognizer_;
     std::unique_ptr<TextToSpeech> textToSpeech_;
@@ -68,7 +73,11 @@ private:
     std::unique_ptr<Logger> logger_;
 
     std::atomic<bool> running_{false};
+    bool wakeWordReady_ = false;
     std::thread processingThread_;
+    std::mutex runMutex_;
+    std::condition_variable runCV_;
+    bool wakePending_ = false;   // set by the capture thread, handled by processingThread_; under runMutex_
 
     void processingLoop();
     void handleWakeWordDetected();
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace jarvis::dsp {
+
+/**
+ * @brief FFT of real signals, fixed power-of-two size
+ *
+ * The N real samples are packed into N/2 complex ones, transformed with
+ * an iterative radix-2 FFT and unpacked into the N/2 + 1 non-negative
+ * frequency bins. Twiddles and the bit-reversal order are precomputed at
+ * construction; transforms do not allocate.
+ */
+class RealFft {
+public:
+    /**
+     * @param size Transform length; a power of two, at least 4
+     */
+    explicit RealFft(size_t size);
+
+    size_t size() const { return size_; }
+    size_t bins() const { return size_ / 2 + 1; }
+
+    /**
+     * @brief Spectrum of size() samples into bins() values, unscaled
+     */
+    void forward(const float* in, std::complex<float>* out);
+
+    /**
+     * @brief Samples from bins() values; inverse(forward(x)) == x
+     */
+    void inverse(const std::complex<float>* in, float* out);
+
+private:
+    void transform(std::complex<float>* data) const;
+
+    size_t size_;
+    size_t half_;
+    std::vector<size_t> bitReversed_;
+    std::vector<std::complex<float>> twiddles_;    // e^{-2 pi i k / half}, k < half / 2
+    std::vector<std::complex<float>> unpack_;      // e^{-2 pi i k / size}, k <= half
+    std::vector<std::complex<float>> scratch_;
+};
+
+/**
+ * @brief |bins[k]|^2 for k < n
+ */
+void powerSpectrum(const std::complex<float>* bins, float* power, size_t n);
+
+/**
+ * @brief Periodic Hann window of a given length
+ */
+std::vector<float> hannWindow(size_t length);
+
+} // namespace jarvis::dsp
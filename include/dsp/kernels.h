@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace jarvis::dsp {
+
+/**
+ * @brief Instruction set a kernel table is built for
+ *
+ * The best one the CPU supports is picked at startup; tests and
+ * benchmarks can switch with setIsa().
+ */
+enum class Isa {
+    Scalar,     // portable reference
+    SSE2,       // x86-64 baseline
+    AVX2,
+    AVX512,     // AVX-512 F and BW
+    AVX512VNNI  // AVX-512 with the byte dot product instruction
+};
+
+/**
+ * @brief One implementation of every kernel
+ *
+ * Integer results and the int16/float conversions are bit-identical across
+ * tables. Float reductions (sums, dot products, FIR) add in a different
+ * order per table and agree to rounding.
+ */
+struct Kernels {
+    // out[i] = in[i] / 32768
+    void (*int16ToFloat)(const int16_t* in, float* out, size_t n);
+    // out[i] = in[i] * 32768, rounded to nearest even and saturated
+    void (*floatToInt16)(const float* in, int16_t* out, size_t n);
+
+    // out[i] = in[i] * gain, rounded and saturated; in place is fine
+    void (*gain)(const int16_t* in, int16_t* out, size_t n, float gain);
+    // out[i] = in[i] * gain, clipped to [-limit, limit]; in place is fine
+    void (*gainClip)(const float* in, float* out, size_t n, float gain, float limit);
+
+    // out[i] = a[i] + b[i], saturated
+    void (*mix)(const int16_t* a, const int16_t* b, int16_t* out, size_t n);
+    // acc[i] += in[i] * gain
+    void (*mixAccumulate)(float* acc, const float* in, size_t n, float gain);
+
+    // Exact sum of in[i]^2
+    uint64_t (*sumSquares)(const int16_t* in, size_t n);
+    float (*sumSquaresFloat)(const float* in, size_t n);
+
+    // max |in[i]|, 0..32768
+    int32_t (*peak)(const int16_t* in, size_t n);
+
+    float (*dot)(const float* a, const float* b, size_t n);
+
+    // out[i] = sum over k of taps[k] * in[i + k]; in holds n + numTaps - 1 samples
+    void (*fir)(const float* in, float* out, size_t n, const float* taps, size_t numTaps);
+
+    // out[r] = sum over k of (x[k] - rows[r * dim + k])^2, for count rows of dim values
+    void (*squaredDistances)(const float* x, const float* rows, size_t count, size_t dim, float* out);
+
+    // out[r] = sum over k of w[r * cols + k] * x[k], exact; w must stay within [-127, 127]
+    void (*gemvInt8)(const int8_t* w, const int8_t* x, size_t rows, size_t cols, int32_t* out);
+};
+
+const char* isaName(Isa isa);
+
+// Best instruction set this build and CPU support
+Isa bestIsa();
+bool isSupported(Isa isa);
+
+/**
+ * @brief Kernel table for an instruction set
+ * @return nullptr if this build or CPU does not support it
+ */
+const Kernels* kernelsFor(Isa isa);
+
+// Table the free functions below dispatch to
+const Kernels& kernels();
+Isa activeIsa();
+
+/**
+ * @brief Route the free functions to another table
+ * @return false (and nothing changed) if isa is not supported
+ */
+bool setIsa(Isa isa);
+
+inline void int16ToFloat(const int16_t* in, float* out, size_t n) { kernels().int16ToFloat(in, out, n); }
+inline void floatToInt16(const float* in, int16_t* out, size_t n) { kernels().floatToInt16(in, out, n); }
+inline void gain(const int16_t* in, int16_t* out, size_t n, float g) { kernels().gain(in, out, n, g); }
+inline void gainClip(const float* in, float* out, size_t n, float g, float limit = 1.0f) {
+    kernels().gainClip(in, out, n, g, limit);
+}
+inline void mix(const int16_t* a, const int16_t* b, int16_t* out, size_t n) { kernels().mix(a, b, out, n); }
+inline void mixAccumulate(float* acc, const float* in, size_t n, float g) { kernels().mixAccumulate(acc, in, n, g); }
+inline uint64_t sumSquares(const int16_t* in, size_t n) { return kernels().sumSquares(in, n); }
+inline float sumSquares(const float* in, size_t n) { return kernels().sumSquaresFloat(in, n); }
+inline int32_t peak(const int16_t* in, size_t n) { return kernels().peak(in, n); }
+inline float dot(const float* a, const float* b, size_t n) { return kernels().dot(a, b, n); }
+inline void fir(const float* in, float* out, size_t n, const float* taps, size_t numTaps) {
+    kernels().fir(in, out, n, taps, numTaps);
+}
+inline void squaredDistances(const float* x, const float* rows, size_t count, size_t dim, float* out) {
+    kernels().squaredDistances(x, rows, count, dim, out);
+}
+inline void gemvInt8(const int8_t* w, const int8_t* x, size_t rows, size_t cols, int32_t* out) {
+    kernels().gemvInt8(w, x, rows, cols, out);
+}
+
+/**
+ * @brief Root mean square of 16-bit samples, full scale = 1.0
+ */
+inline float rms(const int16_t* in, size_t n) {
+    return n == 0 ? 0.0f : static_cast<float>(std::sqrt(static_cast<double>(sumSquares(in, n)) / n) / 32768.0);
+}
+
+inline float rms(const float* in, size_t n) {
+    return n == 0 ? 0.0f : std::sqrt(sumSquares(in, n) / static_cast<float>(n));
+}
+
+} // namespace jarvis::dsp
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace jarvis::dsp {
+
+/**
+ * @brief Triangular mel filters over a power spectrum
+ *
+ * Filters are spaced evenly on the HTK mel scale between two frequencies
+ * and stored sparsely, as the first bin and the weights of each, so
+ * applying the bank touches each non-zero weight once.
+ */
+class MelFilterbank {
+public:
+    /**
+     * @param numMels Number of filters
+     * @param fftSize Transform length; spectra hold fftSize / 2 + 1 bins
+     * @param sampleRate Audio sample rate in Hz
+     * @param minFrequency Lower edge of the first filter in Hz
+     * @param maxFrequency Upper edge of the last filter in Hz
+     */
+    MelFilterbank(size_t numMels, size_t fftSize, int sampleRate, float minFrequency, float maxFrequency);
+
+    size_t numMels() const { return filters_.size(); }
+    size_t numBins() const { return numBins_; }
+
+    /**
+     * @brief Filter energies of a power spectrum
+     * @param power numBins() values
+     * @param out numMels() values
+     */
+    void apply(const float* power, float* out) const;
+
+    // Frequency range in bins covered by filter m
+    size_t firstBin(size_t m) const { return filters_[m].first; }
+    const std::vector<float>& weights(size_t m) const { return filters_[m].weights; }
+
+    static float hzToMel(float hz);
+    static float melToHz(float mel);
+
+private:
+    struct Filter {
+        size_t first = 0;
+        std::vector<float> weights;
+    };
+
+    size_t numBins_;
+    std::vector<Filter> filters_;
+};
+
+} // namespace jarvis::dsp
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace jarvis::nn {
+
+/**
+ * @brief Small streaming network with int8 weights, mapped from a flat file
+ *
+ * For tiny per-hop models (VAD, keyword scores): dense, causal conv1d and
+ * GRU layers in sequence. Each weight row is int8 with its own float
+ * scale; biases are float. The file is memory-mapped and the layers point
+ * straight into it, so loading copies nothing and several sessions share
+ * one model.
+ *
+ * File layout, little-endian; every blob starts on a 64-byte boundary:
+ *   FileHeader
+ *   LayerRecord[layerCount]
+ *   blobs: int8 weights (rows x cols), float row scales, float biases
+ */
+class Model {
+public:
+    enum class LayerType : uint32_t {
+        Dense = 1,      // y = act(W x + b)
+        Conv1d = 2,     // dense over the last kernelSize input frames, oldest first
+        Gru = 3         // gates r, z, n in that order; output is the hidden state
+    };
+
+    enum class Activation : uint32_t {
+        None = 0,
+        Relu = 1,
+        Sigmoid = 2,
+        Tanh = 3
+    };
+
+    static constexpr uint32_t kMagic = 0x314e4e4a;     // "JNN1"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kAlignment = 64;
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t layerCount;
+        uint32_t inputSize;
+        uint32_t reserved[4];
+    };
+
+    struct LayerRecord {
+        uint32_t type;
+        uint32_t activation;
+        uint32_t inputSize;
+        uint32_t outputSize;
+        uint32_t kernelSize;            // Conv1d frames; 1 otherwise
+        uint32_t reserved;
+        uint64_t weightsOffset;         // GRU: input weights, then recurrent weights
+        uint64_t scalesOffset;          // one per weight row
+        uint64_t biasOffset;            // GRU: input bias, then recurrent bias
+        uint64_t padding[2];
+    };
+
+    // A layer's view into the mapped file
+    struct Layer {
+        LayerType type = LayerType::Dense;
+        Activation activation = Activation::None;
+        size_t inputSize = 0;
+        size_t outputSize = 0;
+        size_t kernelSize = 1;
+        size_t rows = 0;                // weight rows: outputSize, or 3 x hidden for GRU
+        size_t cols = 0;                // inputSize x kernelSize
+        const int8_t* weights = nullptr;
+        const float* scales = nullptr;
+        const float* bias = nullptr;
+
+        // GRU only: hidden-to-gate weights, rows x outputSize
+        const int8_t* recurrentWeights = nullptr;
+        const float* recurrentScales = nullptr;
+        const float* recurrentBias = nullptr;
+
+        // Multiply-accumulates per time step
+        size_t macs() const;
+    };
+
+    Model();
+    ~Model();
+
+    Model(const Model&) = delete;
+    Model& operator=(const Model&) = delete;
+
+    /**
+     * @brief Map a model file and check every layer against it
+     * @return false (and nothing loaded) if the file is missing or malformed
+     */
+    bool load(const std::string& path);
+    void close();
+
+    bool isLoaded() const { return data_ != nullptr; }
+    size_t inputSize() const { return inputSize_; }
+    size_t outputSize() const { return layers_.empty() ? 0 : layers_.back().outputSize; }
+    const std::vector<Layer>& layers() const { return layers_; }
+
+    // Bytes mapped
+    size_t size() const { return size_; }
+
+    static const char* layerTypeName(LayerType type);
+
+private:
+    bool parse();
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    void* mapping_ = nullptr;           // platform handle kept until close()
+    size_t inputSize_ = 0;
+    std::vector<Layer> layers_;
+};
+
+/**
+ * @brief Quantize float weights and write them as a model file
+ *
+ * For export tools and tests. Each weight row is scaled so its largest
+ * magnitude becomes 127.
+ */
+class ModelWriter {
+public:
+    using Activation = Model::Activation;
+
+    explicit ModelWriter(size_t inputSize);
+
+    /**
+     * @param weights outputs x inputs, row-major
+     */
+    void addDense(size_t outputs, const std::vector<float>& weights, const std::vector<float>& bias,
+                  Activation activation = Activation::None);
+
+    /**
+     * @param weights outputs x (kernelSize x inputs): per output, the oldest frame's weights first
+     */
+    void addConv1d(size_t outputs, size_t kernelSize, const std::vector<float>& weights,
+                   const std::vector<float>& bias, Activation activation = Activation::None);
+
+    /**
+     * @param inputWeights 3 x hidden rows (gates r, z, n) of inputs
+     * @param recurrentWeights 3 x hidden rows of hidden
+     * @param inputBias, recurrentBias 3 x hidden each
+     */
+    void addGru(size_t hidden, const std::vector<float>& inputWeights, const std::vector<float>& recurrentWeights,
+                const std::vector<float>& inputBias, const std::vector<float>& recurrentBias);
+
+    // Size of the current last layer's output
+    size_t outputSize() const { return outputSize_; }
+
+    /**
+     * @return false if a layer's sizes did not match or the file cannot be written
+     */
+    bool save(const std::string& path) const;
+
+private:
+    struct Pending {
+        Model::LayerRecord record;
+        std::vector<int8_t> weights;
+        std::vector<float> scales;
+        std::vector<float> bias;
+    };
+
+    void quantizeRows(const std::vector<float>& weights, size_t rows, size_t cols, Pending& layer) const;
+
+    size_t inputSize_;
+    size_t outputSize_;
+    bool valid_ = true;
+    std::vector<Pending> layers_;
+};
+
+} // namespace jarvis::nn
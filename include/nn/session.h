@@ -0,0 +1,79 @@
+#pragma once
+
+#include "nn/model.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace jarvis::nn {
+
+/**
+ * @brief One stream through a model, a time step per call
+ *
+ * Holds what the model carries between steps (conv1d input history, GRU
+ * hidden state) and the scratch for one step, all sized at construction.
+ * Each layer quantizes its input vector to int8 with a per-step scale,
+ * runs the int8 GEMV kernel with int32 accumulation, and rescales to
+ * float for the bias and activation.
+ *
+ * Single-threaded; the model must outlive the session.
+ */
+class Session {
+public:
+    struct LayerTiming {
+        Model::LayerType type = Model::LayerType::Dense;
+        size_t macs = 0;                // per step
+        uint64_t steps = 0;
+        double totalUs = 0.0;
+
+        double meanUs() const { return steps ? totalUs / steps : 0.0; }
+    };
+
+    explicit Session(const Model& model);
+
+    /**
+     * @brief Run one time step
+     * @param input model.inputSize() values
+     * @return model.outputSize() values, valid until the next call
+     */
+    const float* process(const float* input);
+
+    // Forget the stream so far
+    void reset();
+
+    // Per-layer wall time of process(); off by default
+    void setTiming(bool enabled) { timing_ = enabled; }
+    const std::vector<LayerTiming>& timings() const { return timings_; }
+    void resetTimings();
+
+    const Model& model() const { return model_; }
+
+private:
+    // Quantized copy of a float vector; returns its scale
+    float quantize(const float* x, size_t n);
+
+    // out[r] = scales[r] * xScale * (W xq)[r] + bias[r]
+    void affine(const int8_t* weights, const float* scales, const float* bias, size_t rows, size_t cols,
+                float xScale, float* out);
+
+    void runDense(const Model::Layer& layer, const float* in, float* out);
+    void runConv1d(size_t index, const Model::Layer& layer, const float* in, float* out);
+    void runGru(size_t index, const Model::Layer& layer, const float* in, float* out);
+
+    const Model& model_;
+    bool timing_ = false;
+    std::vector<LayerTiming> timings_;
+
+    // Per layer: conv1d history (kernelSize x inputSize, oldest first) or GRU hidden state
+    std::vector<std::vector<float>> state_;
+
+    // Scratch
+    std::vector<float> a_;
+    std::vector<float> b_;
+    std::vector<int8_t> quantized_;
+    std::vector<int32_t> accumulators_;
+    std::vector<float> gates_;
+    std::vector<float> recurrentGates_;
+};
+
+} // namespace jarvis::nn
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "audio/spectral_features.h"
+#include "speech/wake_word_engine.h"
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace jarvis {
+
+/**
+ * @brief Built-in keyword spotter: MFCC templates matched by streaming DTW
+ *
+ * Needs no licence, model or network: each keyword is enrolled from a few
+ * recordings of it, and every 10 ms frame of the stream is aligned against
+ * every recording with open-begin dynamic time warping. A keyword fires
+ * when some recording aligns with the audio just heard at a mean frame
+ * distance below its threshold.
+ *
+ * Features are MFCCs c1..c12 of the shared log-mel analysis (c0, the
+ * level, is dropped), padded to kFeatureDim for the vector distance
+ * kernel. A keyword enrolled from two or more recordings takes its
+ * threshold from how far apart they align; from one, Params::threshold.
+ */
+class KeywordSpotter : public WakeWordEngine {
+public:
+    static constexpr int kSampleRate = 16000;
+    static constexpr size_t kFeatureDim = 16;
+
+    struct Params {
+        int cepstra = 12;                   // c1..c12, at most kFeatureDim
+        float threshold = 6.0f;             // mean frame distance accepted from a single recording at sensitivity 0.5
+        float minSpread = 1.0f;             // floor for the spread of near-identical recordings
+        int refractoryMs = 1000;            // a keyword is not reported again within this
+        float maxStretch = 2.0f;            // audio may be up to this much longer than a recording
+    };
+
+    struct Template {
+        std::vector<float> features;        // frames x kFeatureDim
+        size_t frames = 0;
+    };
+
+    KeywordSpotter();
+    explicit KeywordSpotter(const Params& params);
+    ~KeywordSpotter() override;
+
+    /**
+     * @brief Enroll a keyword from WAV recordings (16 kHz mono PCM16)
+     * @param sensitivity [0.0, 1.0]; higher accepts looser matches
+     * @return Keyword index, or kNoKeyword if no recording could be used
+     */
+    int enroll(const std::string& name, const std::vector<std::string>& wavPaths, float sensitivity = 0.5f);
+
+    /**
+     * @brief Enroll a keyword from recordings in memory
+     * @return Keyword index, or kNoKeyword if no recording could be used
+     */
+    int enroll(const std::string& name, const std::vector<std::vector<int16_t>>& recordings,
+               float sensitivity = 0.5f);
+
+    /**
+     * @brief MFCC frames of a recording, trimmed to where it is not silent
+     */
+    Template extractTemplate(const std::vector<int16_t>& recording) const;
+
+    /**
+     * @brief Mean frame distance of the best full alignment of two templates
+     */
+    float alignmentCost(const Template& a, const Template& b) const;
+
+    // WakeWordEngine
+    const char* name() const override { return "builtin"; }
+    int sampleRate() const override { return kSampleRate; }
+    int frameLength() const override { return static_cast<int>(features_->hopSize()); }
+    size_t keywordCount() const override { return keywords_.size(); }
+    int process(const int16_t* frame) override;
+    void reset() override;
+
+    const std::string& keywordName(size_t keyword) const { return keywords_[keyword].name; }
+    float threshold(size_t keyword) const { return keywords_[keyword].threshold; }
+
+    // Lowest mean frame distance seen for a keyword since the last reset
+    float bestScore(size_t keyword) const { return keywords_[keyword].bestScore; }
+
+    const Params& getParams() const { return params_; }
+
+private:
+    static constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+    // One recording's open-begin alignment state: the cost and length of the
+    // best path ending at each template frame with the current input frame
+    struct Alignment {
+        Template reference;
+        std::vector<float> cost;
+        std::vector<uint32_t> length;
+        std::vector<float> nextCost;
+        std::vector<uint32_t> nextLength;
+    };
+
+    struct Keyword {
+        std::string name;
+        float threshold = 0.0f;
+        std::vector<Alignment> alignments;
+        int refractory = 0;                 // frames left
+        float bestScore = kInfinity;
+    };
+
+    void cepstrum(const float* logMel, float* out) const;
+
+    // Distance of an input frame to every frame of a template
+    void distancesTo(const Template& reference, const float* feature, float* out) const;
+
+    // Advance an alignment by one input frame; openBegin lets a path start here
+    void step(Alignment& alignment, const float* distances, bool openBegin) const;
+
+    Params params_;
+    std::unique_ptr<SpectralFeatures> features_;
+    std::vector<float> dct_;                // cepstra x mels
+    std::vector<Keyword> keywords_;
+    int refractoryFrames_ = 0;
+
+    // Per-frame scratch
+    std::vector<float> samples_;
+    std::vector<float> logMel_;
+    std::vector<float> feature_;
+    std::vector<float> distances_;
+    uint64_t nextFrame_ = 0;
+};
+
+} // namespace jarvis
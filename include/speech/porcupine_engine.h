@@ -0,0 +1,52 @@
+#pragma once
+
+#include "speech/wake_word_engine.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Forward declarations for Porcupine
+struct pv_porcupine;
+typedef struct pv_porcupine pv_porcupine_t;
+
+namespace jarvis {
+
+/**
+ * @brief Porcupine from Picovoice as a wake word engine
+ *
+ * Needs the Porcupine library at build time and PICOVOICE_ACCESS_KEY at
+ * run time. One engine instance scores every keyword in the same call.
+ */
+class PorcupineEngine : public WakeWordEngine {
+public:
+    struct Keyword {
+        std::string path;                   // keyword file (.ppn)
+        float sensitivity = 0.5f;           // [0.0, 1.0]
+    };
+
+    /**
+     * @brief Create the engine
+     * @param modelPath Path to the Porcupine model file
+     * @return The engine, or nullptr if Porcupine is unavailable or fails to start
+     */
+    static std::unique_ptr<PorcupineEngine> create(const std::string& modelPath, const std::vector<Keyword>& keywords);
+
+    // Whether this build includes Porcupine
+    static bool available();
+
+    ~PorcupineEngine() override;
+
+    const char* name() const override { return "porcupine"; }
+    int sampleRate() const override;
+    int frameLength() const override;
+    size_t keywordCount() const override { return keywordCount_; }
+    int process(const int16_t* frame) override;
+
+private:
+    PorcupineEngine(pv_porcupine_t* porcupine, size_t keywordCount);
+
+    pv_porcupine_t* porcupine_;
+    size_t keywordCount_;
+};
+
+} // namespace jarvis
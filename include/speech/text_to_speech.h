@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <memory>
+#include <vector>
 #include <thread>
 #include <mutex>
 #include <queue>
@@ -43,6 +45,23 @@ public:
      */
     void speak(const std::string& text, bool async = true);
 
+    /**
+     * @brief Render text to mono PCM instead of playing it
+     * @param text Text to render
+     * @param sampleRate Rate of the returned PCM
+     * @return The speech, or nothing if synthesis failed or stop() cut it off
+     *
+     * Needs setRenderOnly(true) before initialize(): eSpeak either plays on
+     * its own device or hands its audio back, not both.
+     */
+    std::vector<int16_t> synthesize(const std::string& text, int sampleRate);
+
+    /**
+     * @brief Hand speech back through synthesize() rather than playing it
+     * @param renderOnly Takes effect on the next initialize()
+     */
+    void setRenderOnly(bool renderOnly);
+
     /**
      * @brief Stop speaking immediately
      */
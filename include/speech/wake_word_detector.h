@@ -1,26 +1,62 @@
 #pragma once
 
+#include "audio/frame_assembler.h"
+#include "speech/wake_word_engine.h"
+#include <cstdint>
 #include <functional>
 #include <memory>
-#include <thread>
 #include <atomic>
+#include <span>
+#include <string>
 #include <vector>
 
-// Forward declarations for Porcupine
-struct pv_porcupine;
-typedef struct pv_porcupine pv_porcupine_t;
-
 namespace jarvis {
 
+class ConfigManager;
+
 /**
- * @brief Wake word detection using Porcupine engine
+ * @brief Wake word detection on a pluggable keyword engine
  * 
  * This class provides wake word detection functionality using
- * the Porcupine wake word engine from Picovoice.
+ * the Porcupine wake word engine from Picovoice, or the built-in
+ * KeywordSpotter for keywords enrolled from recordings, which needs no
+ * licence, model or network.
+ *
+ * The detector opens no audio device: whoever owns the capture pushes
+ * audio in with processAudio(), so one stream serves every consumer.
+ * Starting and stopping detection only arms and disarms the engine.
+ *
+ * Several keywords (a wake word, "stop", "cancel", ...) are evaluated in
+ * the same engine call per frame; each detection reports its index.
  */
 class WakeWordDetector {
 public:
-    using WakeWordCallback = std::function<void()>;
+    // Index of the detected keyword, in the order given to initialize()
+    using WakeWordCallback = std::function<void(int keywordIndex)>;
+
+    struct Keyword {
+        std::string name;
+        std::string path;                   // keyword file (.ppn), for Porcupine
+        std::vector<std::string> recordings;    // 16 kHz mono WAVs of the keyword, for the built-in engine
+        float sensitivity = 0.5f;           // [0.0, 1.0]
+        WakeWordCallback callback;          // called for this keyword only, before the detector's
+    };
+
+    enum class Engine {
+        Auto,           // Porcupine when built in and every keyword has a .ppn, else built-in
+        Porcupine,
+        Builtin
+    };
+
+    // Engine and keywords to initialize with
+    struct Settings {
+        std::string modelPath;              // Porcupine model
+        std::vector<Keyword> keywords;
+        Engine engine = Engine::Auto;
+    };
+
+    // processAudio() result when no keyword was detected
+    static constexpr int kNoKeyword = WakeWordEngine::kNoKeyword;
 
     WakeWordDetector();
     ~WakeWordDetector();
@@ -37,16 +73,66 @@ public:
                    float sensitivity = 0.5f);
 
     /**
-     * @brief Start wake word detection
-     * @param callback Function to call when wake word is detected
+     * @brief Initialize with several keywords, evaluated together per frame
+     * @param modelPath Path to the Porcupine model file
+     * @param keywords Keywords with their own sensitivity and optional callback
+     * @param engine Engine to score them with
+     * @return true if initialization successful, false otherwise
+     */
+    bool initialize(const std::string& modelPath, const std::vector<Keyword>& keywords,
+                    Engine engine = Engine::Auto);
+
+    /**
+     * @brief Read the wake_word section of a config
+     *
+     * wake_word.keywords lists every keyword; without it, keyword_path (for
+     * Porcupine) and recordings (for the built-in engine) describe the one
+     * wake word. engine is "porcupine", "builtin" or "auto".
+     */
+    static Settings readSettings(ConfigManager& config);
+
+    /**
+     * @brief Initialize with settings from readSettings()
+     */
+    bool initialize(const Settings& settings);
+
+    /**
+     * @brief Use an engine built elsewhere; keyword i of the engine is keywords[i]
+     * @return true if the engine scores exactly these keywords
+     */
+    bool setEngine(std::unique_ptr<WakeWordEngine> engine, const std::vector<Keyword>& keywords);
+
+    // Name of the engine in use, or "none"
+    const char* getEngineName() const;
+
+    /**
+     * @brief Start wake word detection on the audio pushed from now on
+     * @param callback Function to call with the index of each keyword detected, on the pushing thread
      */
     void startDetection(WakeWordCallback callback);
 
     /**
-     * @brief Stop wake word detection
+     * @brief Stop wake word detection; audio pushed meanwhile is ignored
      */
     void stopDetection();
 
+    /**
+     * @brief Forget the engine state before the next block, e.g. after a gap in the audio
+     */
+    void reset();
+
+    /**
+     * @brief Feed captured audio (push mode)
+     *
+     * Call from one thread at a time. With blocks of getFrameLength()
+     * samples a detection always ends with the block it is reported for.
+     * @param samples Mono PCM at getSampleRate(), any block size
+     * @return Index of the last keyword detected in this block, or kNoKeyword
+     */
+    int processAudio(std::span<const int16_t> samples);
+
+    const std::vector<Keyword>& getKeywords() const { return keywords_; }
+
     /**
      * @brief Check if detection is running
      * @return true if running, false otherwise
@@ -54,30 +140,33 @@ public:
     bool isRunning() const { return running_; }
 
     /**
-     * @brief Get sample rate required by Porcupine
+     * @brief Get sample rate required by the engine
      * @return Sample rate in Hz
      */
     int getSampleRate() const;
 
     /**
-     * @brief Get frame length required by Porcupine
+     * @brief Get frame length required by the engine
      * @return Frame length in samples
      */
     int getFrameLength() const;
 
 private:
-    std::unique_ptr<pv_porcupine_t, void(*)(pv_porcupine_t*)> porcupine_;
+    std::unique_ptr<WakeWordEngine> engine_;
     WakeWordCallback callback_;
-    std::thread detectionThread_;
     std::atomic<bool> running_{false};
-    std::atomic<bool> shouldStop_{false};
-
-    void detectionLoop();
-    bool processAudioFrame(const std::vector<int16_t>& frame);
-    
-    // Audio capture
-    class AudioCapture;
-    std::unique_ptr<AudioCapture> audioCapture_;
+
+    // Set by startDetection(); the pushing thread drops the stale partial frame
+    std::atomic<bool> restart_{false};
+
+    std::vector<Keyword> keywords_;
+
+    // Routes one engine frame's detection to the callbacks
+    void processAudioFrame(const int16_t* frame);
+
+    // Cuts pushed blocks into engine frames; per instance, so detectors can run side by side
+    std::unique_ptr<FrameAssembler> frameAssembler_;
+    int detected_ = kNoKeyword;
 };
 
-} // namespace jarvis
\ No newline at end of file
+} // namespace jarvis
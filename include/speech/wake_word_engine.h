@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace jarvis {
+
+/**
+ * @brief Keyword engine behind WakeWordDetector
+ *
+ * Scores fixed-length frames of 16-bit mono audio against a set of
+ * keywords fixed at construction. Porcupine and the built-in
+ * KeywordSpotter implement it; the detector cuts the stream into frames
+ * and routes detections.
+ */
+class WakeWordEngine {
+public:
+    // process() result when no keyword was detected
+    static constexpr int kNoKeyword = -1;
+
+    virtual ~WakeWordEngine() = default;
+
+    virtual const char* name() const = 0;
+    virtual int sampleRate() const = 0;
+    virtual int frameLength() const = 0;
+    virtual size_t keywordCount() const = 0;
+
+    /**
+     * @brief Score one frame
+     * @param frame frameLength() samples at sampleRate()
+     * @return Index of the keyword that ended with this frame, or kNoKeyword
+     */
+    virtual int process(const int16_t* frame) = 0;
+
+    // Forget the stream so far, e.g. when detection restarts
+    virtual void reset() {}
+};
+
+} // namespace jarvis
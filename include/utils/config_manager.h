@@ -2,6 +2,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 namespace jarvis {
@@ -109,6 +110,10 @@ public:
     const nlohmann::json& getConfig() const { return config_; }
 
 private:
+    // "a.b.c" -> {"a", "b", "c"}
+    std::vector<std::string> splitKey(const std::string& key);
+    void setValue(const std::string& key, const nlohmann::json& value);
+
     nlohmann::json config_;
     bool loaded_;
     std::string filename_;
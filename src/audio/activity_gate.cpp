@@ -0,0 +1,86 @@
+#include "audio/activity_gate.h"
+#include "dsp/kernels.h"
+#include <algorithm>
+#include <cmath>
+
+namespace jarvis {
+
+ActivityGate::ActivityGate(int sampleRate) : ActivityGate(sampleRate, Params{}) {}
+
+ActivityGate::ActivityGate(int sampleRate, const Params& params) : sampleRate_(sampleRate) {
+    setParams(params);
+}
+
+void ActivityGate::setParams(const Params& params) {
+    params_ = params;
+    double level = std::max(0.0, static_cast<double>(params_.minRms)) * 32768.0;
+    minimumSquared_ = static_cast<uint64_t>(std::llround(level * level));
+    openRatio_ = std::pow(10.0, params_.openMarginDb / 10.0);
+    riseFactorPerSample_ = std::pow(10.0, params_.floorRiseDbPerSecond / 10.0 / sampleRate_);
+    holdSamples_ = static_cast<uint64_t>(std::max(0, params_.holdMs)) * sampleRate_ / 1000;
+}
+
+bool ActivityGate::process(const int16_t* frame, size_t frameSize) {
+    justOpened_ = false;
+    if (frameSize == 0) {
+        return open_;
+    }
+
+    const uint64_t sumSquares = dsp::sumSquares(frame, frameSize);
+    const double meanSquare = static_cast<double>(sumSquares) / frameSize;
+    const bool loud = sumSquares > minimumSquared_ * frameSize && background_ >= 0.0 &&
+                      meanSquare > background_ * openRatio_;
+
+    // The background drops to quieter frames at once and creeps up otherwise,
+    // so a steady noise is absorbed while a word stands out of it
+    if (background_ < 0.0 || meanSquare <= background_) {
+        background_ = meanSquare;
+    } else {
+        background_ = std::min(meanSquare, background_ * std::pow(riseFactorPerSample_, static_cast<double>(frameSize)));
+    }
+
+    if (loud) {
+        sinceLoud_ = 0;
+        if (!open_) {
+            open_ = true;
+            justOpened_ = true;
+            openings_.fetch_add(1, std::memory_order_relaxed);
+        }
+    } else if (open_) {
+        sinceLoud_ += frameSize;
+        if (sinceLoud_ >= holdSamples_) {
+            open_ = false;
+        }
+    }
+
+    frames_.fetch_add(1, std::memory_order_relaxed);
+    if (open_) {
+        openFrames_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return open_;
+}
+
+size_t ActivityGate::lookbackSamples() const {
+    return static_cast<size_t>(std::max(0, params_.lookbackMs)) * sampleRate_ / 1000;
+}
+
+void ActivityGate::countReplayed(uint64_t frames) {
+    openFrames_.fetch_add(frames, std::memory_order_relaxed);
+}
+
+ActivityGate::Stats ActivityGate::getStats() const {
+    Stats stats;
+    stats.frames = frames_.load(std::memory_order_relaxed);
+    stats.openFrames = openFrames_.load(std::memory_order_relaxed);
+    stats.openings = openings_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void ActivityGate::reset() {
+    background_ = -1.0;
+    open_ = false;
+    justOpened_ = false;
+    sinceLoud_ = 0;
+}
+
+} // namespace jarvis
@@ -0,0 +1,267 @@
+#include "audio/audio_broadcast_buffer.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace jarvis {
+
+AudioBroadcastBuffer::AudioBroadcastBuffer(size_t capacity, int sampleRate, int channels)
+    : capacity_(std::bit_ceil(std::max<size_t>(capacity, 1))),
+      mask_(capacity_ - 1),
+      sampleRate_(sampleRate),
+      channels_(std::max(channels, 1)),
+      buffer_(capacity_) {
+}
+
+AudioBroadcastBuffer::~AudioBroadcastBuffer() = default;
+
+AudioBroadcastBuffer::ReaderId AudioBroadcastBuffer::addReader(const std::string& name) {
+    std::lock_guard<std::mutex> lock(readersMutex_);
+    for (ReaderId id = 0; id < kMaxReaders; ++id) {
+        Reader& reader = readers_[id];
+        if (!reader.active.load(std::memory_order_acquire)) {
+            reader.name = name;
+            reader.position.store(tail_.load(std::memory_order_acquire), std::memory_order_relaxed);
+            reader.overruns.store(0, std::memory_order_relaxed);
+            reader.droppedSamples.store(0, std::memory_order_relaxed);
+            reader.maxLag.store(0, std::memory_order_relaxed);
+            reader.active.store(true, std::memory_order_release);
+            return id;
+        }
+    }
+    return kInvalidReader;
+}
+
+void AudioBroadcastBuffer::removeReader(ReaderId reader) {
+    if (reader >= kMaxReaders) return;
+    std::lock_guard<std::mutex> lock(readersMutex_);
+    readers_[reader].active.store(false, std::memory_order_release);
+}
+
+void AudioBroadcastBuffer::write(const int16_t* data, size_t count) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+
+    // Anything beyond one ring's worth would be overwritten immediately
+    if (count > capacity_) {
+        tail += count - capacity_;
+        data += count - capacity_;
+        count = capacity_;
+    }
+
+    // Announce the region being overwritten before touching it
+    uint64_t end = tail + count;
+    writeStart_.store(end, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    size_t offset = tail & mask_;
+    size_t first = std::min(count, capacity_ - offset);
+    std::memcpy(buffer_.data() + offset, data, first * sizeof(int16_t));
+    std::memcpy(buffer_.data(), data + first, (count - first) * sizeof(int16_t));
+
+    tail_.store(end, std::memory_order_release);
+    dataSignal_.notify(end);
+}
+
+void AudioBroadcastBuffer::write(const int16_t* data, size_t count, const AudioTimestamp& stamp) {
+    // The anchor must be visible before any reader can see the samples it describes
+    uint64_t n = anchorCount_.load(std::memory_order_relaxed);
+    anchorStart_.store(n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Anchor& anchor = anchors_[n % kMaxAnchors];
+    anchor.position.store(tail_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    anchor.frameIndex.store(stamp.frameIndex, std::memory_order_relaxed);
+    anchor.captureTicks.store(stamp.captureTime.time_since_epoch().count(), std::memory_order_relaxed);
+    anchorCount_.store(n + 1, std::memory_order_release);
+
+    write(data, count);
+}
+
+AudioTimestamp AudioBroadcastBuffer::timestampAt(uint64_t position) const {
+    for (;;) {
+        uint64_t n = anchorCount_.load(std::memory_order_acquire);
+        if (n == 0) {
+            return {};
+        }
+
+        // Newest anchor at or before position (anchors are in position order)
+        uint64_t lo = n > kMaxAnchors ? n - kMaxAnchors : 0;
+        uint64_t hi = n;
+        while (hi - lo > 1) {
+            uint64_t mid = lo + (hi - lo) / 2;
+            if (anchors_[mid % kMaxAnchors].position.load(std::memory_order_relaxed) <= position) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+
+        const Anchor& anchor = anchors_[lo % kMaxAnchors];
+        uint64_t anchorPos = anchor.position.load(std::memory_order_relaxed);
+        AudioTimestamp stamp{anchor.frameIndex.load(std::memory_order_relaxed),
+                             AudioTimestamp::Clock::time_point(AudioTimestamp::Clock::duration(
+                                 anchor.captureTicks.load(std::memory_order_relaxed)))};
+
+        // Retry if the writer recycled the slot while we were reading it
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (anchorStart_.load(std::memory_order_relaxed) - lo > kMaxAnchors) {
+            continue;
+        }
+
+        if (position >= anchorPos) {
+            return stamp.advancedBy((position - anchorPos) / channels_, sampleRate_);
+        }
+        // Older than every anchor we keep: extrapolate backwards from the oldest
+        uint64_t frames = (anchorPos - position) / channels_;
+        auto offset = std::chrono::duration_cast<AudioTimestamp::Clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(frames) / sampleRate_));
+        return {stamp.frameIndex - std::min(frames, stamp.frameIndex), stamp.captureTime - offset};
+    }
+}
+
+size_t AudioBroadcastBuffer::read(ReaderId id, int16_t* buffer, size_t count) {
+    Reader& reader = readers_[id];
+    uint64_t pos = validPosition(reader);
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    size_t toRead = static_cast<size_t>(std::min<uint64_t>(count, tail - pos));
+    recordLag(reader, pos, tail);
+
+    size_t offset = pos & mask_;
+    size_t first = std::min(toRead, capacity_ - offset);
+    std::memcpy(buffer, buffer_.data() + offset, first * sizeof(int16_t));
+    std::memcpy(buffer + first, buffer_.data(), (toRead - first) * sizeof(int16_t));
+
+    // The writer may have lapped us while we were copying
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t writeStart = writeStart_.load(std::memory_order_relaxed);
+    if (writeStart > pos + capacity_) {
+        uint64_t oldest = writeStart - capacity_;
+        recordOverrun(reader, pos, oldest);
+        reader.position.store(oldest, std::memory_order_release);
+        return 0;
+    }
+
+    reader.position.store(pos + toRead, std::memory_order_release);
+    progressSignal_.notify(pos + toRead);
+    return toRead;
+}
+
+std::span<const int16_t> AudioBroadcastBuffer::peek(ReaderId id, size_t count) {
+    Reader& reader = readers_[id];
+    uint64_t pos = validPosition(reader);
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    recordLag(reader, pos, tail);
+    size_t offset = pos & mask_;
+    size_t n = static_cast<size_t>(std::min<uint64_t>({count, tail - pos, capacity_ - offset}));
+    return {buffer_.data() + offset, n};
+}
+
+bool AudioBroadcastBuffer::consume(ReaderId id, size_t count) {
+    Reader& reader = readers_[id];
+    uint64_t pos = reader.position.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t writeStart = writeStart_.load(std::memory_order_relaxed);
+    if (writeStart > pos + capacity_) {
+        uint64_t oldest = writeStart - capacity_;
+        recordOverrun(reader, pos, oldest);
+        reader.position.store(oldest, std::memory_order_release);
+        return false;
+    }
+
+    reader.position.store(pos + count, std::memory_order_release);
+    progressSignal_.notify(pos + count);
+    return true;
+}
+
+void AudioBroadcastBuffer::seek(ReaderId id, uint64_t position) {
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    uint64_t oldest = tail > capacity_ ? tail - capacity_ : 0;
+    position = std::clamp(position, oldest, tail);
+    readers_[id].position.store(position, std::memory_order_release);
+    progressSignal_.notify(position);
+}
+
+void AudioBroadcastBuffer::seekToLatest(ReaderId id) {
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    readers_[id].position.store(tail, std::memory_order_release);
+    progressSignal_.notify(tail);
+}
+
+bool AudioBroadcastBuffer::waitForAvailable(ReaderId id, size_t count, std::chrono::milliseconds timeout) {
+    if (available(id) >= count) {
+        return true;
+    }
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    uint64_t target = tail - available(id) + count;
+    return dataSignal_.wait(target, [this, id, count]() { return available(id) >= count; }, timeout);
+}
+
+bool AudioBroadcastBuffer::waitForReader(ReaderId id, size_t maxLag, std::chrono::milliseconds timeout) {
+    auto caughtUp = [this, id, maxLag]() { return available(id) <= maxLag; };
+    if (caughtUp()) {
+        return true;
+    }
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    uint64_t target = tail > maxLag ? tail - maxLag : 0;
+    return progressSignal_.wait(target, caughtUp, timeout);
+}
+
+size_t AudioBroadcastBuffer::available(ReaderId id) const {
+    uint64_t pos = readers_[id].position.load(std::memory_order_acquire);
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    uint64_t oldest = tail > capacity_ ? tail - capacity_ : 0;
+    return static_cast<size_t>(tail - std::max(pos, oldest));
+}
+
+AudioBroadcastBuffer::ReaderStats AudioBroadcastBuffer::getReaderStats(ReaderId id) const {
+    const Reader& reader = readers_[id];
+    ReaderStats stats;
+    {
+        std::lock_guard<std::mutex> lock(readersMutex_);
+        stats.name = reader.name;
+    }
+    uint64_t pos = reader.position.load(std::memory_order_acquire);
+    stats.lagSamples = static_cast<size_t>(tail_.load(std::memory_order_acquire) - pos);
+    stats.overruns = reader.overruns.load(std::memory_order_relaxed);
+    stats.droppedSamples = reader.droppedSamples.load(std::memory_order_relaxed);
+    stats.maxLagSamples = reader.maxLag.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::vector<AudioBroadcastBuffer::ReaderStats> AudioBroadcastBuffer::getAllReaderStats() const {
+    std::vector<ReaderStats> all;
+    for (ReaderId id = 0; id < kMaxReaders; ++id) {
+        if (readers_[id].active.load(std::memory_order_acquire)) {
+            all.push_back(getReaderStats(id));
+        }
+    }
+    return all;
+}
+
+uint64_t AudioBroadcastBuffer::validPosition(Reader& reader) {
+    uint64_t pos = reader.position.load(std::memory_order_relaxed);
+    uint64_t writeStart = writeStart_.load(std::memory_order_acquire);
+    if (writeStart > pos + capacity_) {
+        uint64_t oldest = writeStart - capacity_;
+        recordOverrun(reader, pos, oldest);
+        reader.position.store(oldest, std::memory_order_release);
+        return oldest;
+    }
+    return pos;
+}
+
+void AudioBroadcastBuffer::recordOverrun(Reader& reader, uint64_t from, uint64_t to) {
+    reader.overruns.fetch_add(1, std::memory_order_relaxed);
+    reader.droppedSamples.fetch_add(to - from, std::memory_order_relaxed);
+}
+
+void AudioBroadcastBuffer::recordLag(Reader& reader, uint64_t pos, uint64_t tail) {
+    // Only the reader's own thread updates its high-water mark
+    size_t lag = static_cast<size_t>(tail - pos);
+    if (lag > reader.maxLag.load(std::memory_order_relaxed)) {
+        reader.maxLag.store(lag, std::memory_order_relaxed);
+    }
+}
+
+} // namespace jarvis
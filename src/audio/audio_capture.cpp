@@ -1,126 +1,376 @@
 #include "audio/audio_capture.h"
+#include "audio/audio_player.h"
+#include "audio/realtime_capture_queue.h"
 #include <portaudio.h>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <thread>
 
 namespace jarvis {
 
+// Real-time queue depth in seconds of audio
+static constexpr int kCaptureQueueSeconds = 2;
+
 class AudioCapture::AudioCaptureImpl {
 public:
     PaStream* stream_ = nullptr;
-    AudioCapture::AudioCallback callback_;
-    bool running_ = false;
+    bool paInitialized_ = false;
+    AudioCapture::TimedAudioCallback callback_;
+    std::atomic<bool> running_{false};
     int sampleRate_ = 16000;
     int channels_ = 1;
     int framesPerBuffer_ = 1024;
+    CaptureMode mode_ = CaptureMode::RealTimeSafe;
+
+    // RealTimeSafe mode: device callback -> queue -> delivery thread
+    std::unique_ptr<RealTimeCaptureQueue> queue_;
+    std::thread deliveryThread_;
+    std::atomic<bool> delivering_{false};
+    std::vector<int16_t> block_;
+
+    // Direct mode reuses one block; the callback still runs on the device thread
+    std::vector<int16_t> directBlock_;
+    std::atomic<uint64_t> directOverflows_{0};
+    uint64_t directFrames_ = 0;
+
+    // Non-device source, clocked by its own thread
+    std::unique_ptr<AudioSource> source_;
+    SourcePacing pacing_ = SourcePacing::RealTime;
+    std::thread sourceThread_;
+    std::atomic<bool> sourceRunning_{false};
+
+    // Full-duplex output; sources render into a scratch buffer to keep its clock running
+    AudioPlayer* player_ = nullptr;
+    std::vector<int16_t> playerScratch_;
+
+    static int portAudioCallback(const void* input,
+                                 void* output,
+                                 unsigned long frameCount,
+                                 const PaStreamCallbackTimeInfo* timeInfo,
+                                 PaStreamCallbackFlags statusFlags,
+                                 void* userData);
+
+    void processAudioData(const int16_t* input, unsigned long frameCount,
+                          PaStreamCallbackFlags statusFlags,
+                          AudioTimestamp::Clock::time_point captureTime);
+    void deliveryLoop();
+    void stopDelivery();
+    void sourceLoop();
 };
 
 AudioCapture::AudioCapture() : impl_(std::make_unique<AudioCaptureImpl>()) {}
-AudioCapture::~AudioCapture() = default;
+
+AudioCapture::~AudioCapture() {
+    stopCapture();
+}
 
 bool AudioCapture::initialize(int sampleRate, int channels, int framesPerBuffer) {
+    impl_->framesPerBuffer_ = framesPerBuffer;
+    if (impl_->source_) {
+        // The source defines the format and no device is needed
+        return true;
+    }
+
     PaError err = Pa_Initialize();
     if (err != paNoError) {
         std::cerr << "PortAudio initialization failed: " << Pa_GetErrorText(err) << std::endl;
         return false;
     }
-    
+    impl_->paInitialized_ = true;
+
     impl_->sampleRate_ = sampleRate;
     impl_->channels_ = channels;
-    impl_->framesPerBuffer_ = framesPerBuffer;
-    
+
     return true;
 }
 
+void AudioCapture::setSource(std::unique_ptr<AudioSource> source, SourcePacing pacing) {
+    if (source) {
+        impl_->sampleRate_ = source->getSampleRate();
+        impl_->channels_ = source->getChannels();
+    }
+    impl_->source_ = std::move(source);
+    impl_->pacing_ = pacing;
+}
+
+void AudioCapture::attachPlayer(AudioPlayer* player) {
+    if (impl_->player_) {
+        impl_->player_->setAttached(false);
+    }
+    impl_->player_ = player;
+    if (player) {
+        player->setAttached(true);
+    }
+}
+
+void AudioCapture::setCaptureMode(CaptureMode mode) {
+    impl_->mode_ = mode;
+}
+
 void AudioCapture::startCapture(AudioCallback callback) {
+    if (!callback) {
+        startCapture(TimedAudioCallback());
+        return;
+    }
+    startCapture([callback](const std::vector<int16_t>& audio, const AudioTimestamp&) {
+        callback(audio);
+    });
+}
+
+void AudioCapture::startCapture(TimedAudioCallback callback) {
     impl_->callback_ = callback;
-    
+    impl_->directFrames_ = 0;
+
+    // Everything the device callback touches is allocated up front
+    size_t blockSamples = static_cast<size_t>(impl_->framesPerBuffer_) * impl_->channels_;
+    bool freeRunning = impl_->source_ && impl_->pacing_ == SourcePacing::FreeRun;
+    if (impl_->mode_ == CaptureMode::RealTimeSafe && !freeRunning) {
+        impl_->queue_ = std::make_unique<RealTimeCaptureQueue>(
+            static_cast<size_t>(impl_->sampleRate_) * impl_->channels_ * kCaptureQueueSeconds,
+            impl_->channels_, impl_->sampleRate_);
+        impl_->block_.assign(blockSamples, 0);
+        impl_->delivering_ = true;
+        impl_->deliveryThread_ = std::thread(&AudioCaptureImpl::deliveryLoop, impl_.get());
+    } else {
+        impl_->directBlock_.reserve(blockSamples);
+    }
+
+    if (impl_->player_) {
+        impl_->playerScratch_.assign(
+            static_cast<size_t>(impl_->framesPerBuffer_) * impl_->player_->getChannels(), 0);
+    }
+
+    if (impl_->source_) {
+        impl_->running_ = true;
+        impl_->sourceRunning_ = true;
+        impl_->sourceThread_ = std::thread(&AudioCaptureImpl::sourceLoop, impl_.get());
+        return;
+    }
+
     PaStreamParameters inputParameters;
     inputParameters.device = Pa_GetDefaultInputDevice();
     inputParameters.channelCount = impl_->channels_;
     inputParameters.sampleFormat = paInt16;
     inputParameters.suggestedLatency = Pa_GetDeviceInfo(inputParameters.device)->defaultLowInputLatency;
     inputParameters.hostApiSpecificStreamInfo = nullptr;
-    
+
+    // Full duplex: the player's output shares this stream and its clock
+    PaStreamParameters outputParameters;
+    if (impl_->player_) {
+        outputParameters.device = Pa_GetDefaultOutputDevice();
+        outputParameters.channelCount = impl_->player_->getChannels();
+        outputParameters.sampleFormat = paInt16;
+        outputParameters.suggestedLatency = Pa_GetDeviceInfo(outputParameters.device)->defaultLowOutputLatency;
+        outputParameters.hostApiSpecificStreamInfo = nullptr;
+    }
+
     PaError err = Pa_OpenStream(
         &impl_->stream_,
         &inputParameters,
-        nullptr,
+        impl_->player_ ? &outputParameters : nullptr,
         impl_->sampleRate_,
         impl_->framesPerBuffer_,
         paClipOff,
-        portAudioCallback,
-        this
+        &AudioCaptureImpl::portAudioCallback,
+        impl_.get()
     );
-    
+
     if (err != paNoError) {
         std::cerr << "Failed to open audio stream: " << Pa_GetErrorText(err) << std::endl;
+        impl_->stream_ = nullptr;
+        impl_->stopDelivery();
         return;
     }
-    
+
     err = Pa_StartStream(impl_->stream_);
     if (err != paNoError) {
         std::cerr << "Failed to start audio stream: " << Pa_GetErrorText(err) << std::endl;
+        Pa_CloseStream(impl_->stream_);
+        impl_->stream_ = nullptr;
+        impl_->stopDelivery();
         return;
     }
-    
+
     impl_->running_ = true;
 }
 
 void AudioCapture::stopCapture() {
-    if (impl_->running_ && impl_->stream_) {
-        PaError err = Pa_StopStream(impl_->stream_);
-        if (err != paNoError) {
-            std::cerr << "Failed to stop audio stream: " << Pa_GetErrorText(err) << std::endl;
+    if (impl_->sourceRunning_.exchange(false) || impl_->sourceThread_.joinable()) {
+        impl_->sourceThread_.join();
+        impl_->running_ = false;
+    }
+
+    if (impl_->stream_) {
+        if (impl_->running_) {
+            PaError err = Pa_StopStream(impl_->stream_);
+            if (err != paNoError) {
+                std::cerr << "Failed to stop audio stream: " << Pa_GetErrorText(err) << std::endl;
+            }
         }
-        
-        err = Pa_CloseStream(impl_->stream_);
+
+        PaError err = Pa_CloseStream(impl_->stream_);
         if (err != paNoError) {
             std::cerr << "Failed to close audio stream: " << Pa_GetErrorText(err) << std::endl;
         }
-        
+
         impl_->stream_ = nullptr;
         impl_->running_ = false;
     }
-    
-    Pa_Terminate();
+
+    // The device callback has stopped; now retire the delivery thread
+    impl_->stopDelivery();
+
+    if (impl_->paInitialized_) {
+        Pa_Terminate();
+        impl_->paInitialized_ = false;
+    }
 }
 
-int AudioCapture::portAudioCallback(const void* input, void* output,
-                                  unsigned long frameCount,
-                                  const void* timeInfo,
-                                  void* statusFlags,
-                                  void* userData) {
-    auto* capture = static_cast<AudioCapture*>(userData);
-    capture->processAudioData(static_cast<const int16_t*>(input), frameCount);
+int AudioCapture::AudioCaptureImpl::portAudioCallback(const void* input, void* output,
+                                                     unsigned long frameCount,
+                                                     const PaStreamCallbackTimeInfo* timeInfo,
+                                                     PaStreamCallbackFlags statusFlags,
+                                                     void* userData) {
+    auto* impl = static_cast<AudioCaptureImpl*>(userData);
+    // Output first: whoever receives this input may look up what was played alongside it
+    if (output && impl->player_) {
+        auto dacTime = AudioTimestamp::Clock::now();
+        if (timeInfo && timeInfo->outputBufferDacTime > timeInfo->currentTime) {
+            dacTime += std::chrono::duration_cast<AudioTimestamp::Clock::duration>(
+                std::chrono::duration<double>(timeInfo->outputBufferDacTime - timeInfo->currentTime));
+        }
+        impl->player_->render(static_cast<int16_t*>(output), frameCount, dacTime);
+    }
+    if (input) {
+        // Back-date "now" by how long ago the device sampled the first frame
+        auto captureTime = AudioTimestamp::Clock::now();
+        if (timeInfo && timeInfo->inputBufferAdcTime > 0.0 &&
+            timeInfo->currentTime > timeInfo->inputBufferAdcTime) {
+            captureTime -= std::chrono::duration_cast<AudioTimestamp::Clock::duration>(
+                std::chrono::duration<double>(timeInfo->currentTime - timeInfo->inputBufferAdcTime));
+        }
+        impl->processAudioData(static_cast<const int16_t*>(input), frameCount, statusFlags, captureTime);
+    }
     return paContinue;
 }
 
-void AudioCapture::processAudioData(const int16_t* input, unsigned long frameCount) {
-    if (impl_->callback_) {
-        std::vector<int16_t> audioData(input, input + frameCount * impl_->channels_);
-        impl_->callback_(audioData);
+void AudioCapture::AudioCaptureImpl::processAudioData(const int16_t* input, unsigned long frameCount,
+                                                      PaStreamCallbackFlags statusFlags,
+                                                      AudioTimestamp::Clock::time_point captureTime) {
+    size_t samples = static_cast<size_t>(frameCount) * channels_;
+
+    if (mode_ == CaptureMode::RealTimeSafe) {
+        // No allocation, locks or logging on this thread
+        if (statusFlags & paInputOverflow) {
+            queue_->recordDeviceOverflow();
+        }
+        queue_->push(input, samples, captureTime);
+        return;
+    }
+
+    if (statusFlags & paInputOverflow) {
+        directOverflows_.fetch_add(1, std::memory_order_relaxed);
+    }
+    AudioTimestamp stamp{directFrames_, captureTime};
+    directFrames_ += frameCount;
+    if (callback_) {
+        directBlock_.assign(input, input + samples);
+        callback_(directBlock_, stamp);
+    }
+}
+
+void AudioCapture::AudioCaptureImpl::deliveryLoop() {
+    while (delivering_) {
+        if (!queue_->waitForData(std::chrono::milliseconds(100))) {
+            continue;
+        }
+
+        // Deliver whole device-sized blocks from the reused buffer
+        AudioTimestamp stamp;
+        while (queue_->available() >= block_.size()) {
+            queue_->pop(block_.data(), block_.size(), &stamp);
+            if (callback_) {
+                callback_(block_, stamp);
+            }
+        }
+    }
+}
+
+void AudioCapture::AudioCaptureImpl::sourceLoop() {
+    std::vector<int16_t> block(static_cast<size_t>(framesPerBuffer_) * channels_);
+    auto blockDuration = std::chrono::duration<double>(
+        static_cast<double>(framesPerBuffer_) / sampleRate_);
+    auto nextBlock = std::chrono::steady_clock::now();
+    uint64_t frameIndex = 0;
+
+    while (sourceRunning_) {
+        size_t frames = source_->read(block.data(), framesPerBuffer_);
+        if (frames == 0) {
+            break;
+        }
+        // Keep blocks uniform; the tail of the last one is silence
+        std::fill(block.begin() + frames * channels_, block.end(), 0);
+
+        if (pacing_ == SourcePacing::FreeRun) {
+            // Backpressure comes from the callback itself; the block is "captured" now
+            auto now = std::chrono::steady_clock::now();
+            if (player_) {
+                player_->render(playerScratch_.data(), framesPerBuffer_, now);
+            }
+            if (callback_) {
+                callback_(block, AudioTimestamp{frameIndex, now});
+            }
+            frameIndex += framesPerBuffer_;
+            continue;
+        }
+
+        // Stamped as captured the moment it is delivered, i.e. zero input latency;
+        // rendered first, as the device callback does
+        if (player_) {
+            player_->render(playerScratch_.data(), framesPerBuffer_, nextBlock);
+        }
+        processAudioData(block.data(), framesPerBuffer_, 0, nextBlock);
+        nextBlock += std::chrono::duration_cast<std::chrono::steady_clock::duration>(blockDuration);
+        std::this_thread::sleep_until(nextBlock);
+    }
+
+    // Report the end only after the delivery thread has handed everything on
+    while (sourceRunning_ && queue_ && delivering_ && queue_->available() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    running_ = false;
+}
+
+void AudioCapture::AudioCaptureImpl::stopDelivery() {
+    if (!delivering_) return;
+
+    delivering_ = false;
+    queue_->interrupt();
+    if (deliveryThread_.joinable()) {
+        deliveryThread_.join();
     }
 }
 
 std::vector<std::string> AudioCapture::getAudioDevices() {
     std::vector<std::string> devices;
-    
+
     Pa_Initialize();
-    
+
     int numDevices = Pa_GetDeviceCount();
     if (numDevices < 0) {
         std::cerr << "Error getting device count: " << Pa_GetErrorText(numDevices) << std::endl;
         Pa_Terminate();
         return devices;
     }
-    
+
     for (int i = 0; i < numDevices; i++) {
         const PaDeviceInfo* deviceInfo = Pa_GetDeviceInfo(i);
         if (deviceInfo && deviceInfo->maxInputChannels > 0) {
             devices.emplace_back(deviceInfo->name);
         }
     }
-    
+
     Pa_Terminate();
     return devices;
 }
@@ -129,4 +379,17 @@ int AudioCapture::getSampleRate() const { return impl_->sampleRate_; }
 int AudioCapture::getChannels() const { return impl_->channels_; }
 bool AudioCapture::isRunning() const { return impl_->running_; }
 
+uint64_t AudioCapture::getDroppedSamples() const {
+    return impl_->queue_ ? impl_->queue_->droppedSamples() : 0;
+}
+
+AudioRingBuffer::Stats AudioCapture::getBufferStats() const {
+    return impl_->queue_ ? impl_->queue_->stats() : AudioRingBuffer::Stats{};
+}
+
+uint64_t AudioCapture::getInputOverflows() const {
+    return impl_->queue_ ? impl_->queue_->deviceOverflows()
+                         : impl_->directOverflows_.load(std::memory_order_relaxed);
+}
+
 } // namespace jarvis
@@ -0,0 +1,84 @@
+#include "audio/audio_front_end.h"
+#include "dsp/kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace jarvis {
+
+namespace {
+
+// Below this the blocker's state is inaudible; zero it rather than decay into denormals
+constexpr float kDenormalFloor = 1e-20f;
+
+} // namespace
+
+AudioFrontEnd::AudioFrontEnd(int inputRate, size_t maxFrames, int outputRate)
+    : inputRate_(inputRate), outputRate_(outputRate), resampler_(inputRate, outputRate, 1) {
+    setDcRemoval(true);
+    reserve(resampler_.maxOutputFrames(maxFrames));
+}
+
+size_t AudioFrontEnd::process(std::span<const int16_t> input, const AudioTimestamp& stamp) {
+    reserve(resampler_.maxOutputFrames(input.size()));
+    frames_ = resampler_.resample(input, pcm_);
+
+    // Where the first output falls relative to this block's first input:
+    // outputFrames_ scaled to the input rate, less the filter delay
+    double offset = static_cast<double>(outputFrames_) * inputRate_ / outputRate_ -
+                    resampler_.getLatencyFrames() - static_cast<double>(inputFrames_);
+    // Output frames so far, plus any capture frames dropped before this block
+    uint64_t dropped = stamp.frameIndex - std::min(stamp.frameIndex, inputFrames_);
+    stamp_.frameIndex = outputFrames_ + dropped * outputRate_ / inputRate_;
+    stamp_.captureTime = stamp.captureTime + std::chrono::duration_cast<AudioTimestamp::Clock::duration>(
+                                                 std::chrono::duration<double>(offset / inputRate_));
+    inputFrames_ += input.size();
+    outputFrames_ += frames_;
+
+    dsp::int16ToFloat(pcm_.data(), samples_.data(), frames_);
+    if (!dcRemoval_) {
+        return frames_;
+    }
+
+    // The highpass recursion is inherently serial; the conversions either side are vectorized
+    float x1 = lastInput_;
+    float y1 = lastOutput_;
+    for (size_t i = 0; i < frames_; ++i) {
+        float x = samples_[i];
+        float y = x - x1 + pole_ * y1;
+        x1 = x;
+        y1 = y;
+        samples_[i] = y;
+    }
+    lastInput_ = x1;
+    lastOutput_ = std::abs(y1) < kDenormalFloor ? 0.0f : y1;
+    dsp::floatToInt16(samples_.data(), pcm_.data(), frames_);
+    return frames_;
+}
+
+void AudioFrontEnd::setDcRemoval(bool enabled, double cutoffHz) {
+    dcRemoval_ = enabled;
+    pole_ = static_cast<float>(std::clamp(1.0 - 2.0 * std::numbers::pi * cutoffHz / outputRate_, 0.0, 1.0));
+    lastInput_ = 0.0f;
+    lastOutput_ = 0.0f;
+}
+
+void AudioFrontEnd::reset() {
+    resampler_.reset();
+    frames_ = 0;
+    stamp_ = {};
+    inputFrames_ = 0;
+    outputFrames_ = 0;
+    lastInput_ = 0.0f;
+    lastOutput_ = 0.0f;
+}
+
+void AudioFrontEnd::reserve(size_t frames) {
+    if (frames <= pcm_.size()) {
+        return;
+    }
+    pcm_.resize(frames);
+    samples_.resize(frames);
+}
+
+} // namespace jarvis
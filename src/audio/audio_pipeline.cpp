@@ -1,8 +1,9 @@
 #include "audio/audio_pipeline.h"
 #include "audio/audio_capture.h"
-#include "speech/wake_word_detector.h"
+#include "audio/audio_player.h"
 #include "speech/speech_recognizer.h"
 #include "speech/text_to_speech.h"
+#include "utils/config_manager.h"
 #include "utils/logger.h"
 #include <algorithm>
 #include <cmath>
@@ -10,170 +11,194 @@
 
 namespace jarvis {
 
-// AudioRingBuffer implementation
-AudioRingBuffer::AudioRingBuffer(size_t capacity)
-    : capacity_(capacity + 1), buffer_(capacity + 1) {
-}
+// Upper bound on a blocking wait; workers are normally woken by data or state changes
+static constexpr std::chrono::milliseconds kAudioWaitTimeout{500};
 
-AudioRingBuffer::~AudioRingBuffer() = default;
+// How far a free-running source may get ahead of the active consumer, in seconds
+static constexpr int kFreeRunLeadSeconds = 1;
 
-bool AudioRingBuffer::write(const int16_t* data, size_t count) {
-    size_t free = freeSpace();
-    if (count > free) {
-        return false; // Buffer overflow
-    }
+// Playback kept for the echo canceller; covers capture delivered up to this late
+static constexpr int kReferenceHistorySeconds = 4;
 
-    size_t tail = tail_.load(std::memory_order_relaxed);
-    for (size_t i = 0; i < count; ++i) {
-        buffer_[tail] = data[i];
-        tail = (tail + 1) % capacity_;
-    }
-    tail_.store(tail, std::memory_order_release);
-    return true;
+// AudioPipeline implementation
+AudioPipeline::AudioPipeline() = default;
+
+AudioPipeline::~AudioPipeline() {
+    stop();
 }
 
-size_t AudioRingBuffer::read(int16_t* buffer, size_t count) {
-    size_t avail = available();
-    size_t toRead = std::min(count, avail);
+bool AudioPipeline::initialize(int sampleRate, int channels, int frameSize) {
+    sampleRate_ = sampleRate;
+    channels_ = channels;
+    frameSize_ = frameSize;
     
-    size_t head = head_.load(std::memory_order_relaxed);
-    for (size_t i = 0; i < toRead; ++i) {
-        buffer[i] = buffer_[head];
-        head = (head + 1) % capacity_;
+    // Initialize components
+    audioCapture_ = std::make_unique<AudioCapture>();
+    if (audioSource_) {
+        audioCapture_->setSource(std::move(audioSource_), sourcePacing_);
+    }
+    if (!audioCapture_->initialize(sampleRate, channels, frameSize)) {
+        LOG_ERROR("Failed to initialize audio capture");
+        return false;
     }
-    head_.store(head, std::memory_order_release);
-    return toRead;
-}
-
-size_t AudioRingBuffer::available() const {
-    size_t head = head_.load(std::memory_order_acquire);
-    size_t tail = tail_.load(std::memory_order_acquire);
-    return (tail + capacity_ - head) % capacity_;
-}
 
-size_t AudioRingBuffer::freeSpace() const {
-    return capacity_ - available() - 1;
-}
+    // A source dictates its own format
+    sampleRate_ = sampleRate = audioCapture_->getSampleRate();
+    channels_ = channels = audioCapture_->getChannels();
+
+    // Playback runs off the capture stream so output and input share one clock
+    audioPlayer_ = std::make_unique<AudioPlayer>();
+    audioPlayer_->initialize(sampleRate, 1, frameSize);
+    audioPlayer_->setPositionCallback([this](const PlaybackEvent& event) {
+        if (event.type == PlaybackEvent::Type::Started) {
+            reportPlaybackStarted(event.time);
+        } else if (event.type != PlaybackEvent::Type::Progress) {
+            // The TTS thread holds SPEAKING until the player goes quiet
+            { std::lock_guard<std::mutex> lock(stateMutex_); }
+            stateCV_.notify_all();
+        }
+    });
+    audioCapture_->attachPlayer(audioPlayer_.get());
 
-void AudioRingBuffer::clear() {
-    head_.store(0, std::memory_order_relaxed);
-    tail_.store(0, std::memory_order_relaxed);
-}
+    // The detector is fed from the bus; it opens no device of its own
+    wakeWordDetector_ = std::make_unique<WakeWordDetector>();
+    if (wakeWordSensitivity_ >= 0.0f && !wakeSettings_.keywords.empty()) {
+        wakeSettings_.keywords.front().sensitivity = wakeWordSensitivity_;
+    }
+    wakeWordReady_ = wakeWordDetector_->initialize(wakeSettings_);
+    if (!wakeWordReady_) {
+        LOG_WARNING("Wake word detector unavailable; the pipeline will not wake");
+    }
+    speechRecognizer_ = std::make_unique<SpeechRecognizer>();
+    sttReady_ = speechRecognizer_->initialize(sttModelPath_, AudioFrontEnd::kProcessingRate);
+    if (!sttReady_) {
+        LOG_WARNING("Speech recognizer unavailable; turns will end on the VAD alone");
+    }
+    textToSpeech_ = std::make_unique<TextToSpeech>();
+    
+    // Responses are rendered to PCM and played by the capture's player, not on eSpeak's own device
+    textToSpeech_->setRenderOnly(true);
+    if (!textToSpeech_->initialize()) {
+        LOG_WARNING("Text-to-speech unavailable; responses will not be spoken");
+    }
 
-// AudioResampler implementation
-AudioResampler::AudioResampler(int inputRate, int outputRate, int channels)
-    : inputRate_(inputRate), outputRate_(outputRate), channels_(channels), 
-      ratio_(static_cast<double>(outputRate) / inputRate), accumulator_(0.0) {
-}
+    // Consumers all work on mono; the mixer keeps the individual channels for those that don't
+    channelMixer_ = std::make_unique<ChannelMixer>(channels, frameSize);
+    if (!downmixWeights_.empty() && !channelMixer_->setWeights(downmixWeights_)) {
+        LOG_WARNING("Ignoring downmix weights: expected " + std::to_string(channels) + ", got " +
+                    std::to_string(downmixWeights_.size()));
+    }
 
-AudioResampler::~AudioResampler() = default;
+    frontEnd_ = std::make_unique<AudioFrontEnd>(sampleRate, frameSize);
 
-std::vector<int16_t> AudioResampler::resample(const int16_t* input, size_t inputFrames) {
-    if (inputRate_ == outputRate_) {
-        return std::vector<int16_t>(input, input + inputFrames);
+    // The player's output is the echo reference; it shares the capture's device frames
+    if (echoCancellationEnabled_) {
+        echoCanceller_ = std::make_unique<EchoCanceller>(AudioFrontEnd::kProcessingRate, echoParams_);
+        referenceFrontEnd_ = std::make_unique<AudioFrontEnd>(sampleRate, frameSize);
+        playbackHistory_ = audioPlayer_->enableOutputHistory(static_cast<size_t>(sampleRate) * kReferenceHistorySeconds);
+        referenceReader_ = playbackHistory_->addReader("echo_reference");
+        referenceBlock_.assign(frameSize, 0);
+    } else {
+        echoCanceller_.reset();
+        referenceFrontEnd_.reset();
+        playbackHistory_ = nullptr;
+        referenceReader_ = AudioBroadcastBuffer::kInvalidReader;
     }
 
-    size_t outputFrames = static_cast<size_t>(inputFrames * ratio_);
-    std::vector<int16_t> output(outputFrames);
-
-    for (size_t i = 0; i < outputFrames; ++i) {
-        double inputIndex = static_cast<double>(i) / ratio_;
-        size_t index = static_cast<size_t>(inputIndex);
-        double fraction = inputIndex - index;
+    // Initialize audio bus shared by all consumers; it doubles as the lookback history
+    audioBus_ = std::make_unique<AudioBroadcastBuffer>(
+        static_cast<size_t>(AudioFrontEnd::kProcessingRate) * historySeconds_, AudioFrontEnd::kProcessingRate, 1);
+    wakeWordReader_ = audioBus_->addReader("wake_word");
+    sttReader_ = audioBus_->addReader("stt");
 
-        if (index + 1 < inputFrames) {
-            // Linear interpolation
-            output[i] = static_cast<int16_t>(
-                input[index] * (1.0 - fraction) + input[index + 1] * fraction
-            );
-        } else {
-            output[i] = input[index];
-        }
+    if (wakeGateEnabled_) {
+        wakeGate_ = std::make_unique<ActivityGate>(AudioFrontEnd::kProcessingRate, wakeGateParams_);
+    } else {
+        wakeGate_.reset();
     }
 
-    return output;
-}
+    spectralFeatures_ = std::make_unique<SpectralFeatures>(AudioFrontEnd::kProcessingRate, featureParams_);
 
-void AudioResampler::reset() {
-    accumulator_ = 0.0;
-}
+    // Initialize VAD on the shared spectra
+    vad_ = std::make_unique<VoiceActivityDetector>(AudioFrontEnd::kProcessingRate, vadParams_);
+    vad_->useSharedSpectrum(*spectralFeatures_);
 
-// VoiceActivityDetector implementation
-VoiceActivityDetector::VoiceActivityDetector(int sampleRate, int frameSize)
-    : sampleRate_(sampleRate), frameSize_(frameSize), threshold_(0.01f),
-      silenceTimeoutMs_(2000), silentFrames_(0), voiceDetected_(false) {
+    return true;
 }
 
-VoiceActivityDetector::~VoiceActivityDetector() = default;
-
-bool VoiceActivityDetector::processFrame(const int16_t* frame, size_t frameSize) {
-    // Calculate RMS energy
-    double sum = 0.0;
-    for (size_t i = 0; i < frameSize; ++i) {
-        double sample = static_cast<double>(frame[i]) / 32768.0;
-        sum += sample * sample;
+void AudioPipeline::configure(ConfigManager& config) {
+    historySeconds_ = std::max(1, config.getInt("audio.history_seconds", historySeconds_));
+    preRollMs_ = std::max(0, config.getInt("speech_recognition.pre_roll_ms", preRollMs_));
+    sttModelPath_ = config.getString("speech_recognition.model_path", sttModelPath_);
+
+    // A single wake word is a one-keyword list, so the engine setting applies to it too
+    wakeSettings_ = WakeWordDetector::readSettings(config);
+
+    ActivityGate::Params& gate = wakeGateParams_;
+    wakeGateEnabled_ = config.getBool("wake_word.activity_gate.enabled", wakeGateEnabled_);
+    gate.minRms = config.getFloat("wake_word.activity_gate.min_rms", gate.minRms);
+    gate.openMarginDb = config.getFloat("wake_word.activity_gate.open_margin_db", gate.openMarginDb);
+    gate.holdMs = config.getInt("wake_word.activity_gate.hold_ms", gate.holdMs);
+    gate.lookbackMs = config.getInt("wake_word.activity_gate.lookback_ms", gate.lookbackMs);
+    gate.floorRiseDbPerSecond =
+        config.getFloat("wake_word.activity_gate.floor_rise_db_per_second", gate.floorRiseDbPerSecond);
+
+    EchoCanceller::Params& echo = echoParams_;
+    echoCancellationEnabled_ = config.getBool("echo_cancellation.enabled", echoCancellationEnabled_);
+    echo.filterMs = config.getInt("echo_cancellation.filter_ms", echo.filterMs);
+    echo.delayMs = config.getInt("echo_cancellation.delay_ms", echo.delayMs);
+    echo.stepSize = config.getFloat("echo_cancellation.step_size", echo.stepSize);
+    echo.minReferenceRms = config.getFloat("echo_cancellation.min_reference_rms", echo.minReferenceRms);
+    bargeInEnabled_ = config.getBool("wake_word.barge_in", bargeInEnabled_);
+
+    SpectralFeatures::Params& features = featureParams_;
+    features.windowMs = config.getInt("features.window_ms", features.windowMs);
+    features.hopMs = config.getInt("features.hop_ms", features.hopMs);
+    features.mels = config.getInt("features.mels", features.mels);
+    features.minFrequency = config.getFloat("features.min_frequency", features.minFrequency);
+    features.maxFrequency = config.getFloat("features.max_frequency", features.maxFrequency);
+    features.historyMs = config.getInt("features.history_ms", features.historyMs);
+
+    VoiceActivityDetector::Params& vad = vadParams_;
+    vad.minRms = config.getFloat("vad.min_rms", vad.minRms);
+    vad.speechThreshold = config.getFloat("vad.speech_threshold", vad.speechThreshold);
+    vad.frameMs = config.getInt("vad.frame_ms", vad.frameMs);
+    vad.bands = config.getInt("vad.bands", vad.bands);
+    vad.minFrequency = config.getFloat("vad.min_frequency", vad.minFrequency);
+    vad.maxFrequency = config.getFloat("vad.max_frequency", vad.maxFrequency);
+    vad.noiseWindowMs = config.getInt("vad.noise_window_ms", vad.noiseWindowMs);
+    vad.noiseBiasDb = config.getFloat("vad.noise_bias_db", vad.noiseBiasDb);
+    vad.snrWeight = config.getFloat("vad.snr_weight", vad.snrWeight);
+    vad.snrMidpointDb = config.getFloat("vad.snr_midpoint_db", vad.snrMidpointDb);
+    vad.flatnessWeight = config.getFloat("vad.flatness_weight", vad.flatnessWeight);
+    vad.flatnessMidpointDb = config.getFloat("vad.flatness_midpoint_db", vad.flatnessMidpointDb);
+    vad.zcrWeight = config.getFloat("vad.zcr_weight", vad.zcrWeight);
+    vad.zcrMidpoint = config.getFloat("vad.zcr_midpoint", vad.zcrMidpoint);
+    vad.smoothing = config.getFloat("vad.smoothing", vad.smoothing);
+    if (vad_) {
+        vad_->setParams(vadParams_);
     }
-    double rms = std::sqrt(sum / frameSize);
 
-    if (rms > threshold_) {
-        silentFrames_ = 0;
-        voiceDetected_ = true;
-        return true;
-    } else {
-        silentFrames_++;
-        
-        // Calculate silence duration
-        double silenceDuration = (silentFrames_ * frameSize) / static_cast<double>(sampleRate_) * 1000.0;
-        if (silenceDuration >= silenceTimeoutMs_) {
-            voiceDetected_ = false;
-            silentFrames_ = 0;
-            return false;
-        }
-        return voiceDetected_;
+    Endpointer::Params endpoint = endpointer_.getParams();
+    endpoint.minPauseMs = config.getInt("endpointing.min_pause_ms", endpoint.minPauseMs);
+    endpoint.maxPauseMs = config.getInt("endpointing.max_pause_ms", endpoint.maxPauseMs);
+    endpoint.partialStableMs = config.getInt("endpointing.partial_stable_ms", endpoint.partialStableMs);
+    endpoint.minUtteranceMs = config.getInt("endpointing.min_utterance_ms", endpoint.minUtteranceMs);
+    endpoint.maxUtteranceMs = config.getInt("endpointing.max_utterance_ms", endpoint.maxUtteranceMs);
+    endpoint.noSpeechTimeoutMs = config.getInt("endpointing.no_speech_timeout_ms", endpoint.noSpeechTimeoutMs);
+    setEndpointing(endpoint);
+
+    try {
+        const auto& weights = config.getConfig().at("audio").at("downmix_weights");
+        downmixWeights_ = weights.get<std::vector<float>>();
+    } catch (const std::exception&) {
+        // Not set: equal weights
     }
 }
 
-void VoiceActivityDetector::setThreshold(float threshold) {
-    threshold_ = threshold;
-}
-
-void VoiceActivityDetector::setSilenceTimeout(int ms) {
-    silenceTimeoutMs_ = ms;
-}
-
-// AudioPipeline implementation
-AudioPipeline::AudioPipeline() = default;
-
-AudioPipeline::~AudioPipeline() {
-    stop();
-}
-
-bool AudioPipeline::initialize(int sampleRate, int channels, int frameSize) {
-    sampleRate_ = sampleRate;
-    channels_ = channels;
-    frameSize_ = frameSize;
-    
-    // Initialize components
-    audioCapture_ = std::make_unique<AudioCapture>();
-    wakeWordDetector_ = std::make_unique<WakeWordDetector>();
-    speechRecognizer_ = std::make_unique<SpeechRecognizer>();
-    textToSpeech_ = std::make_unique<TextToSpeech>();
-
-    // Initialize audio buffers
-    rawAudioBuffer_ = std::make_unique<AudioRingBuffer>(sampleRate * 30); // 30 seconds buffer
-    wakeWordBuffer_ = std::make_unique<AudioRingBuffer>(sampleRate * 5);    // 5 seconds buffer
-    sttBuffer_ = std::make_unique<AudioRingBuffer>(sampleRate * 30);        // 30 seconds buffer
-
-    // Initialize resamplers
-    // Porcupine typically uses 16000 Hz
-    wakeWordResampler_ = std::make_unique<AudioResampler>(sampleRate, 16000, channels);
-    // Vosk uses 16000 Hz
-    sttResampler_ = std::make_unique<AudioResampler>(sampleRate, 16000, channels);
-
-    // Initialize VAD
-    vad_ = std::make_unique<VoiceActivityDetector>(16000, frameSize);
-
-    return true;
+void AudioPipeline::setAudioSource(std::unique_ptr<AudioSource> source, SourcePacing pacing) {
+    audioSource_ = std::move(source);
+    sourcePacing_ = pacing;
 }
 
 void AudioPipeline::start() {
@@ -182,8 +207,20 @@ void AudioPipeline::start() {
     running_ = true;
     state_ = PipelineState::IDLE;
     
+    // Capture frame 0 lines up with the next frame the player renders
+    if (echoCanceller_) {
+        echoCanceller_->reset();
+        referenceOrigin_ = playbackHistory_->writePosition();
+    }
+
     // Start threads
-    audioThread_ = std::thread(&AudioPipeline::audioCaptureLoop, this);
+    if (wakeWordReady_) {
+        wakeWordDetector_->startDetection(nullptr);
+    }
+    audioPlayer_->start();
+    audioCapture_->startCapture([this](const std::vector<int16_t>& block, const AudioTimestamp& stamp) {
+        onCapturedAudio(block, stamp);
+    });
     wakeWordThread_ = std::thread(&AudioPipeline::wakeWordLoop, this);
     sttThread_ = std::thread(&AudioPipeline::speechRecognitionLoop, this);
     ttsThread_ = std::thread(&AudioPipeline::ttsLoop, this);
@@ -192,15 +229,21 @@ void AudioPipeline::start() {
 void AudioPipeline::stop() {
     if (!running_) return;
     
-    running_ = false;
-    state_ = PipelineState::IDLE;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        running_ = false;
+        state_ = PipelineState::IDLE;
+    }
     
-    // Notify all threads
+    // Notify all threads, including those blocked on audio
     stateCV_.notify_all();
+    audioBus_->interrupt();
     
-    // Join threads
-    if (audioThread_.joinable()) audioThread_.join();
+    // Stop the producer first, then join the consumers
+    audioCapture_->stopCapture();
+    audioPlayer_->stop();
     if (wakeWordThread_.joinable()) wakeWordThread_.join();
+    wakeWordDetector_->stopDetection();
     if (sttThread_.joinable()) sttThread_.join();
     if (ttsThread_.joinable()) ttsThread_.join();
 }
@@ -217,81 +260,292 @@ void AudioPipeline::setTTSCallback(TTSCallback callback) {
     ttsCallback_ = callback;
 }
 
+void AudioPipeline::setKeywordCallback(KeywordCallback callback) {
+    keywordCallback_ = callback;
+}
+
 PipelineState AudioPipeline::getState() const {
     return state_.load(std::memory_order_acquire);
 }
 
 void AudioPipeline::setState(PipelineState state) {
-    state_.store(state, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        state_.store(state, std::memory_order_release);
+    }
     stateCV_.notify_all();
+
+    // Workers blocked on audio for the previous state re-check it now
+    if (audioBus_) {
+        audioBus_->interrupt();
+    }
+}
+
+bool AudioPipeline::setStateIf(PipelineState expected, PipelineState state) {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        if (state_.load(std::memory_order_acquire) != expected) {
+            return false;
+        }
+        state_.store(state, std::memory_order_release);
+    }
+    stateCV_.notify_all();
+    if (audioBus_) {
+        audioBus_->interrupt();
+    }
+    return true;
+}
+
+bool AudioPipeline::waitForState(PipelineState state) {
+    return waitForState(state, state);
+}
+
+bool AudioPipeline::waitForState(PipelineState state, PipelineState other) {
+    std::unique_lock<std::mutex> lock(stateMutex_);
+    stateCV_.wait(lock, [this, state, other]() {
+        PipelineState current = state_.load(std::memory_order_acquire);
+        return !running_ || current == state || current == other;
+    });
+    return running_;
 }
 
 void AudioPipeline::setWakeWordSensitivity(float sensitivity) {
     wakeWordSensitivity_ = sensitivity;
 }
 
+void AudioPipeline::setKeywords(const std::vector<WakeWordDetector::Keyword>& keywords) {
+    wakeSettings_.keywords = keywords;
+}
+
+void AudioPipeline::setWakeWordGate(bool enabled, const ActivityGate::Params& params) {
+    wakeGateEnabled_ = enabled;
+    wakeGateParams_ = params;
+}
+
+void AudioPipeline::setEchoCancellation(bool enabled, const EchoCanceller::Params& params) {
+    echoCancellationEnabled_ = enabled;
+    echoParams_ = params;
+}
+
+void AudioPipeline::setBargeIn(bool enabled) {
+    bargeInEnabled_ = enabled;
+}
+
 void AudioPipeline::setSilenceTimeout(int ms) {
-    silenceTimeoutMs_ = ms;
-    if (vad_) {
-        vad_->setSilenceTimeout(ms);
-    }
+    std::lock_guard<std::mutex> lock(endpointerMutex_);
+    Endpointer::Params params = endpointer_.getParams();
+    params.maxPauseMs = ms;
+    endpointer_.setParams(params);
 }
 
 void AudioPipeline::setMaxUtteranceDuration(int ms) {
-    maxUtteranceDurationMs_ = ms;
+    std::lock_guard<std::mutex> lock(endpointerMutex_);
+    Endpointer::Params params = endpointer_.getParams();
+    params.maxUtteranceMs = ms;
+    endpointer_.setParams(params);
+}
+
+void AudioPipeline::setEndpointing(const Endpointer::Params& params) {
+    std::lock_guard<std::mutex> lock(endpointerMutex_);
+    endpointer_.setParams(params);
+}
+
+void AudioPipeline::setPreRoll(int ms) {
+    preRollMs_ = std::max(0, ms);
+}
+
+void AudioPipeline::setHistoryLength(int seconds) {
+    historySeconds_ = std::max(1, seconds);
+}
+
+void AudioPipeline::reportPlaybackStarted(AudioTimestamp::Clock::time_point firstSampleTime) {
+    std::lock_guard<std::mutex> lock(metricsMutex_);
+    metrics_.ttsLatencyMs = elapsedMs(responseReadyTime_, firstSampleTime);
+}
+
+void AudioPipeline::reportPartialResult(const std::string& text) {
+    std::lock_guard<std::mutex> lock(endpointerMutex_);
+    endpointer_.onPartialResult(text);
+}
+
+bool AudioPipeline::setDownmixWeights(const std::vector<float>& weights) {
+    if (channelMixer_ && !channelMixer_->setWeights(weights)) {
+        return false;
+    }
+    downmixWeights_ = weights;
+    return true;
+}
+
+void AudioPipeline::setChannelCallback(ChannelCallback callback) {
+    channelCallback_ = callback;
+}
+
+void AudioPipeline::setFrontEndCallback(FrontEndCallback callback) {
+    frontEndCallback_ = callback;
+}
+
+AudioPlayer* AudioPipeline::getAudioPlayer() const {
+    return audioPlayer_.get();
 }
 
 AudioPipeline::Metrics AudioPipeline::getMetrics() const {
     std::lock_guard<std::mutex> lock(metricsMutex_);
-    return metrics_;
+    Metrics metrics = metrics_;
+    if (audioBus_) {
+        metrics.consumers = audioBus_->getAllReaderStats();
+    }
+    if (audioCapture_) {
+        metrics.captureBuffer = audioCapture_->getBufferStats();
+    }
+    if (wakeGate_) {
+        ActivityGate::Stats gate = wakeGate_->getStats();
+        metrics.wakeGateDutyCycle = gate.dutyCycle();
+        metrics.wakeGateOpenings = gate.openings;
+    }
+    if (echoCanceller_) {
+        metrics.echoErleDb = echoCanceller_->getStats().erleDb;
+    }
+    return metrics;
 }
 
 // Thread loops
-void AudioPipeline::audioCaptureLoop() {
-    LOG_INFO("Audio capture thread started");
-    
-    // This would integrate with AudioCapture
-    while (running_) {
-        // Simulate audio capture - in real implementation, this would come from AudioCapture
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        
-        // For now, just simulate some audio data
-        std::vector<int16_t> frame(frameSize_, 0);
-        
-        // Write to raw buffer
-        rawAudioBuffer_->write(frame.data(), frame.size());
+void AudioPipeline::onCapturedAudio(const std::vector<int16_t>& block, const AudioTimestamp& stamp) {
+    channelMixer_->process(block.data(), block.size() / channels_);
+    if (channelCallback_) {
+        channelCallback_(*channelMixer_, stamp);
     }
-    
-    LOG_INFO("Audio capture thread stopped");
+
+    // Resample and condition once, then publish to every consumer; waiting readers are woken per block.
+    // Spectra go first so they are ready for any reader the bus write wakes.
+    auto mono = channelMixer_->mono();
+    frontEnd_->process(mono, stamp);
+    std::span<const float> samples = frontEnd_->samples();
+    std::span<const int16_t> pcm = frontEnd_->pcm();
+    AudioTimestamp busStamp = frontEnd_->timestamp();
+    if (echoCanceller_) {
+        // The canceller holds back a partial block, so its output starts that far earlier
+        readPlaybackReference(stamp, mono.size());
+        referenceFrontEnd_->process(std::span<const int16_t>(referenceBlock_.data(), mono.size()), stamp);
+        size_t held = echoCanceller_->pending();
+        echoCanceller_->process(samples, referenceFrontEnd_->samples());
+        samples = echoCanceller_->samples();
+        pcm = echoCanceller_->pcm();
+        busStamp.frameIndex -= held;
+        busStamp.captureTime -= std::chrono::duration_cast<AudioTimestamp::Clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(held) / AudioFrontEnd::kProcessingRate));
+    }
+    if (!pcm.empty()) {
+        spectralFeatures_->process(samples);
+        audioBus_->write(pcm.data(), pcm.size(), busStamp);
+    }
+    if (frontEndCallback_) {
+        frontEndCallback_(*frontEnd_);
+    }
+
+    if (sourcePacing_ != SourcePacing::FreeRun) {
+        return;
+    }
+
+    // Free-running source: wait for whichever consumer is active to catch up
+    AudioBroadcastBuffer::ReaderId reader = AudioBroadcastBuffer::kInvalidReader;
+    switch (getState()) {
+        case PipelineState::IDLE: reader = wakeWordReader_; break;
+        case PipelineState::LISTENING: reader = sttReader_; break;
+        case PipelineState::SPEAKING: reader = bargeInEnabled_ ? wakeWordReader_ : reader; break;
+        default: break;
+    }
+    if (reader != AudioBroadcastBuffer::kInvalidReader) {
+        audioBus_->waitForReader(reader, static_cast<size_t>(AudioFrontEnd::kProcessingRate) * kFreeRunLeadSeconds,
+                                 kAudioWaitTimeout);
+    }
+}
+
+void AudioPipeline::readPlaybackReference(const AudioTimestamp& stamp, size_t frames) {
+    if (referenceBlock_.size() < frames) {
+        referenceBlock_.resize(frames);
+    }
+
+    // Capture and playback count the same device frames; anything no longer
+    // (or not yet) in the history is taken as silence
+    uint64_t position = referenceOrigin_ + stamp.frameIndex;
+    size_t got = 0;
+    playbackHistory_->seek(referenceReader_, position);
+    if (playbackHistory_->readPosition(referenceReader_) == position) {
+        got = playbackHistory_->read(referenceReader_, referenceBlock_.data(), frames);
+    }
+    std::fill(referenceBlock_.begin() + got, referenceBlock_.begin() + frames, 0);
 }
 
 void AudioPipeline::wakeWordLoop() {
     LOG_INFO("Wake word detection thread started");
     
-    const size_t porcupineFrameSize = 512; // Typical Porcupine frame size
-    std::vector<int16_t> frame(porcupineFrameSize);
-    
-    while (running_) {
-        if (getState() == PipelineState::IDLE) {
-            // Read audio for wake word detection
-            size_t available = rawAudioBuffer_->available();
-            if (available >= porcupineFrameSize) {
-                rawAudioBuffer_->read(frame.data(), porcupineFrameSize);
-                
-                // Resample to Porcupine format
-                auto resampled = wakeWordResampler_->resample(frame.data(), porcupineFrameSize);
-                
-                // Process with Porcupine
-                // This would integrate with WakeWordDetector
-                bool detected = false; // Placeholder
-                
-                if (detected) {
-                    handleWakeWord();
+    // Bus reads of exactly one engine frame, so a detection ends with the frame read
+    const size_t engineFrameSize = static_cast<size_t>(wakeWordDetector_->getFrameLength());
+    std::vector<int16_t> frame(engineFrameSize);
+    
+    // Whole frames of lookback, so the replay ends where the opening frame does
+    const size_t lookback = wakeGate_ ? (wakeGate_->lookbackSamples() + engineFrameSize - 1) /
+                                            engineFrameSize * engineFrameSize
+                                      : 0;
+    
+    // With barge-in the keyword is also listened for over a response
+    const PipelineState bargeInState = bargeInEnabled_ ? PipelineState::SPEAKING : PipelineState::IDLE;
+    auto listening = [this, bargeInState]() {
+        PipelineState state = getState();
+        return state == PipelineState::IDLE || state == bargeInState;
+    };
+    
+    while (waitForState(PipelineState::IDLE, bargeInState)) {
+        // Don't resume on stale audio after the previous interaction
+        audioBus_->seekToLatest(wakeWordReader_);
+        if (wakeGate_) {
+            wakeGate_->reset();
+        }
+        uint64_t replayEnd = 0;
+        uint64_t fedEnd = 0;            // end of the last frame the engine saw
+        
+        while (running_ && listening()) {
+            // Block until a full frame is ready or the state changes
+            if (!audioBus_->waitForAvailable(wakeWordReader_, engineFrameSize, kAudioWaitTimeout) ||
+                audioBus_->read(wakeWordReader_, frame.data(), engineFrameSize) != engineFrameSize) {
+                continue;
+            }
+            auto frameReadAt = AudioTimestamp::Clock::now();
+            
+            // Frames being replayed were already passed by the gate
+            uint64_t frameEnd = audioBus_->readPosition(wakeWordReader_);
+            if (wakeGate_ && frameEnd > replayEnd) {
+                if (!wakeGate_->process(frame.data(), engineFrameSize)) {
+                    continue;
                 }
+                if (wakeGate_->justOpened() && lookback > 0) {
+                    // Hand the engine the audio before this frame first, then this frame again.
+                    // Audio it already saw is not replayed; across a longer gap it starts afresh.
+                    uint64_t frameStart = frameEnd - engineFrameSize;
+                    uint64_t replayStart = frameStart - std::min<uint64_t>(lookback, frameStart);
+                    if (replayStart > fedEnd) {
+                        wakeWordDetector_->reset();
+                    } else {
+                        replayStart = std::min(fedEnd, frameStart);
+                    }
+                    wakeGate_->countReplayed((frameStart - replayStart + engineFrameSize - 1) / engineFrameSize);
+                    audioBus_->seek(wakeWordReader_, replayStart);
+                    replayEnd = frameEnd;
+                    continue;
+                }
+            }
+            
+            // Every keyword is scored in the same engine call
+            int keyword = wakeWordDetector_->processAudio(frame);
+            fedEnd = frameEnd;
+            
+            if (keyword == 0) {
+                // The keyword ends with the frame just read
+                handleWakeWord(audioBus_->readPosition(wakeWordReader_), frameReadAt);
+            } else if (keyword != WakeWordDetector::kNoKeyword) {
+                handleKeyword(keyword);
             }
         }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
     
     LOG_INFO("Wake word detection thread stopped");
@@ -300,81 +554,241 @@ void AudioPipeline::wakeWordLoop() {
 void AudioPipeline::speechRecognitionLoop() {
     LOG_INFO("Speech recognition thread started");
     
-    const size_t sttFrameSize = 4096; // Larger frame for STT
+    // Small reads keep the end of turn prompt; the VAD and endpointer advance one feature hop at a time
+    const size_t endpointStep = spectralFeatures_->hopSize();
+    const size_t sttFrameSize = endpointStep * 5;
     std::vector<int16_t> frame(sttFrameSize);
+    std::vector<float> power(spectralFeatures_->numBins());
+    uint64_t reportedDrops = 0;
     
-    while (running_) {
-        if (getState() == PipelineState::LISTENING) {
-            size_t available = rawAudioBuffer_->available();
-            if (available >= sttFrameSize) {
-                rawAudioBuffer_->read(frame.data(), sttFrameSize);
-                
-                // Resample to Vosk format
-                auto resampled = sttResampler_->resample(frame.data(), sttFrameSize);
-                
-                // Process with VAD and Vosk
-                bool voiceActive = vad_->processFrame(resampled.data(), resampled.size());
-                
-                // This would integrate with SpeechRecognizer
-                // Placeholder for Vosk processing
-                
-                if (!voiceActive) {
-                    handleSpeechEnd();
+    while (waitForState(PipelineState::LISTENING)) {
+        // A new turn; the wake word thread has already moved sttReader_ to its start
+        vad_->reset();
+        transcript_.clear();
+        if (sttReady_) {
+            speechRecognizer_->startRecognition();
+        }
+        {
+            std::lock_guard<std::mutex> lock(endpointerMutex_);
+            endpointer_.reset();
+        }
+        
+        bool firstFrame = true;
+        while (running_ && getState() == PipelineState::LISTENING) {
+            if (!audioBus_->waitForAvailable(sttReader_, sttFrameSize, kAudioWaitTimeout) ||
+                audioBus_->read(sttReader_, frame.data(), sttFrameSize) != sttFrameSize) {
+                continue;
+            }
+            
+            // Losing audio garbles the transcript; say so when it happens
+            auto sttStats = audioBus_->getReaderStats(sttReader_);
+            if (sttStats.droppedSamples > reportedDrops) {
+                LOG_WARNING("Speech recognition fell behind capture; dropped " +
+                            std::to_string(sttStats.droppedSamples - reportedDrops) + " samples");
+                reportedDrops = sttStats.droppedSamples;
+            }
+            
+            if (firstFrame) {
+                firstFrame = false;
+                std::lock_guard<std::mutex> lock(metricsMutex_);
+                metrics_.wakeToStartMs = elapsedMs(metrics_.keywordEnd.captureTime,
+                                                   AudioTimestamp::Clock::now());
+            }
+            
+            // Process with Vosk and the VAD; the bus is already at their 16 kHz.
+            // The partial goes in first so the endpointer sees it for this read
+            feedRecognizer(frame);
+            Endpointer::Result result = Endpointer::Result::Continue;
+            uint64_t speechStart = 0;
+            uint64_t speechEnd = 0;
+            uint64_t decidedAt = 0;
+            {
+                // The spectrum of each step is the feature frame ending with it; one
+                // that is not there (too early, or overwritten) keeps the last decision
+                const uint64_t frameStart = audioBus_->readPosition(sttReader_) - sttFrameSize;
+                std::lock_guard<std::mutex> lock(endpointerMutex_);
+                for (size_t offset = 0; offset < sttFrameSize && result == Endpointer::Result::Continue;
+                     offset += endpointStep) {
+                    uint64_t index = 0;
+                    if (spectralFeatures_->frameEndingBy(frameStart + offset + endpointStep, index) &&
+                        spectralFeatures_->readPower(index, power.data())) {
+                        vad_->processSpectrum(frame.data() + offset, endpointStep, power.data());
+                    }
+                    result = endpointer_.update(endpointStep, vad_->getFeatures().speech);
                 }
+                speechStart = endpointer_.speechStartSample();
+                speechEnd = endpointer_.speechEndSample();
+                decidedAt = endpointer_.position();
+            }
+            
+            if (result == Endpointer::Result::NoSpeech) {
+                LOG_INFO("No speech after the wake word");
+                setState(PipelineState::IDLE);
+            } else if (result != Endpointer::Result::Continue) {
+                LOG_DEBUG(std::string("Turn ended: ") + Endpointer::resultName(result));
+                {
+                    std::lock_guard<std::mutex> lock(metricsMutex_);
+                    metrics_.speechStart = audioBus_->timestampAt(utteranceStartPosition_ + speechStart);
+                    metrics_.endpointMs = static_cast<double>(decidedAt - speechEnd) * 1000.0 /
+                                          AudioFrontEnd::kProcessingRate;
+                }
+                handleSpeechEnd(audioBus_->timestampAt(utteranceStartPosition_ + speechEnd));
             }
         }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
     
     LOG_INFO("Speech recognition thread stopped");
 }
 
+// Appends recognized words, space-separated
+static void appendWords(std::string& text, const std::string& words) {
+    if (words.empty()) {
+        return;
+    }
+    if (!text.empty()) {
+        text += ' ';
+    }
+    text += words;
+}
+
+void AudioPipeline::feedRecognizer(const std::vector<int16_t>& frame) {
+    if (!sttReady_) {
+        return;
+    }
+
+    // Vosk reports {"partial": ...} while a segment is open and {"text": ...} once it closes
+    std::string result = speechRecognizer_->processAudio(frame);
+    if (result.empty()) {
+        return;
+    }
+    nlohmann::json json = nlohmann::json::parse(result, nullptr, false);
+    if (!json.is_object()) {
+        return;
+    }
+    std::string hypothesis;
+    if (json.contains("text") && json["text"].is_string()) {
+        appendWords(transcript_, json["text"].get<std::string>());
+        hypothesis = transcript_;
+    } else if (json.contains("partial") && json["partial"].is_string()) {
+        hypothesis = transcript_;
+        appendWords(hypothesis, json["partial"].get<std::string>());
+    } else {
+        return;
+    }
+    reportPartialResult(hypothesis);
+}
+
 void AudioPipeline::ttsLoop() {
     LOG_INFO("TTS thread started");
     
-    while (running_) {
-        // This would integrate with TextToSpeech
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    while (waitForState(PipelineState::SPEAKING)) {
+        std::string response;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex_);
+            response.swap(pendingResponse_);
+        }
+        
+        // Rendered into the capture's player, so the echo canceller has it as reference
+        std::vector<int16_t> speech = textToSpeech_->synthesize(response, audioPlayer_->getSampleRate());
+        if (!speech.empty() && getState() == PipelineState::SPEAKING) {
+            audioPlayer_->enqueue(std::move(speech));
+        }
+        
+        // The response plays through the player; speaking ends when it goes
+        // quiet, unless a barge-in moved the state on first
+        {
+            std::unique_lock<std::mutex> lock(stateMutex_);
+            while (running_ && state_.load(std::memory_order_acquire) == PipelineState::SPEAKING &&
+                   audioPlayer_->isPlaying()) {
+                stateCV_.wait_for(lock, kAudioWaitTimeout);
+            }
+        }
+        if (running_ && getState() == PipelineState::SPEAKING) {
+            handleTTSComplete();
+        } else if (audioPlayer_->isPlaying()) {
+            // A barge-in landed between rendering and queueing; its stopAt() came too early
+            audioPlayer_->stopAt();
+        }
     }
     
     LOG_INFO("TTS thread stopped");
 }
 
 // Event handlers
-void AudioPipeline::handleWakeWord() {
+void AudioPipeline::handleWakeWord(uint64_t keywordEndPosition,
+                                   AudioTimestamp::Clock::time_point frameReadAt) {
     LOG_INFO("Wake word detected");
     
+    // Barge-in: the user talked over the response, so cut it off now
+    if (audioPlayer_->isPlaying() || getState() == PipelineState::SPEAKING) {
+        audioPlayer_->stopAt();
+        textToSpeech_->stop();
+        std::lock_guard<std::mutex> lock(metricsMutex_);
+        ++metrics_.bargeIns;
+        LOG_INFO("Response interrupted by the wake word");
+    }
+    
+    // Feed STT from where the keyword ended (less the pre-roll), not from
+    // now: whatever the user said since is still in the bus history
+    uint64_t preRoll = static_cast<uint64_t>(preRollMs_) * AudioFrontEnd::kProcessingRate / 1000;
+    utteranceStartPosition_ = keywordEndPosition - std::min(preRoll, keywordEndPosition);
+    audioBus_->seek(sttReader_, utteranceStartPosition_);
+    
     {
         std::lock_guard<std::mutex> lock(metricsMutex_);
-        metrics_.wakeToStartMs = 0.0; // Reset timing
-        wakeStartTime_ = std::chrono::steady_clock::now();
+        AudioTimestamp keywordEnd = audioBus_->timestampAt(keywordEndPosition);
+        metrics_.keywordEnd = keywordEnd;
+        metrics_.speechStart = audioBus_->timestampAt(audioBus_->readPosition(sttReader_));
+        metrics_.wakeBufferingMs = elapsedMs(keywordEnd.captureTime, frameReadAt);
+        metrics_.wakeComputeMs = elapsedMs(frameReadAt, AudioTimestamp::Clock::now());
     }
     
+    // Recognition starts right away; the callback no longer delays it
+    setState(PipelineState::LISTENING);
+    
     if (wakeWordCallback_) {
         wakeWordCallback_();
     }
+}
+
+void AudioPipeline::handleKeyword(int keyword) {
+    const std::string& name = wakeWordDetector_->getKeywords()[keyword].name;
+    LOG_INFO("Keyword detected: " + name);
     
-    setState(PipelineState::LISTENING);
+    // Commands act at once: no turn, so no STT or NLU round trip
+    if (audioPlayer_->isPlaying()) {
+        audioPlayer_->stopAt();
+        textToSpeech_->stop();
+    }
+    setStateIf(PipelineState::SPEAKING, PipelineState::IDLE);
     
-    // Clear STT buffer for fresh utterance
-    sttBuffer_->clear();
-    vad_->reset();
+    if (keywordCallback_) {
+        keywordCallback_(keyword, name);
+    }
 }
 
-void AudioPipeline::handleSpeechEnd() {
+void AudioPipeline::handleSpeechEnd(const AudioTimestamp& speechEnd) {
     LOG_INFO("Speech recognition complete");
     
+    // Whatever the recognizer still holds closes the last segment
+    std::string transcript = transcript_;
+    if (sttReady_) {
+        nlohmann::json json = nlohmann::json::parse(speechRecognizer_->getFinalResult(), nullptr, false);
+        if (json.is_object() && json.contains("text") && json["text"].is_string()) {
+            appendWords(transcript, json["text"].get<std::string>());
+        }
+    }
+    auto finalResultTime = AudioTimestamp::Clock::now();
+    
     {
         std::lock_guard<std::mutex> lock(metricsMutex_);
-        auto endTime = std::chrono::steady_clock::now();
-        metrics_.speechDurationMs = std::chrono::duration<double, std::milli>(
-            endTime - speechStartTime_).count();
+        metrics_.speechEnd = speechEnd;
+        metrics_.speechDurationMs = static_cast<double>(
+            speechEnd.frameIndex - std::min(speechEnd.frameIndex, metrics_.speechStart.frameIndex)) *
+            1000.0 / AudioFrontEnd::kProcessingRate;
+        metrics_.sttLatencyMs = elapsedMs(speechEnd.captureTime, finalResultTime);
     }
     
-    // This would integrate with SpeechRecognizer to get final result
-    std::string transcript = "Simulated transcript";
-    
     if (speechCallback_) {
         speechCallback_(transcript);
     }
@@ -386,20 +800,29 @@ void AudioPipeline::handleSpeechEnd() {
     
     // Simulate response generation
     std::string response = "I heard: " + transcript;
-    
-    setState(PipelineState::SPEAKING);
+    {
+        std::lock_guard<std::mutex> lock(metricsMutex_);
+        responseReadyTime_ = AudioTimestamp::Clock::now();
+        metrics_.nluLatencyMs = elapsedMs(finalResultTime, responseReadyTime_);
+    }
     
     if (ttsCallback_) {
         ttsCallback_(response);
     }
     
-    // After TTS completes
-    setState(PipelineState::IDLE);
+    // SPEAKING covers rendering as well as playback, so barge-in listens from here;
+    // the TTS thread renders the response and holds SPEAKING until it has played
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        pendingResponse_ = response;
+    }
+    setState(PipelineState::SPEAKING);
 }
 
 void AudioPipeline::handleTTSComplete() {
-    LOG_INFO("TTS playback complete");
-    setState(PipelineState::IDLE);
+    if (setStateIf(PipelineState::SPEAKING, PipelineState::IDLE)) {
+        LOG_INFO("TTS playback complete");
+    }
 }
 
 } // namespace jarvis
\ No newline at end of file
@@ -0,0 +1,492 @@
+#include "audio/audio_player.h"
+#include "audio/audio_broadcast_buffer.h"
+#include "audio/audio_ring_buffer.h"
+#include <portaudio.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+
+namespace jarvis {
+
+namespace {
+
+// Events the device thread can report before the notifier catches up
+constexpr size_t kMaxPendingEvents = 1024;
+
+/**
+ * Fixed-capacity single-producer/single-consumer queue of trivially
+ * copyable items; push() and pop() never allocate or block.
+ */
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity)
+        : slots_(std::bit_ceil(std::max<size_t>(capacity, 2))), mask_(slots_.size() - 1) {}
+
+    bool push(const T& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+            return false;
+        }
+        slots_[tail & mask_] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return slots_.size(); }
+
+private:
+    std::vector<T> slots_;
+    const size_t mask_;
+    alignas(kCacheLineSize) std::atomic<size_t> head_{0};
+    alignas(kCacheLineSize) std::atomic<size_t> tail_{0};
+};
+
+struct Chunk {
+    uint64_t id = 0;
+    uint64_t generation = 0;   // stopAt() calls issued before this chunk was queued
+    uint64_t startFrame = 0;
+    size_t offset = 0;         // frames already played
+    bool started = false;
+    std::vector<int16_t> samples;
+};
+
+} // namespace
+
+class AudioPlayer::AudioPlayerImpl {
+public:
+    int sampleRate_ = 16000;
+    int channels_ = 1;
+    int framesPerBuffer_ = 256;
+    bool attached_ = false;
+
+    PaStream* stream_ = nullptr;
+    bool paInitialized_ = false;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> rendering_{false};
+
+    // Producer side (enqueue/stopAt callers)
+    std::mutex enqueueMutex_;
+    uint64_t nextChunkId_ = 1;
+    uint64_t queuedEnd_ = 0;
+    std::atomic<uint64_t> liveChunks_{0};
+    std::atomic<uint64_t> queuedChunks_{0};
+
+    // Lock-free hand-off with the device thread
+    std::unique_ptr<SpscRing<Chunk*>> pending_;
+    std::unique_ptr<SpscRing<Chunk*>> retired_;
+    std::unique_ptr<SpscRing<PlaybackEvent>> events_;
+    std::counting_semaphore<> eventsReady_{0};
+    std::atomic<uint64_t> stopFrame_{0};
+    std::atomic<uint64_t> stopGeneration_{0};
+
+    // Device thread only
+    Chunk* current_ = nullptr;
+    uint64_t handledStopGeneration_ = 0;
+    uint64_t activeStopFrame_ = kNoStop;
+    uint64_t activeStopGeneration_ = 0;
+    std::atomic<uint64_t> outputFrame_{0};
+
+    // Optional copy of everything rendered; no reader ever waits on it
+    std::unique_ptr<AudioBroadcastBuffer> history_;
+
+    // Notifier thread
+    std::thread notifierThread_;
+    std::mutex callbackMutex_;
+    AudioPlayer::PositionCallback callback_;
+
+    static constexpr uint64_t kNoStop = std::numeric_limits<uint64_t>::max();
+
+    static int portAudioCallback(const void* input,
+                                 void* output,
+                                 unsigned long frameCount,
+                                 const PaStreamCallbackTimeInfo* timeInfo,
+                                 PaStreamCallbackFlags statusFlags,
+                                 void* userData);
+
+    // Skips rendering once stop() has begun; stop() waits for a render in progress
+    void renderIfRunning(int16_t* output, unsigned long frames,
+                         AudioTimestamp::Clock::time_point dacTime) noexcept;
+    void render(int16_t* output, unsigned long frames, AudioTimestamp::Clock::time_point dacTime) noexcept;
+    void executeStop(uint64_t frame, AudioTimestamp::Clock::time_point time) noexcept;
+    void retire(Chunk* chunk) noexcept;
+    void report(PlaybackEvent::Type type, const Chunk& chunk, uint64_t frame,
+                AudioTimestamp::Clock::time_point time) noexcept;
+    void notifierLoop();
+    void drainNotifications();
+    void releaseAllChunks();
+};
+
+AudioPlayer::AudioPlayer() : impl_(std::make_unique<AudioPlayerImpl>()) {}
+
+AudioPlayer::~AudioPlayer() {
+    stop();
+}
+
+bool AudioPlayer::initialize(int sampleRate, int channels, int framesPerBuffer, size_t maxChunks) {
+    if (impl_->running_) {
+        return false;
+    }
+    impl_->sampleRate_ = sampleRate;
+    impl_->channels_ = channels;
+    impl_->framesPerBuffer_ = framesPerBuffer;
+
+    // Every chunk alive fits in the retire ring, so the device thread never fails to hand one back
+    impl_->pending_ = std::make_unique<SpscRing<Chunk*>>(maxChunks);
+    impl_->retired_ = std::make_unique<SpscRing<Chunk*>>(impl_->pending_->capacity() * 2);
+    impl_->events_ = std::make_unique<SpscRing<PlaybackEvent>>(kMaxPendingEvents);
+    return true;
+}
+
+bool AudioPlayer::start() {
+    if (impl_->running_ || !impl_->pending_) {
+        return false;
+    }
+
+    impl_->outputFrame_ = 0;
+    impl_->queuedEnd_ = 0;
+    impl_->activeStopFrame_ = AudioPlayerImpl::kNoStop;
+    impl_->handledStopGeneration_ = impl_->stopGeneration_.load();
+    impl_->running_ = true;
+    impl_->notifierThread_ = std::thread(&AudioPlayerImpl::notifierLoop, impl_.get());
+
+    if (impl_->attached_) {
+        // The capture stream calls render()
+        return true;
+    }
+
+    PaError err = Pa_Initialize();
+    if (err != paNoError) {
+        std::cerr << "PortAudio initialization failed: " << Pa_GetErrorText(err) << std::endl;
+        stop();
+        return false;
+    }
+    impl_->paInitialized_ = true;
+
+    PaStreamParameters outputParameters;
+    outputParameters.device = Pa_GetDefaultOutputDevice();
+    const PaDeviceInfo* deviceInfo = outputParameters.device != paNoDevice
+        ? Pa_GetDeviceInfo(outputParameters.device) : nullptr;
+    if (!deviceInfo) {
+        std::cerr << "No default output device" << std::endl;
+        stop();
+        return false;
+    }
+    outputParameters.channelCount = impl_->channels_;
+    outputParameters.sampleFormat = paInt16;
+    outputParameters.suggestedLatency = deviceInfo->defaultLowOutputLatency;
+    outputParameters.hostApiSpecificStreamInfo = nullptr;
+
+    err = Pa_OpenStream(&impl_->stream_, nullptr, &outputParameters, impl_->sampleRate_,
+                        impl_->framesPerBuffer_, paClipOff, &AudioPlayerImpl::portAudioCallback,
+                        impl_.get());
+    if (err == paNoError) {
+        err = Pa_StartStream(impl_->stream_);
+    } else {
+        impl_->stream_ = nullptr;
+    }
+    if (err != paNoError) {
+        std::cerr << "Failed to start playback stream: " << Pa_GetErrorText(err) << std::endl;
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void AudioPlayer::stop() {
+    if (impl_->stream_) {
+        Pa_StopStream(impl_->stream_);
+        Pa_CloseStream(impl_->stream_);
+        impl_->stream_ = nullptr;
+    }
+    if (impl_->paInitialized_) {
+        Pa_Terminate();
+        impl_->paInitialized_ = false;
+    }
+
+    if (impl_->running_.exchange(false, std::memory_order_seq_cst)) {
+        // An attached capture stream may still be inside render(); wait it out
+        while (impl_->rendering_.load(std::memory_order_seq_cst)) {
+            std::this_thread::yield();
+        }
+        impl_->eventsReady_.release();
+        if (impl_->notifierThread_.joinable()) {
+            impl_->notifierThread_.join();
+        }
+    }
+    if (impl_->pending_) {
+        impl_->drainNotifications();
+        impl_->releaseAllChunks();
+    }
+}
+
+uint64_t AudioPlayer::enqueue(std::vector<int16_t> samples, uint64_t startFrame) {
+    if (!impl_->pending_ || samples.empty()) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(impl_->enqueueMutex_);
+    if (impl_->liveChunks_.load(std::memory_order_acquire) >= impl_->pending_->capacity()) {
+        return 0;
+    }
+
+    auto* chunk = new Chunk();
+    chunk->id = impl_->nextChunkId_++;
+    chunk->generation = impl_->stopGeneration_.load(std::memory_order_acquire);
+    chunk->samples = std::move(samples);
+
+    // Gapless after the previous chunk, or as soon as possible if playback has caught up
+    uint64_t frames = chunk->samples.size() / impl_->channels_;
+    uint64_t now = impl_->outputFrame_.load(std::memory_order_acquire);
+    if (startFrame == kAfterQueued) {
+        startFrame = impl_->queuedEnd_ > now ? impl_->queuedEnd_ : 0;
+    }
+    chunk->startFrame = startFrame;
+    impl_->queuedEnd_ = std::max(startFrame, now) + frames;
+
+    impl_->liveChunks_.fetch_add(1, std::memory_order_acq_rel);
+    impl_->queuedChunks_.fetch_add(1, std::memory_order_acq_rel);
+    if (!impl_->pending_->push(chunk)) {
+        impl_->liveChunks_.fetch_sub(1, std::memory_order_acq_rel);
+        impl_->queuedChunks_.fetch_sub(1, std::memory_order_acq_rel);
+        delete chunk;
+        return 0;
+    }
+    return chunk->id;
+}
+
+void AudioPlayer::stopAt(uint64_t outputFrame) {
+    std::lock_guard<std::mutex> lock(impl_->enqueueMutex_);
+    // The frame is published before the generation that makes the device thread look at it
+    impl_->stopFrame_.store(outputFrame, std::memory_order_relaxed);
+    impl_->stopGeneration_.fetch_add(1, std::memory_order_release);
+    impl_->queuedEnd_ = 0;
+}
+
+void AudioPlayer::setPositionCallback(PositionCallback callback) {
+    std::lock_guard<std::mutex> lock(impl_->callbackMutex_);
+    impl_->callback_ = callback;
+}
+
+AudioBroadcastBuffer* AudioPlayer::enableOutputHistory(size_t frames) {
+    if (impl_->running_) {
+        return impl_->history_.get();
+    }
+    impl_->history_ = std::make_unique<AudioBroadcastBuffer>(frames * impl_->channels_, impl_->sampleRate_,
+                                                             impl_->channels_);
+    return impl_->history_.get();
+}
+
+uint64_t AudioPlayer::getOutputPosition() const {
+    return impl_->outputFrame_.load(std::memory_order_acquire);
+}
+
+bool AudioPlayer::isPlaying() const {
+    return impl_->queuedChunks_.load(std::memory_order_acquire) > 0;
+}
+
+bool AudioPlayer::isRunning() const { return impl_->running_; }
+int AudioPlayer::getSampleRate() const { return impl_->sampleRate_; }
+int AudioPlayer::getChannels() const { return impl_->channels_; }
+
+void AudioPlayer::render(int16_t* output, unsigned long frames,
+                         AudioTimestamp::Clock::time_point dacTime) noexcept {
+    impl_->renderIfRunning(output, frames, dacTime);
+}
+
+void AudioPlayer::setAttached(bool attached) {
+    impl_->attached_ = attached;
+}
+
+int AudioPlayer::AudioPlayerImpl::portAudioCallback(const void* /*input*/, void* output,
+                                                   unsigned long frameCount,
+                                                   const PaStreamCallbackTimeInfo* timeInfo,
+                                                   PaStreamCallbackFlags /*statusFlags*/,
+                                                   void* userData) {
+    auto* impl = static_cast<AudioPlayerImpl*>(userData);
+    auto dacTime = AudioTimestamp::Clock::now();
+    if (timeInfo && timeInfo->outputBufferDacTime > timeInfo->currentTime) {
+        dacTime += std::chrono::duration_cast<AudioTimestamp::Clock::duration>(
+            std::chrono::duration<double>(timeInfo->outputBufferDacTime - timeInfo->currentTime));
+    }
+
+    impl->renderIfRunning(static_cast<int16_t*>(output), frameCount, dacTime);
+    return paContinue;
+}
+
+void AudioPlayer::AudioPlayerImpl::renderIfRunning(int16_t* output, unsigned long frames,
+                                                   AudioTimestamp::Clock::time_point dacTime) noexcept {
+    rendering_.store(true, std::memory_order_seq_cst);
+    if (running_.load(std::memory_order_seq_cst)) {
+        render(output, frames, dacTime);
+    } else {
+        std::memset(output, 0, static_cast<size_t>(frames) * channels_ * sizeof(int16_t));
+    }
+    if (history_) {
+        history_->write(output, static_cast<size_t>(frames) * channels_);
+    }
+    rendering_.store(false, std::memory_order_release);
+}
+
+void AudioPlayer::AudioPlayerImpl::render(int16_t* output, unsigned long frames,
+                                          AudioTimestamp::Clock::time_point dacTime) noexcept {
+    const uint64_t base = outputFrame_.load(std::memory_order_relaxed);
+    const size_t frameBytes = static_cast<size_t>(channels_) * sizeof(int16_t);
+    auto timeOf = [&](uint64_t frame) {
+        return dacTime + std::chrono::duration_cast<AudioTimestamp::Clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(frame - base) / sampleRate_));
+    };
+
+    // Pick up a new stopAt() request
+    uint64_t generation = stopGeneration_.load(std::memory_order_acquire);
+    if (generation != handledStopGeneration_) {
+        handledStopGeneration_ = generation;
+        activeStopFrame_ = std::max(stopFrame_.load(std::memory_order_relaxed), base);
+        activeStopGeneration_ = generation;
+    }
+
+    bool reported = false;
+    uint64_t done = 0;
+    while (done < frames) {
+        uint64_t frame = base + done;
+        if (frame >= activeStopFrame_) {
+            executeStop(frame, timeOf(frame));
+            reported = true;
+        }
+        uint64_t limit = std::min<uint64_t>(frames, activeStopFrame_ - base);
+
+        if (!current_ && !pending_->pop(current_)) {
+            current_ = nullptr;
+            break;
+        }
+
+        // Silence until the chunk's start frame
+        if (frame < current_->startFrame) {
+            uint64_t gap = std::min(limit - done, current_->startFrame - frame);
+            std::memset(output + done * channels_, 0, gap * frameBytes);
+            done += gap;
+            continue;
+        }
+
+        if (!current_->started) {
+            current_->started = true;
+            report(PlaybackEvent::Type::Started, *current_, frame, timeOf(frame));
+            reported = true;
+        }
+
+        uint64_t remaining = current_->samples.size() / channels_ - current_->offset;
+        uint64_t n = std::min(limit - done, remaining);
+        std::memcpy(output + done * channels_, current_->samples.data() + current_->offset * channels_,
+                    n * frameBytes);
+        current_->offset += n;
+        done += n;
+
+        if (current_->offset * channels_ >= current_->samples.size()) {
+            report(PlaybackEvent::Type::Finished, *current_, base + done, timeOf(base + done));
+            retire(current_);
+            current_ = nullptr;
+            reported = true;
+        }
+    }
+
+    if (done < frames) {
+        std::memset(output + done * channels_, 0, (frames - done) * frameBytes);
+    }
+    if (current_ && current_->started) {
+        report(PlaybackEvent::Type::Progress, *current_, base + frames, timeOf(base + frames));
+        reported = true;
+    }
+
+    outputFrame_.store(base + frames, std::memory_order_release);
+    if (reported) {
+        eventsReady_.release();
+    }
+}
+
+void AudioPlayer::AudioPlayerImpl::executeStop(uint64_t frame, AudioTimestamp::Clock::time_point time) noexcept {
+    // Everything queued before the stopAt() call goes; anything queued since stays
+    if (current_ && current_->generation < activeStopGeneration_) {
+        report(PlaybackEvent::Type::Stopped, *current_, frame, time);
+        retire(current_);
+        current_ = nullptr;
+    }
+    Chunk* chunk = nullptr;
+    while (!current_ && pending_->pop(chunk)) {
+        if (chunk->generation < activeStopGeneration_) {
+            report(PlaybackEvent::Type::Stopped, *chunk, frame, time);
+            retire(chunk);
+        } else {
+            current_ = chunk;
+        }
+    }
+    activeStopFrame_ = kNoStop;
+}
+
+void AudioPlayer::AudioPlayerImpl::retire(Chunk* chunk) noexcept {
+    queuedChunks_.fetch_sub(1, std::memory_order_acq_rel);
+    retired_->push(chunk);
+}
+
+void AudioPlayer::AudioPlayerImpl::report(PlaybackEvent::Type type, const Chunk& chunk, uint64_t frame,
+                                          AudioTimestamp::Clock::time_point time) noexcept {
+    PlaybackEvent event;
+    event.type = type;
+    event.chunkId = chunk.id;
+    event.chunkFrame = chunk.offset;
+    event.outputFrame = frame;
+    event.time = time;
+    events_->push(event); // A full queue drops progress rather than blocking the device
+}
+
+void AudioPlayer::AudioPlayerImpl::notifierLoop() {
+    while (running_) {
+        eventsReady_.try_acquire_for(std::chrono::milliseconds(100));
+        drainNotifications();
+    }
+}
+
+void AudioPlayer::AudioPlayerImpl::drainNotifications() {
+    PlaybackEvent event;
+    while (events_->pop(event)) {
+        std::lock_guard<std::mutex> lock(callbackMutex_);
+        if (callback_) {
+            callback_(event);
+        }
+    }
+
+    // Chunks are freed here, never on the device thread
+    Chunk* chunk = nullptr;
+    while (retired_->pop(chunk)) {
+        delete chunk;
+        liveChunks_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+void AudioPlayer::AudioPlayerImpl::releaseAllChunks() {
+    Chunk* chunk = current_;
+    current_ = nullptr;
+    do {
+        if (chunk) {
+            delete chunk;
+            liveChunks_.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    } while (pending_->pop(chunk));
+    queuedChunks_ = 0;
+}
+
+} // namespace jarvis
@@ -0,0 +1,622 @@
+#include "audio/audio_resampler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <numbers>
+#include <numeric>
+#include <tuple>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define JARVIS_RESAMPLER_SSE2 1
+#endif
+
+#if defined(JARVIS_RESAMPLER_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define JARVIS_RESAMPLER_AVX2 1
+#endif
+
+namespace jarvis {
+
+namespace {
+
+// Coefficient rows are padded to a multiple of this many taps for the SIMD loops
+constexpr int kTapAlignment = 8;
+
+// Outputs the SIMD loops compute together so one transpose finishes them all
+constexpr int kOutputsPerStep = 4;
+
+struct QualityParams {
+    int zeroCrossings;  // sinc lobes on each side of the centre, at the lower of the two rates
+    double beta;        // Kaiser window shape
+    double rolloff;     // cutoff as a fraction of the lower Nyquist frequency
+};
+
+QualityParams paramsFor(AudioResampler::Quality quality) {
+    switch (quality) {
+        case AudioResampler::Quality::Fast: return {4, 5.0, 0.80};
+        case AudioResampler::Quality::High: return {16, 9.0, 0.92};
+        case AudioResampler::Quality::Balanced:
+        default: return {8, 7.0, 0.86};
+    }
+}
+
+// Zeroth-order modified Bessel function of the first kind, by its power series
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+struct PolyphaseFilter;
+
+/**
+ * Filters one channel: one output per window whose newest frame is inside
+ * history. next and phase are advanced past the last output; returns the
+ * number of outputs, written stride samples apart. Each ISA gets its own
+ * copy of the loop so the dot product inlines into it.
+ */
+using FilterLoop = size_t (*)(const PolyphaseFilter& filter, const int16_t* history, size_t length,
+                              size_t& next, int& phase, int16_t* output, int stride);
+
+struct PolyphaseFilter {
+    int up = 1;        // L: phases
+    int down = 1;      // M: input frames per L output frames
+    int taps = 0;      // per phase, padded to kTapAlignment
+    int fractionBits = 15;
+    double delay = 0;  // in input frames
+
+    // One row per phase, oldest tap first so a row lines up with history
+    std::vector<int16_t> coefficients;
+
+    // Phase and input advance after an output at each phase
+    std::vector<int> nextPhase;
+    std::vector<int> advance;
+
+    // The same over kOutputsPerStep outputs, so the SIMD loops look up one
+    // step per group instead of chasing the phase sequence output by output
+    struct Step {
+        int offset[kOutputsPerStep];   // input offset of each window from the first
+        int phase[kOutputsPerStep];
+        int advance;                   // offset of the window after the group
+        int nextPhase;
+    };
+    std::vector<Step> steps;
+
+    // Loop for this bank on this CPU, chosen once when the bank is built
+    FilterLoop loop = nullptr;
+};
+
+#ifndef JARVIS_RESAMPLER_SSE2
+
+int16_t roundFixedPoint(int32_t acc, int fractionBits) {
+    return static_cast<int16_t>(std::clamp((acc + (1 << (fractionBits - 1))) >> fractionBits,
+                                           -32768, 32767));
+}
+
+size_t filterScalar(const PolyphaseFilter& filter, const int16_t* history, size_t length,
+                    size_t& next, int& phase, int16_t* output, int stride) {
+    const int taps = filter.taps;
+    size_t n = 0;
+    while (next < length) {
+        const int16_t* x = history + next - (taps - 1);
+        const int16_t* h = filter.coefficients.data() + static_cast<size_t>(phase) * taps;
+        int32_t acc = 0;
+        for (int i = 0; i < taps; ++i) {
+            acc += static_cast<int32_t>(x[i]) * h[i];
+        }
+        output[n++ * stride] = roundFixedPoint(acc, filter.fractionBits);
+        next += filter.advance[phase];
+        phase = filter.nextPhase[phase];
+    }
+    return n;
+}
+
+#else
+
+// Sums each of four accumulators across its lanes, rounds and saturates to 16 bits
+inline __m128i finishOutputs(__m128i a, __m128i b, __m128i c, __m128i d, int fractionBits) {
+    __m128i ab = _mm_add_epi32(_mm_unpacklo_epi32(a, b), _mm_unpackhi_epi32(a, b));
+    __m128i cd = _mm_add_epi32(_mm_unpacklo_epi32(c, d), _mm_unpackhi_epi32(c, d));
+    __m128i sums = _mm_add_epi32(_mm_unpacklo_epi64(ab, cd), _mm_unpackhi_epi64(ab, cd));
+    sums = _mm_add_epi32(sums, _mm_set1_epi32(1 << (fractionBits - 1)));
+    sums = _mm_sra_epi32(sums, _mm_cvtsi32_si128(fractionBits));
+    return _mm_packs_epi32(sums, sums);
+}
+
+inline void storeOutputs(__m128i packed, int16_t* output, int stride) {
+    if (stride == 1) {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(output), packed);
+        return;
+    }
+    output[0] = static_cast<int16_t>(_mm_extract_epi16(packed, 0));
+    output[stride] = static_cast<int16_t>(_mm_extract_epi16(packed, 1));
+    output[2 * stride] = static_cast<int16_t>(_mm_extract_epi16(packed, 2));
+    output[3 * stride] = static_cast<int16_t>(_mm_extract_epi16(packed, 3));
+}
+
+inline __m128i dotSse2(const int16_t* x, const int16_t* h, int taps) {
+    __m128i acc = _mm_setzero_si128();
+    for (int i = 0; i < taps; i += 8) {
+        __m128i xv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+        __m128i hv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(xv, hv));
+    }
+    return acc;
+}
+
+/**
+ * Outputs go in groups that share one transpose-and-round; the tail goes
+ * one at a time. Taps of 0 takes the row length from the filter; a length
+ * fixed at compile time unrolls the tap loop.
+ */
+template <int Taps>
+size_t filterSse2(const PolyphaseFilter& filter, const int16_t* history, size_t length,
+                  size_t& next, int& phase, int16_t* output, int stride) {
+    const int taps = Taps ? Taps : filter.taps;
+    const int bits = filter.fractionBits;
+    const int16_t* rows = filter.coefficients.data();
+    const int* advance = filter.advance.data();
+    const int* nextPhase = filter.nextPhase.data();
+    const auto* steps = filter.steps.data();
+    const int16_t* window = history - (taps - 1);
+    size_t end = next;
+    int p = phase;
+    size_t n = 0;
+    while (end + steps[p].offset[kOutputsPerStep - 1] < length) {
+        const auto& step = steps[p];
+        const int16_t* x = window + end;
+        __m128i packed = finishOutputs(dotSse2(x, rows + static_cast<size_t>(step.phase[0]) * taps, taps),
+                                       dotSse2(x + step.offset[1], rows + static_cast<size_t>(step.phase[1]) * taps, taps),
+                                       dotSse2(x + step.offset[2], rows + static_cast<size_t>(step.phase[2]) * taps, taps),
+                                       dotSse2(x + step.offset[3], rows + static_cast<size_t>(step.phase[3]) * taps, taps),
+                                       bits);
+        storeOutputs(packed, output + n * stride, stride);
+        n += kOutputsPerStep;
+        end += step.advance;
+        p = step.nextPhase;
+    }
+    const __m128i zero = _mm_setzero_si128();
+    for (; end < length; ++n) {
+        __m128i acc = dotSse2(window + end, rows + static_cast<size_t>(p) * taps, taps);
+        output[n * stride] = static_cast<int16_t>(_mm_cvtsi128_si32(finishOutputs(acc, zero, zero, zero, bits)));
+        end += advance[p];
+        p = nextPhase[p];
+    }
+    next = end;
+    phase = p;
+    return n;
+}
+
+/**
+ * Decimation by a whole factor has a single phase: every window is Down
+ * frames after the last and uses the one coefficient row. With the factor
+ * and length fixed at compile time the tap loop unrolls fully, and each
+ * coefficient load serves four outputs.
+ */
+template <int Down, int Taps>
+size_t decimateSse2(const PolyphaseFilter& filter, const int16_t* history, size_t length,
+                    size_t& next, int& /*phase*/, int16_t* output, int stride) {
+    static_assert(Taps % 8 == 0, "rows are padded to whole vectors");
+    const int bits = filter.fractionBits;
+    const int16_t* h = filter.coefficients.data();
+    const int16_t* window = history - (Taps - 1);
+    size_t end = next;
+    size_t n = 0;
+    for (; end + 3 * Down < length; end += 4 * Down, n += kOutputsPerStep) {
+        const int16_t* x = window + end;
+        __m128i a = _mm_setzero_si128();
+        __m128i b = _mm_setzero_si128();
+        __m128i c = _mm_setzero_si128();
+        __m128i d = _mm_setzero_si128();
+        for (int i = 0; i < Taps; i += 8) {
+            __m128i hv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+            a = _mm_add_epi32(a, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)), hv));
+            b = _mm_add_epi32(b, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + Down + i)), hv));
+            c = _mm_add_epi32(c, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + 2 * Down + i)), hv));
+            d = _mm_add_epi32(d, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + 3 * Down + i)), hv));
+        }
+        storeOutputs(finishOutputs(a, b, c, d, bits), output + n * stride, stride);
+    }
+    const __m128i zero = _mm_setzero_si128();
+    for (; end < length; end += Down, ++n) {
+        __m128i acc = dotSse2(window + end, h, Taps);
+        output[n * stride] = static_cast<int16_t>(_mm_cvtsi128_si32(finishOutputs(acc, zero, zero, zero, bits)));
+    }
+    next = end;
+    return n;
+}
+
+#endif
+
+#ifdef JARVIS_RESAMPLER_AVX2
+
+__attribute__((target("avx2")))
+inline __m128i dotAvx2(const int16_t* x, const int16_t* h, int taps) {
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 16 <= taps; i += 16) {
+        __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+        __m256i hv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(xv, hv));
+    }
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    if (i < taps) {
+        __m128i xv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+        __m128i hv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(xv, hv));
+    }
+    return sum;
+}
+
+// Same as filterSse2 with 16 taps per multiply-accumulate
+template <int Taps>
+__attribute__((target("avx2")))
+size_t filterAvx2(const PolyphaseFilter& filter, const int16_t* history, size_t length,
+                  size_t& next, int& phase, int16_t* output, int stride) {
+    const int taps = Taps ? Taps : filter.taps;
+    const int bits = filter.fractionBits;
+    const int16_t* rows = filter.coefficients.data();
+    const int* advance = filter.advance.data();
+    const int* nextPhase = filter.nextPhase.data();
+    const auto* steps = filter.steps.data();
+    const int16_t* window = history - (taps - 1);
+    size_t end = next;
+    int p = phase;
+    size_t n = 0;
+    while (end + steps[p].offset[kOutputsPerStep - 1] < length) {
+        const auto& step = steps[p];
+        const int16_t* x = window + end;
+        __m128i packed = finishOutputs(dotAvx2(x, rows + static_cast<size_t>(step.phase[0]) * taps, taps),
+                                       dotAvx2(x + step.offset[1], rows + static_cast<size_t>(step.phase[1]) * taps, taps),
+                                       dotAvx2(x + step.offset[2], rows + static_cast<size_t>(step.phase[2]) * taps, taps),
+                                       dotAvx2(x + step.offset[3], rows + static_cast<size_t>(step.phase[3]) * taps, taps),
+                                       bits);
+        storeOutputs(packed, output + n * stride, stride);
+        n += kOutputsPerStep;
+        end += step.advance;
+        p = step.nextPhase;
+    }
+    const __m128i zero = _mm_setzero_si128();
+    for (; end < length; ++n) {
+        __m128i acc = dotAvx2(window + end, rows + static_cast<size_t>(p) * taps, taps);
+        output[n * stride] = static_cast<int16_t>(_mm_cvtsi128_si32(finishOutputs(acc, zero, zero, zero, bits)));
+        end += advance[p];
+        p = nextPhase[p];
+    }
+    next = end;
+    phase = p;
+    return n;
+}
+
+// Same as decimateSse2 with 16 taps per multiply-accumulate
+template <int Down, int Taps>
+__attribute__((target("avx2")))
+size_t decimateAvx2(const PolyphaseFilter& filter, const int16_t* history, size_t length,
+                    size_t& next, int& /*phase*/, int16_t* output, int stride) {
+    static_assert(Taps % 8 == 0, "rows are padded to whole vectors");
+    const int bits = filter.fractionBits;
+    const int16_t* h = filter.coefficients.data();
+    const int16_t* window = history - (Taps - 1);
+    size_t end = next;
+    size_t n = 0;
+    for (; end + 3 * Down < length; end += 4 * Down, n += kOutputsPerStep) {
+        const int16_t* x = window + end;
+        __m256i a = _mm256_setzero_si256();
+        __m256i b = _mm256_setzero_si256();
+        __m256i c = _mm256_setzero_si256();
+        __m256i d = _mm256_setzero_si256();
+        for (int i = 0; i + 16 <= Taps; i += 16) {
+            __m256i hv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i));
+            a = _mm256_add_epi32(a, _mm256_madd_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i)), hv));
+            b = _mm256_add_epi32(b, _mm256_madd_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + Down + i)), hv));
+            c = _mm256_add_epi32(c, _mm256_madd_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + 2 * Down + i)), hv));
+            d = _mm256_add_epi32(d, _mm256_madd_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + 3 * Down + i)), hv));
+        }
+        __m128i a4 = _mm_add_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+        __m128i b4 = _mm_add_epi32(_mm256_castsi256_si128(b), _mm256_extracti128_si256(b, 1));
+        __m128i c4 = _mm_add_epi32(_mm256_castsi256_si128(c), _mm256_extracti128_si256(c, 1));
+        __m128i d4 = _mm_add_epi32(_mm256_castsi256_si128(d), _mm256_extracti128_si256(d, 1));
+        if constexpr (Taps % 16 != 0) {
+            constexpr int i = Taps - 8;
+            __m128i hv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+            a4 = _mm_add_epi32(a4, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)), hv));
+            b4 = _mm_add_epi32(b4, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + Down + i)), hv));
+            c4 = _mm_add_epi32(c4, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + 2 * Down + i)), hv));
+            d4 = _mm_add_epi32(d4, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + 3 * Down + i)), hv));
+        }
+        storeOutputs(finishOutputs(a4, b4, c4, d4, bits), output + n * stride, stride);
+    }
+    const __m128i zero = _mm_setzero_si128();
+    for (; end < length; end += Down, ++n) {
+        __m128i acc = dotAvx2(window + end, h, Taps);
+        output[n * stride] = static_cast<int16_t>(_mm_cvtsi128_si32(finishOutputs(acc, zero, zero, zero, bits)));
+    }
+    next = end;
+    return n;
+}
+
+bool hasAvx2() {
+    return __builtin_cpu_supports("avx2");
+}
+
+#endif
+
+#ifdef JARVIS_RESAMPLER_SSE2
+
+template <int Taps>
+FilterLoop polyphase() {
+#ifdef JARVIS_RESAMPLER_AVX2
+    if (hasAvx2()) {
+        return filterAvx2<Taps>;
+    }
+#endif
+    return filterSse2<Taps>;
+}
+
+#endif
+
+/**
+ * Any ratio without a specialized decimator. The row lengths the quality
+ * levels give at 44.1k and 22.05k (16, 24, 48 and 96 taps) get the loop
+ * unrolled for them; at 44.1k Balanced that is what keeps the 160-phase
+ * filter ahead of linear interpolation.
+ */
+FilterLoop selectFilterLoop([[maybe_unused]] int taps) {
+#ifdef JARVIS_RESAMPLER_SSE2
+    switch (taps) {
+        case 16: return polyphase<16>();
+        case 24: return polyphase<24>();
+        case 48: return polyphase<48>();
+        case 96: return polyphase<96>();
+        default: return polyphase<0>();
+    }
+#else
+    return filterScalar;
+#endif
+}
+
+#ifdef JARVIS_RESAMPLER_SSE2
+
+template <int Down, int Taps>
+FilterLoop decimator() {
+#ifdef JARVIS_RESAMPLER_AVX2
+    if (hasAvx2()) {
+        return decimateAvx2<Down, Taps>;
+    }
+#endif
+    return decimateSse2<Down, Taps>;
+}
+
+// Row length of a Down:1 decimator with the given sinc lobes, as filterLength() pads it
+constexpr int decimatorTaps(int down, int zeroCrossings) {
+    return (2 * zeroCrossings * down + kTapAlignment - 1) / kTapAlignment * kTapAlignment;
+}
+
+// Specialized kernel for Down:1 at one of the quality levels' filter lengths
+template <int Down>
+FilterLoop selectDecimator(int taps) {
+    switch (taps) {
+        case decimatorTaps(Down, 4): return decimator<Down, decimatorTaps(Down, 4)>();
+        case decimatorTaps(Down, 8): return decimator<Down, decimatorTaps(Down, 8)>();
+        case decimatorTaps(Down, 16): return decimator<Down, decimatorTaps(Down, 16)>();
+        default: return nullptr;
+    }
+}
+
+#endif
+
+FilterLoop selectLoop([[maybe_unused]] const PolyphaseFilter& filter) {
+    FilterLoop loop = nullptr;
+#ifdef JARVIS_RESAMPLER_SSE2
+    if (filter.up == 1 && filter.down == 2) {
+        loop = selectDecimator<2>(filter.taps);
+    } else if (filter.up == 1 && filter.down == 3) {
+        loop = selectDecimator<3>(filter.taps);
+    }
+#endif
+    return loop ? loop : selectFilterLoop(filter.taps);
+}
+
+} // namespace
+
+struct AudioResampler::FilterBank : PolyphaseFilter {};
+
+AudioResampler::AudioResampler(int inputRate, int outputRate, int channels, Quality quality)
+    : inputRate_(inputRate), outputRate_(outputRate), channels_(std::max(1, channels)), quality_(quality),
+      history_(channels_) {
+    if (inputRate_ != outputRate_) {
+        bank_ = getFilterBank(inputRate_, outputRate_, quality_);
+    }
+    reset();
+}
+
+AudioResampler::~AudioResampler() = default;
+
+int AudioResampler::filterLength(int inputRate, int outputRate, Quality quality) {
+    // Enough lobes of the narrower sinc; downsampling stretches it over more input frames
+    double stretch = std::max(1.0, static_cast<double>(inputRate) / outputRate);
+    int taps = static_cast<int>(std::ceil(2 * paramsFor(quality).zeroCrossings * stretch));
+    return (taps + kTapAlignment - 1) / kTapAlignment * kTapAlignment;
+}
+
+std::shared_ptr<const AudioResampler::FilterBank>
+AudioResampler::getFilterBank(int inputRate, int outputRate, Quality quality) {
+    static std::mutex mutex;
+    static std::map<std::tuple<int, int, Quality>, std::shared_ptr<const FilterBank>> cache;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto key = std::make_tuple(inputRate, outputRate, quality);
+    if (auto it = cache.find(key); it != cache.end()) {
+        return it->second;
+    }
+
+    auto bank = std::make_shared<FilterBank>();
+    int divisor = std::gcd(inputRate, outputRate);
+    bank->up = outputRate / divisor;
+    bank->down = inputRate / divisor;
+    bank->taps = filterLength(inputRate, outputRate, quality);
+    // Downsampling taps stay below 1.0 and fit Q15; an upsampling filter
+    // has a unity centre tap, so it drops to Q14
+    bank->fractionBits = bank->down > bank->up ? 15 : 14;
+
+    // Prototype lowpass at the upsampled rate inputRate * L, taps * L long
+    const QualityParams params = paramsFor(quality);
+    const int up = bank->up;
+    const int taps = bank->taps;
+    const int length = taps * up;
+    const double centre = (length - 1) / 2.0;
+    const double cutoff = params.rolloff * std::min(inputRate, outputRate) / 2.0 /
+                          (static_cast<double>(inputRate) * up);
+    const double windowNorm = besselI0(params.beta);
+    bank->delay = centre / up;
+
+    std::vector<double> prototype(length);
+    for (int n = 0; n < length; ++n) {
+        double t = n - centre;
+        double sinc = t == 0.0 ? 1.0 : std::sin(2.0 * std::numbers::pi * cutoff * t) /
+                                       (2.0 * std::numbers::pi * cutoff * t);
+        double r = t / (centre + 0.5);
+        double window = besselI0(params.beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / windowNorm;
+        prototype[n] = sinc * window;
+    }
+
+    // Phase p weighs the newest frame with prototype[p], the one before with prototype[p + L], ...
+    // Each row is scaled to unity DC gain and rounded so it sums to exactly 1.0
+    bank->coefficients.resize(static_cast<size_t>(up) * taps);
+    const int one = 1 << bank->fractionBits;
+    for (int p = 0; p < up; ++p) {
+        int16_t* row = &bank->coefficients[static_cast<size_t>(p) * taps];
+        double sum = 0.0;
+        for (int m = 0; m < taps; ++m) {
+            sum += prototype[p + static_cast<size_t>(taps - 1 - m) * up];
+        }
+        int total = 0;
+        int peak = 0;
+        for (int m = 0; m < taps; ++m) {
+            double value = prototype[p + static_cast<size_t>(taps - 1 - m) * up] / sum;
+            row[m] = static_cast<int16_t>(std::lround(value * one));
+            total += row[m];
+            if (std::abs(row[m]) > std::abs(row[peak])) {
+                peak = m;
+            }
+        }
+        row[peak] = static_cast<int16_t>(row[peak] + (one - total));
+    }
+
+    bank->nextPhase.resize(up);
+    bank->advance.resize(up);
+    for (int p = 0; p < up; ++p) {
+        bank->nextPhase[p] = (p + bank->down) % up;
+        bank->advance[p] = (p + bank->down) / up;
+    }
+    bank->steps.resize(up);
+    for (int p = 0; p < up; ++p) {
+        auto& step = bank->steps[p];
+        int offset = 0;
+        int phase = p;
+        for (int k = 0; k < kOutputsPerStep; ++k) {
+            step.offset[k] = offset;
+            step.phase[k] = phase;
+            offset += bank->advance[phase];
+            phase = bank->nextPhase[phase];
+        }
+        step.advance = offset;
+        step.nextPhase = phase;
+    }
+    bank->loop = selectLoop(*bank);
+
+    cache.emplace(key, bank);
+    return bank;
+}
+
+size_t AudioResampler::resample(std::span<const int16_t> input, std::span<int16_t> output) {
+    const size_t inputFrames = input.size() / channels_;
+    if (output.size() < maxOutputFrames(inputFrames) * channels_) {
+        return 0;
+    }
+    if (!bank_) {
+        if (output.data() != input.data()) {
+            std::memcpy(output.data(), input.data(), inputFrames * channels_ * sizeof(int16_t));
+        }
+        return inputFrames;
+    }
+
+    const FilterBank& bank = *bank_;
+    const size_t length = kept_ + inputFrames;
+
+    size_t frames = 0;
+    size_t next = next_;
+    int phase = phase_;
+    for (int c = 0; c < channels_; ++c) {
+        auto& history = history_[c];
+        if (history.size() < length) {
+            history.resize(length);
+        }
+        if (channels_ == 1) {
+            std::memcpy(history.data() + kept_, input.data(), inputFrames * sizeof(int16_t));
+        } else {
+            for (size_t i = 0; i < inputFrames; ++i) {
+                history[kept_ + i] = input[i * channels_ + c];
+            }
+        }
+
+        // Every channel walks the same phases; each starts from the saved position
+        next = next_;
+        phase = phase_;
+        frames = bank.loop(bank, history.data(), length, next, phase, output.data() + c, channels_);
+    }
+
+    // Keep the taps-1 frames before the next window; when downsampling
+    // hard the next window can start beyond this block
+    size_t consumed = std::min(next - (bank.taps - 1), length);
+    kept_ = length - consumed;
+    for (auto& history : history_) {
+        std::memmove(history.data(), history.data() + consumed, kept_ * sizeof(int16_t));
+    }
+    next_ = next - consumed;
+    phase_ = phase;
+
+    return frames;
+}
+
+std::vector<int16_t> AudioResampler::resample(const int16_t* input, size_t inputFrames) {
+    std::vector<int16_t> output(maxOutputFrames(inputFrames) * channels_);
+    size_t frames = resample({input, inputFrames * channels_}, output);
+    output.resize(frames * channels_);
+    return output;
+}
+
+void AudioResampler::reset() {
+    next_ = 0;
+    phase_ = 0;
+    kept_ = 0;
+    if (bank_) {
+        // Start with silent history so the first output needs no special case
+        next_ = kept_ = bank_->taps - 1;
+        for (auto& history : history_) {
+            history.assign(kept_, 0);
+        }
+    }
+}
+
+size_t AudioResampler::maxOutputFrames(size_t inputFrames) const {
+    if (!bank_) {
+        return inputFrames;
+    }
+    return (inputFrames + 1) * bank_->up / bank_->down + 1;
+}
+
+double AudioResampler::getLatencyFrames() const {
+    return bank_ ? bank_->delay : 0.0;
+}
+
+} // namespace jarvis
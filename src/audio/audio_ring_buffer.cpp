@@ -0,0 +1,221 @@
+#include "audio/audio_ring_buffer.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace jarvis {
+
+AudioRingBuffer::AudioRingBuffer(size_t capacity, OverflowPolicy policy,
+                                 std::chrono::milliseconds blockTimeout)
+    : capacity_(std::bit_ceil(std::max<size_t>(capacity, 1))),
+      mask_(capacity_ - 1),
+      policy_(policy),
+      blockTimeout_(blockTimeout),
+      buffer_(capacity_) {
+}
+
+AudioRingBuffer::~AudioRingBuffer() = default;
+
+bool AudioRingBuffer::write(const int16_t* data, size_t count) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+
+    // Under DropOldest only the newest capacity() samples can survive anyway
+    size_t skipped = 0;
+    if (count > capacity_ && policy_ == OverflowPolicy::DropOldest) {
+        skipped = count - capacity_;
+        data += skipped;
+        count = capacity_;
+    }
+
+    if (!makeRoom(tail, count)) {
+        recordOverflow(count);
+        return false; // Buffer overflow
+    }
+    if (skipped > 0) {
+        droppedSamples_.fetch_add(skipped, std::memory_order_relaxed);
+    }
+
+    // Split the copy at the wrap point
+    size_t offset = tail & mask_;
+    size_t first = std::min(count, capacity_ - offset);
+    std::memcpy(buffer_.data() + offset, data, first * sizeof(int16_t));
+    std::memcpy(buffer_.data(), data + first, (count - first) * sizeof(int16_t));
+
+    tail_.store(tail + count, std::memory_order_release);
+    updateHighWater(tail + count);
+    dataSignal_.notify(tail + count);
+    return true;
+}
+
+size_t AudioRingBuffer::read(int16_t* buffer, size_t count) {
+    for (;;) {
+        size_t head = head_.load(std::memory_order_acquire);
+        if (cachedTail_ < head + count) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+        }
+        size_t toRead = std::min(count, cachedTail_ - head);
+
+        size_t offset = head & mask_;
+        size_t first = std::min(toRead, capacity_ - offset);
+        std::memcpy(buffer, buffer_.data() + offset, first * sizeof(int16_t));
+        std::memcpy(buffer + first, buffer_.data(), (toRead - first) * sizeof(int16_t));
+
+        // Under DropOldest the producer may have discarded what we copied; start over
+        if (advanceHead(head, toRead)) {
+            return toRead;
+        }
+    }
+}
+
+std::span<int16_t> AudioRingBuffer::acquireWrite(size_t count) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (capacity_ - (tail - cachedHead_) < count) {
+        cachedHead_ = head_.load(std::memory_order_acquire);
+    }
+    size_t offset = tail & mask_;
+    size_t n = std::min({count, capacity_ - (tail - cachedHead_), capacity_ - offset});
+    return {buffer_.data() + offset, n};
+}
+
+void AudioRingBuffer::commitWrite(size_t count) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    tail_.store(tail + count, std::memory_order_release);
+    updateHighWater(tail + count);
+    dataSignal_.notify(tail + count);
+}
+
+std::span<const int16_t> AudioRingBuffer::acquireRead(size_t count) {
+    size_t head = head_.load(std::memory_order_acquire);
+    if (cachedTail_ < head + count) {
+        cachedTail_ = tail_.load(std::memory_order_acquire);
+    }
+    acquiredHead_ = head;
+    size_t offset = head & mask_;
+    size_t n = std::min({count, cachedTail_ - head, capacity_ - offset});
+    return {buffer_.data() + offset, n};
+}
+
+bool AudioRingBuffer::commitRead(size_t count) {
+    if (policy_ != OverflowPolicy::DropOldest) {
+        return advanceHead(head_.load(std::memory_order_relaxed), count);
+    }
+    return advanceHead(acquiredHead_, count);
+}
+
+bool AudioRingBuffer::waitForAvailable(size_t count, std::chrono::milliseconds timeout) {
+    if (available() >= count) {
+        return true;
+    }
+    size_t target = head_.load(std::memory_order_relaxed) + count;
+    return dataSignal_.wait(target, [this, count]() { return available() >= count; }, timeout);
+}
+
+size_t AudioRingBuffer::available() const {
+    size_t head = head_.load(std::memory_order_acquire);
+    size_t tail = tail_.load(std::memory_order_acquire);
+    return tail - head;
+}
+
+size_t AudioRingBuffer::freeSpace() const {
+    return capacity_ - available();
+}
+
+void AudioRingBuffer::clear() {
+    size_t tail = tail_.load(std::memory_order_acquire);
+    size_t head = head_.load(std::memory_order_acquire);
+    while (head < tail && !advanceHead(head, tail - head)) {
+        head = head_.load(std::memory_order_acquire);
+    }
+}
+
+AudioRingBuffer::Stats AudioRingBuffer::getStats() const {
+    Stats stats;
+    stats.droppedSamples = droppedSamples_.load(std::memory_order_relaxed);
+    stats.overflows = overflows_.load(std::memory_order_relaxed);
+    stats.highWaterMark = highWaterMark_.load(std::memory_order_relaxed);
+    stats.stallTime = std::chrono::nanoseconds(stallNanos_.load(std::memory_order_relaxed));
+    return stats;
+}
+
+bool AudioRingBuffer::hasRoom(size_t tail, size_t count) {
+    if (capacity_ - (tail - cachedHead_) >= count) {
+        return true;
+    }
+    cachedHead_ = head_.load(std::memory_order_acquire);
+    return capacity_ - (tail - cachedHead_) >= count;
+}
+
+bool AudioRingBuffer::makeRoom(size_t tail, size_t count) {
+    if (count > capacity_) {
+        return false;
+    }
+    if (hasRoom(tail, count)) {
+        return true;
+    }
+
+    switch (policy_) {
+        case OverflowPolicy::DropNewest:
+            return false;
+
+        case OverflowPolicy::DropOldest: {
+            // Push the read index past the samples we are about to overwrite
+            size_t needed = tail + count - capacity_;
+            size_t head = cachedHead_;
+            while (head < needed &&
+                   !head_.compare_exchange_weak(head, needed, std::memory_order_acq_rel,
+                                                std::memory_order_acquire)) {
+            }
+            if (head < needed) {
+                droppedSamples_.fetch_add(needed - head, std::memory_order_relaxed);
+                overflows_.fetch_add(1, std::memory_order_relaxed);
+            }
+            cachedHead_ = std::max(head, needed);
+            return true;
+        }
+
+        case OverflowPolicy::Block: {
+            auto start = std::chrono::steady_clock::now();
+            bool ready = spaceSignal_.wait(tail + count - capacity_, [this, tail, count]() {
+                return capacity_ - (tail - head_.load(std::memory_order_acquire)) >= count;
+            }, blockTimeout_);
+            auto stalled = std::chrono::steady_clock::now() - start;
+            stallNanos_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(stalled).count(),
+                                  std::memory_order_relaxed);
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            return ready;
+        }
+    }
+    return false;
+}
+
+void AudioRingBuffer::recordOverflow(size_t dropped) {
+    droppedSamples_.fetch_add(dropped, std::memory_order_relaxed);
+    overflows_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioRingBuffer::updateHighWater(size_t tail) {
+    // cachedHead_ may be stale, which only overestimates; confirm before recording
+    if (tail - cachedHead_ <= highWaterMark_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    cachedHead_ = head_.load(std::memory_order_acquire);
+    size_t fill = tail - cachedHead_;
+    if (fill > highWaterMark_.load(std::memory_order_relaxed)) {
+        highWaterMark_.store(fill, std::memory_order_relaxed);
+    }
+}
+
+bool AudioRingBuffer::advanceHead(size_t head, size_t count) {
+    if (policy_ != OverflowPolicy::DropOldest) {
+        head_.store(head + count, std::memory_order_release);
+    } else if (!head_.compare_exchange_strong(head, head + count, std::memory_order_acq_rel,
+                                              std::memory_order_relaxed)) {
+        return false;
+    }
+    if (policy_ == OverflowPolicy::Block) {
+        spaceSignal_.notify(head + count);
+    }
+    return true;
+}
+
+} // namespace jarvis
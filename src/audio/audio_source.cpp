@@ -0,0 +1,275 @@
+#include "audio/audio_source.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+
+namespace jarvis {
+
+namespace {
+
+uint32_t readLE32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint16_t readLE16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+void writeLE32(uint8_t* p, uint32_t v) {
+    p[0] = v & 0xff; p[1] = (v >> 8) & 0xff; p[2] = (v >> 16) & 0xff; p[3] = (v >> 24) & 0xff;
+}
+
+void writeLE16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xff; p[1] = (v >> 8) & 0xff;
+}
+
+size_t framesFor(int sampleRate, int durationMs) {
+    return durationMs > 0 ? static_cast<size_t>(sampleRate) * durationMs / 1000 : SIZE_MAX;
+}
+
+} // namespace
+
+// FileAudioSource implementation
+FileAudioSource::FileAudioSource() = default;
+
+FileAudioSource::~FileAudioSource() {
+    close();
+}
+
+bool FileAudioSource::open(const std::string& path, int rawSampleRate, int rawChannels) {
+    close();
+
+    file_ = std::fopen(path.c_str(), "rb");
+    if (!file_) {
+        LOG_ERROR("Failed to open audio file: " + path);
+        return false;
+    }
+
+    std::fseek(file_, 0, SEEK_END);
+    long fileSize = std::ftell(file_);
+    std::fseek(file_, 0, SEEK_SET);
+
+    uint8_t header[12];
+    bool isWav = std::fread(header, 1, sizeof(header), file_) == sizeof(header) &&
+                 std::memcmp(header, "RIFF", 4) == 0 && std::memcmp(header + 8, "WAVE", 4) == 0;
+
+    if (!isWav) {
+        // Headerless PCM16
+        sampleRate_ = rawSampleRate;
+        channels_ = rawChannels;
+        dataOffset_ = 0;
+        dataFrames_ = static_cast<size_t>(fileSize) / (sizeof(int16_t) * channels_);
+        return rewind();
+    }
+
+    // Walk the chunks until we have both fmt and data
+    bool haveFormat = false;
+    uint8_t chunk[8];
+    while (std::fread(chunk, 1, sizeof(chunk), file_) == sizeof(chunk)) {
+        uint32_t chunkSize = readLE32(chunk + 4);
+        long chunkStart = std::ftell(file_);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0) {
+            uint8_t fmt[16];
+            if (chunkSize < sizeof(fmt) || std::fread(fmt, 1, sizeof(fmt), file_) != sizeof(fmt)) {
+                break;
+            }
+            uint16_t audioFormat = readLE16(fmt);
+            uint16_t bitsPerSample = readLE16(fmt + 14);
+            if ((audioFormat != 1 && audioFormat != 0xFFFE) || bitsPerSample != 16) {
+                LOG_ERROR("Unsupported WAV format (only PCM16 is supported): " + path);
+                close();
+                return false;
+            }
+            channels_ = readLE16(fmt + 2);
+            sampleRate_ = static_cast<int>(readLE32(fmt + 4));
+            haveFormat = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0 && haveFormat) {
+            dataOffset_ = chunkStart;
+            uint32_t available = static_cast<uint32_t>(fileSize - chunkStart);
+            dataFrames_ = std::min(chunkSize, available) / (sizeof(int16_t) * channels_);
+            return rewind();
+        }
+
+        // Chunks are word aligned
+        std::fseek(file_, chunkStart + chunkSize + (chunkSize & 1), SEEK_SET);
+    }
+
+    LOG_ERROR("Malformed WAV file: " + path);
+    close();
+    return false;
+}
+
+void FileAudioSource::close() {
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+    dataFrames_ = 0;
+    position_ = 0;
+}
+
+size_t FileAudioSource::read(int16_t* buffer, size_t frames) {
+    if (!file_) return 0;
+
+    // PCM16 files are little-endian, as are all hosts we build for
+    size_t toRead = std::min(frames, dataFrames_ - position_);
+    size_t got = std::fread(buffer, sizeof(int16_t) * channels_, toRead, file_);
+    position_ += got;
+    return got;
+}
+
+bool FileAudioSource::rewind() {
+    if (!file_) return false;
+    position_ = 0;
+    return std::fseek(file_, dataOffset_, SEEK_SET) == 0;
+}
+
+bool FileAudioSource::writeWav(const std::string& path, const int16_t* samples, size_t frames,
+                               int sampleRate, int channels) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        LOG_ERROR("Failed to create audio file: " + path);
+        return false;
+    }
+
+    uint32_t dataBytes = static_cast<uint32_t>(frames * channels * sizeof(int16_t));
+    uint8_t header[44];
+    std::memcpy(header, "RIFF", 4);
+    writeLE32(header + 4, 36 + dataBytes);
+    std::memcpy(header + 8, "WAVEfmt ", 8);
+    writeLE32(header + 16, 16);
+    writeLE16(header + 20, 1);
+    writeLE16(header + 22, static_cast<uint16_t>(channels));
+    writeLE32(header + 24, static_cast<uint32_t>(sampleRate));
+    writeLE32(header + 28, static_cast<uint32_t>(sampleRate * channels * sizeof(int16_t)));
+    writeLE16(header + 32, static_cast<uint16_t>(channels * sizeof(int16_t)));
+    writeLE16(header + 34, 16);
+    std::memcpy(header + 36, "data", 4);
+    writeLE32(header + 40, dataBytes);
+
+    bool ok = std::fwrite(header, 1, sizeof(header), file) == sizeof(header) &&
+              std::fwrite(samples, sizeof(int16_t), frames * channels, file) == frames * channels;
+    std::fclose(file);
+    return ok;
+}
+
+// ToneSource implementation
+ToneSource::ToneSource(int sampleRate, int channels, double frequencyHz,
+                       double amplitude, int durationMs)
+    : sampleRate_(sampleRate), channels_(channels),
+      phaseStep_(2.0 * std::numbers::pi * frequencyHz / sampleRate),
+      amplitude_(std::clamp(amplitude, 0.0, 1.0) * 32767.0),
+      totalFrames_(framesFor(sampleRate, durationMs)) {
+}
+
+size_t ToneSource::read(int16_t* buffer, size_t frames) {
+    size_t toRead = std::min(frames, totalFrames_ - position_);
+    for (size_t i = 0; i < toRead; ++i) {
+        auto sample = static_cast<int16_t>(amplitude_ * std::sin(phase_));
+        for (int c = 0; c < channels_; ++c) {
+            *buffer++ = sample;
+        }
+        phase_ += phaseStep_;
+        if (phase_ >= 2.0 * std::numbers::pi) {
+            phase_ -= 2.0 * std::numbers::pi;
+        }
+    }
+    position_ += toRead;
+    return toRead;
+}
+
+bool ToneSource::rewind() {
+    position_ = 0;
+    phase_ = 0.0;
+    return true;
+}
+
+// NoiseSource implementation
+NoiseSource::NoiseSource(int sampleRate, int channels, double amplitude,
+                         int durationMs, uint32_t seed)
+    : sampleRate_(sampleRate), channels_(channels),
+      amplitude_(amplitude * 32767.0),
+      totalFrames_(framesFor(sampleRate, durationMs)),
+      seed_(seed), rng_(seed) {
+}
+
+size_t NoiseSource::read(int16_t* buffer, size_t frames) {
+    size_t toRead = std::min(frames, totalFrames_ - position_);
+    for (size_t i = 0; i < toRead * channels_; ++i) {
+        double sample = amplitude_ * distribution_(rng_);
+        buffer[i] = static_cast<int16_t>(std::clamp(sample, -32768.0, 32767.0));
+    }
+    position_ += toRead;
+    return toRead;
+}
+
+bool NoiseSource::rewind() {
+    position_ = 0;
+    rng_.seed(seed_);
+    distribution_.reset();
+    return true;
+}
+
+// LoopingSource implementation
+LoopingSource::LoopingSource(std::vector<std::unique_ptr<AudioSource>> sources, int loops)
+    : sources_(std::move(sources)), loops_(loops) {
+}
+
+int LoopingSource::getSampleRate() const {
+    return sources_.empty() ? 16000 : sources_.front()->getSampleRate();
+}
+
+int LoopingSource::getChannels() const {
+    return sources_.empty() ? 1 : sources_.front()->getChannels();
+}
+
+size_t LoopingSource::read(int16_t* buffer, size_t frames) {
+    size_t total = 0;
+    size_t emptyItems = 0;
+    int channels = getChannels();
+
+    while (total < frames && !sources_.empty()) {
+        if (loops_ > 0 && completedLoops_ >= loops_) {
+            break;
+        }
+
+        size_t got = sources_[current_]->read(buffer + total * channels, frames - total);
+        total += got;
+        if (got > 0) {
+            emptyItems = 0;
+            continue;
+        }
+
+        // A whole pass without audio would otherwise spin forever
+        if (++emptyItems > sources_.size()) {
+            break;
+        }
+
+        // Current item exhausted: move to the next, wrapping at the end of the corpus
+        if (!sources_[current_]->rewind()) {
+            LOG_WARNING("Looping source item cannot be rewound; stopping");
+            sources_.clear();
+            break;
+        }
+        if (++current_ == sources_.size()) {
+            current_ = 0;
+            ++completedLoops_;
+        }
+    }
+    return total;
+}
+
+bool LoopingSource::rewind() {
+    for (auto& source : sources_) {
+        if (!source->rewind()) return false;
+    }
+    current_ = 0;
+    completedLoops_ = 0;
+    return true;
+}
+
+} // namespace jarvis
@@ -0,0 +1,183 @@
+#include "audio/channel_mixer.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define JARVIS_MIXER_SSE2 1
+#endif
+
+namespace jarvis {
+
+namespace {
+
+int16_t saturate(float value) {
+    return static_cast<int16_t>(std::clamp(std::lrintf(value), -32768L, 32767L));
+}
+
+void deinterleaveScalar(const int16_t* in, size_t begin, size_t frames, int channels,
+                        int16_t* const* planes) {
+    for (size_t i = begin; i < frames; ++i) {
+        for (int c = 0; c < channels; ++c) {
+            planes[c][i] = in[i * channels + c];
+        }
+    }
+}
+
+#ifdef JARVIS_MIXER_SSE2
+
+// 8 stereo frames per iteration: even samples are left, odd are right
+size_t deinterleaveStereo(const int16_t* in, size_t frames, int16_t* left, int16_t* right) {
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i + 8));
+        // Sign-extend each half of every 32-bit pair, then pack back to 16 bits
+        __m128i l = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+                                    _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+        __m128i r = _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(left + i), l);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(right + i), r);
+    }
+    return i;
+}
+
+// 8 four-channel frames per iteration: a 4x8 transpose in three unpack rounds
+size_t deinterleaveQuad(const int16_t* in, size_t frames, int16_t* const* planes) {
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        const __m128i* src = reinterpret_cast<const __m128i*>(in + 4 * i);
+        __m128i a = _mm_loadu_si128(src);       // frames 0-1
+        __m128i b = _mm_loadu_si128(src + 1);   // frames 2-3
+        __m128i c = _mm_loadu_si128(src + 2);   // frames 4-5
+        __m128i d = _mm_loadu_si128(src + 3);   // frames 6-7
+
+        __m128i ab0 = _mm_unpacklo_epi16(a, b); // f0 f2 per channel
+        __m128i ab1 = _mm_unpackhi_epi16(a, b); // f1 f3 per channel
+        __m128i cd0 = _mm_unpacklo_epi16(c, d);
+        __m128i cd1 = _mm_unpackhi_epi16(c, d);
+
+        __m128i lo01 = _mm_unpacklo_epi16(ab0, ab1); // ch0 f0-3, ch1 f0-3
+        __m128i lo23 = _mm_unpackhi_epi16(ab0, ab1); // ch2 f0-3, ch3 f0-3
+        __m128i hi01 = _mm_unpacklo_epi16(cd0, cd1); // ch0 f4-7, ch1 f4-7
+        __m128i hi23 = _mm_unpackhi_epi16(cd0, cd1);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(planes[0] + i), _mm_unpacklo_epi64(lo01, hi01));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(planes[1] + i), _mm_unpackhi_epi64(lo01, hi01));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(planes[2] + i), _mm_unpacklo_epi64(lo23, hi23));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(planes[3] + i), _mm_unpackhi_epi64(lo23, hi23));
+    }
+    return i;
+}
+
+// 8 frames per iteration, accumulated in float and packed with saturation
+size_t downmixVector(const int16_t* const* planes, size_t frames, int channels,
+                     const float* weights, int16_t* mono) {
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        __m128 lo = _mm_setzero_ps();
+        __m128 hi = _mm_setzero_ps();
+        for (int c = 0; c < channels; ++c) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes[c] + i));
+            __m128 w = _mm_set1_ps(weights[c]);
+            __m128i xlo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+            __m128i xhi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+            lo = _mm_add_ps(lo, _mm_mul_ps(_mm_cvtepi32_ps(xlo), w));
+            hi = _mm_add_ps(hi, _mm_mul_ps(_mm_cvtepi32_ps(xhi), w));
+        }
+        __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(mono + i), packed);
+    }
+    return i;
+}
+
+#endif
+
+} // namespace
+
+void deinterleave(const int16_t* interleaved, size_t frames, int channels, int16_t* const* planes) {
+    size_t done = 0;
+#ifdef JARVIS_MIXER_SSE2
+    if (channels == 2) {
+        done = deinterleaveStereo(interleaved, frames, planes[0], planes[1]);
+    } else if (channels == 4) {
+        done = deinterleaveQuad(interleaved, frames, planes);
+    }
+#endif
+    deinterleaveScalar(interleaved, done, frames, channels, planes);
+}
+
+void downmix(const int16_t* const* planes, size_t frames, int channels,
+             const float* weights, int16_t* mono) {
+    size_t done = 0;
+#ifdef JARVIS_MIXER_SSE2
+    done = downmixVector(planes, frames, channels, weights, mono);
+#endif
+    for (size_t i = done; i < frames; ++i) {
+        float sum = 0.0f;
+        for (int c = 0; c < channels; ++c) {
+            sum += planes[c][i] * weights[c];
+        }
+        mono[i] = saturate(sum);
+    }
+}
+
+ChannelMixer::ChannelMixer(int channels, size_t maxFrames)
+    : channels_(std::max(1, channels)),
+      weights_(channels_, 1.0f / channels_),
+      planes_(channels_),
+      planePointers_(channels_) {
+    reserve(maxFrames);
+}
+
+bool ChannelMixer::setWeights(const std::vector<float>& weights) {
+    if (weights.size() != static_cast<size_t>(channels_)) {
+        return false;
+    }
+    weights_ = weights;
+    return true;
+}
+
+size_t ChannelMixer::process(const int16_t* interleaved, size_t frames) {
+    frames_ = frames;
+
+    // Mono at unit gain needs no work; the views point into the input block
+    if (channels_ == 1 && weights_[0] == 1.0f) {
+        passthrough_ = interleaved;
+        return frames;
+    }
+    passthrough_ = nullptr;
+
+    reserve(frames);
+    deinterleave(interleaved, frames, channels_, planePointers_.data());
+    downmix(planePointers_.data(), frames, channels_, weights_.data(), mono_.data());
+    return frames;
+}
+
+std::span<const int16_t> ChannelMixer::channel(int index) const {
+    if (passthrough_) {
+        return {passthrough_, frames_};
+    }
+    return {planes_[index].data(), frames_};
+}
+
+std::span<const int16_t> ChannelMixer::mono() const {
+    if (passthrough_) {
+        return {passthrough_, frames_};
+    }
+    return {mono_.data(), frames_};
+}
+
+void ChannelMixer::reserve(size_t frames) {
+    if (frames <= capacity_) {
+        return;
+    }
+    capacity_ = frames;
+    for (int c = 0; c < channels_; ++c) {
+        planes_[c].resize(frames);
+        planePointers_[c] = planes_[c].data();
+    }
+    mono_.resize(frames);
+}
+
+} // namespace jarvis
@@ -0,0 +1,266 @@
+#include "audio/echo_canceller.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace jarvis {
+
+// Smoothing of the ERLE powers, per block
+static constexpr double kErleSmoothing = 0.95;
+
+// The two filters are compared on residual power smoothed over about 80 ms.
+// The adaptive one is copied to the heard one once it leaves 1 dB less and
+// removes at least 6 dB of the input, which near-end talk as loud as the
+// echo rules out; it is reset from the heard one once it leaves 9 dB more
+static constexpr double kCompareSmoothing = 0.9;
+static constexpr double kCopyRatio = 0.8;
+static constexpr double kMinCancelRatio = 0.25;
+static constexpr double kRestoreRatio = 8.0;
+static constexpr double kDivergedRatio = 2.0;
+
+// Bins are normalised by at least this fraction of the mean bin power, so the
+// near-empty bins between a voice's harmonics do not take huge steps
+static constexpr float kMinRelativePower = 0.5f;
+
+static size_t blockSizeFor(int sampleRate) {
+    // Largest power of two within 8 ms, so the transform is twice that
+    size_t size = 16;
+    while (size * 2 * 1000 <= static_cast<size_t>(sampleRate) * 8) {
+        size <<= 1;
+    }
+    return size;
+}
+
+EchoCanceller::EchoCanceller(int sampleRate) : EchoCanceller(sampleRate, Params{}) {}
+
+EchoCanceller::EchoCanceller(int sampleRate, const Params& params)
+    : sampleRate_(sampleRate),
+      params_(params),
+      blockSize_(blockSizeFor(sampleRate)),
+      bins_(blockSize_ + 1),
+      partitions_(std::max<size_t>(1, (static_cast<size_t>(sampleRate) * std::max(1, params.filterMs) / 1000 +
+                                       blockSize_ - 1) / blockSize_)),
+      fft_(blockSize_ * 2),
+      delayLine_(static_cast<size_t>(sampleRate) * std::max(0, params.delayMs) / 1000, 0.0f),
+      micBlock_(blockSize_),
+      refBlock_(blockSize_),
+      refWindow_(blockSize_ * 2, 0.0f),
+      spectra_(partitions_ * bins_),
+      blockEnergies_(partitions_, 0.0f),
+      weights_(partitions_ * bins_),
+      foreground_(partitions_ * bins_),
+      power_(bins_, 0.0f),
+      estimate_(bins_),
+      error_(bins_),
+      time_(blockSize_ * 2),
+      residual_(blockSize_) {
+    const float minEnergy = params_.minReferenceRms * params_.minReferenceRms;
+    minBlockEnergy_ = minEnergy * blockSize_;
+    // Summed |X|^2 of a reference at the silence level, over every partition
+    regularisation_ = minEnergy * fft_.size() * partitions_;
+}
+
+size_t EchoCanceller::process(std::span<const float> mic, std::span<const float> ref) {
+    const size_t n = std::min(mic.size(), ref.size());
+    const size_t capacity = (pendingCount_ + n) / blockSize_ * blockSize_;
+    if (samples_.size() < capacity) {
+        samples_.resize(capacity);
+        pcm_.resize(capacity);
+    }
+
+    produced_ = 0;
+    for (size_t i = 0; i < n;) {
+        size_t take = std::min(n - i, blockSize_ - pendingCount_);
+        std::memcpy(micBlock_.data() + pendingCount_, mic.data() + i, take * sizeof(float));
+        float* refOut = refBlock_.data() + pendingCount_;
+        if (delayLine_.empty()) {
+            std::memcpy(refOut, ref.data() + i, take * sizeof(float));
+        } else {
+            for (size_t j = 0; j < take; ++j) {
+                refOut[j] = delayLine_[delayPosition_];
+                delayLine_[delayPosition_] = ref[i + j];
+                delayPosition_ = delayPosition_ + 1 == delayLine_.size() ? 0 : delayPosition_ + 1;
+            }
+        }
+        pendingCount_ += take;
+        i += take;
+
+        if (pendingCount_ == blockSize_) {
+            processBlock(samples_.data() + produced_);
+            produced_ += blockSize_;
+            pendingCount_ = 0;
+        }
+    }
+
+    for (size_t i = 0; i < produced_; ++i) {
+        pcm_[i] = static_cast<int16_t>(std::clamp(std::lround(samples_[i] * 32768.0f), -32768L, 32767L));
+    }
+    return produced_;
+}
+
+void EchoCanceller::processBlock(float* out) {
+    const size_t B = blockSize_;
+    blocks_.fetch_add(1, std::memory_order_relaxed);
+
+    // Slide the overlap-save window and take the newest reference spectrum;
+    // a window that is silent throughout contributes nothing, so skip its transform
+    float energy = 0.0f;
+    for (float v : refBlock_) {
+        energy += v * v;
+    }
+    std::memmove(refWindow_.data(), refWindow_.data() + B, B * sizeof(float));
+    std::memcpy(refWindow_.data() + B, refBlock_.data(), B * sizeof(float));
+    newest_ = (newest_ + 1) % partitions_;
+    if (energy > minBlockEnergy_ || previousEnergy_ > minBlockEnergy_) {
+        fft_.forward(refWindow_.data(), spectrum(0));
+    } else {
+        std::fill(spectrum(0), spectrum(0) + bins_, std::complex<float>{});
+    }
+    previousEnergy_ = energy;
+    referenceEnergy_ += static_cast<double>(energy) - blockEnergies_[newest_];
+    blockEnergies_[newest_] = energy;
+
+    // No reference anywhere in the filter span means no echo to cancel
+    const bool active = referenceEnergy_ > static_cast<double>(minBlockEnergy_) * partitions_;
+    referenceActive_.store(active, std::memory_order_relaxed);
+    if (!active) {
+        referenceEnergy_ = std::max(0.0, referenceEnergy_);
+        std::memcpy(out, micBlock_.data(), B * sizeof(float));
+        doubleTalk_.store(false, std::memory_order_relaxed);
+        return;
+    }
+    filteredBlocks_.fetch_add(1, std::memory_order_relaxed);
+
+    // Both filters' residuals: the adaptive one trains, the held one is heard
+    double micEnergy = 0.0;
+    for (float v : micBlock_) {
+        micEnergy += v * v;
+    }
+    const double trainingEnergy = cancel(weights_.data(), residual_.data());
+    const double outputEnergy = cancel(foreground_.data(), out);
+
+    inputPower_ = kCompareSmoothing * inputPower_ + (1.0 - kCompareSmoothing) * micEnergy;
+    trainingPower_ = kCompareSmoothing * trainingPower_ + (1.0 - kCompareSmoothing) * trainingEnergy;
+    outputPower_ = kCompareSmoothing * outputPower_ + (1.0 - kCompareSmoothing) * outputEnergy;
+    if (trainingPower_ < kCopyRatio * outputPower_ && trainingPower_ < kMinCancelRatio * inputPower_) {
+        // The adaptive filter is doing better: it becomes the one heard
+        std::copy(weights_.begin(), weights_.end(), foreground_.begin());
+        outputPower_ = trainingPower_;
+        foregroundUpdates_.fetch_add(1, std::memory_order_relaxed);
+    } else if (trainingPower_ > kRestoreRatio * outputPower_) {
+        // Near-end talk has pulled the adaptive filter off the echo path
+        std::copy(foreground_.begin(), foreground_.end(), weights_.begin());
+        trainingPower_ = outputPower_;
+        restoredBlocks_.fetch_add(1, std::memory_order_relaxed);
+    }
+    doubleTalk_.store(trainingPower_ > outputPower_ * kDivergedRatio, std::memory_order_relaxed);
+
+    micPower_ = kErleSmoothing * micPower_ + (1.0 - kErleSmoothing) * micEnergy;
+    residualPower_ = kErleSmoothing * residualPower_ + (1.0 - kErleSmoothing) * outputEnergy;
+    erleDb_.store(10.0 * std::log10((micPower_ + 1e-12) / (residualPower_ + 1e-12)), std::memory_order_relaxed);
+    adapt();
+}
+
+double EchoCanceller::cancel(const std::complex<float>* weights, float* out) {
+    const size_t B = blockSize_;
+
+    // Echo estimate: the sum over partitions of weights times delayed spectra
+    std::fill(estimate_.begin(), estimate_.end(), std::complex<float>{});
+    for (size_t p = 0; p < partitions_; ++p) {
+        const std::complex<float>* x = spectrum(p);
+        const std::complex<float>* w = weights + p * bins_;
+        for (size_t k = 0; k < bins_; ++k) {
+            estimate_[k] += w[k] * x[k];
+        }
+    }
+    fft_.inverse(estimate_.data(), time_.data());
+
+    double energy = 0.0;
+    for (size_t i = 0; i < B; ++i) {
+        out[i] = micBlock_[i] - time_[B + i];
+        energy += out[i] * out[i];
+    }
+    return energy;
+}
+
+void EchoCanceller::adapt() {
+    const size_t B = blockSize_;
+    adaptedBlocks_.fetch_add(1, std::memory_order_relaxed);
+
+    // Error spectrum, zero-padded in front as overlap-save requires
+    std::fill(time_.begin(), time_.begin() + B, 0.0f);
+    std::memcpy(time_.data() + B, residual_.data(), B * sizeof(float));
+    fft_.forward(time_.data(), error_.data());
+
+    // Normalised step per bin: the reference power over the whole filter span
+    std::fill(power_.begin(), power_.end(), regularisation_);
+    for (size_t p = 0; p < partitions_; ++p) {
+        const std::complex<float>* x = spectrum(p);
+        for (size_t k = 0; k < bins_; ++k) {
+            power_[k] += x[k].real() * x[k].real() + x[k].imag() * x[k].imag();
+        }
+    }
+    float mean = 0.0f;
+    for (float p : power_) {
+        mean += p;
+    }
+    const float floor = kMinRelativePower * mean / bins_;
+    for (size_t k = 0; k < bins_; ++k) {
+        error_[k] *= params_.stepSize / std::max(power_[k], floor);
+    }
+
+    for (size_t p = 0; p < partitions_; ++p) {
+        const std::complex<float>* x = spectrum(p);
+        std::complex<float>* w = weights_.data() + p * bins_;
+        for (size_t k = 0; k < bins_; ++k) {
+            w[k] += std::conj(x[k]) * error_[k];
+        }
+    }
+
+    // Keep each partition a causal block of taps; one partition per block
+    // spreads the cost of the two transforms this takes
+    std::complex<float>* w = weights_.data() + constrainNext_ * bins_;
+    fft_.inverse(w, time_.data());
+    std::fill(time_.begin() + B, time_.end(), 0.0f);
+    fft_.forward(time_.data(), w);
+    constrainNext_ = (constrainNext_ + 1) % partitions_;
+}
+
+EchoCanceller::Stats EchoCanceller::getStats() const {
+    Stats stats;
+    stats.erleDb = erleDb_.load(std::memory_order_relaxed);
+    stats.referenceActive = referenceActive_.load(std::memory_order_relaxed);
+    stats.doubleTalk = doubleTalk_.load(std::memory_order_relaxed);
+    stats.blocks = blocks_.load(std::memory_order_relaxed);
+    stats.filteredBlocks = filteredBlocks_.load(std::memory_order_relaxed);
+    stats.adaptedBlocks = adaptedBlocks_.load(std::memory_order_relaxed);
+    stats.foregroundUpdates = foregroundUpdates_.load(std::memory_order_relaxed);
+    stats.restoredBlocks = restoredBlocks_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void EchoCanceller::reset() {
+    std::fill(delayLine_.begin(), delayLine_.end(), 0.0f);
+    delayPosition_ = 0;
+    pendingCount_ = 0;
+    produced_ = 0;
+    std::fill(refWindow_.begin(), refWindow_.end(), 0.0f);
+    previousEnergy_ = 0.0f;
+    std::fill(spectra_.begin(), spectra_.end(), std::complex<float>{});
+    std::fill(blockEnergies_.begin(), blockEnergies_.end(), 0.0f);
+    referenceEnergy_ = 0.0;
+    std::fill(weights_.begin(), weights_.end(), std::complex<float>{});
+    std::fill(foreground_.begin(), foreground_.end(), std::complex<float>{});
+    std::fill(power_.begin(), power_.end(), 0.0f);
+    constrainNext_ = 0;
+    inputPower_ = 0.0;
+    trainingPower_ = 0.0;
+    outputPower_ = 0.0;
+    micPower_ = 0.0;
+    residualPower_ = 0.0;
+    erleDb_.store(0.0, std::memory_order_relaxed);
+    referenceActive_.store(false, std::memory_order_relaxed);
+    doubleTalk_.store(false, std::memory_order_relaxed);
+}
+
+} // namespace jarvis
@@ -0,0 +1,91 @@
+#include "audio/endpointer.h"
+#include <algorithm>
+
+namespace jarvis {
+
+Endpointer::Endpointer(int sampleRate) : Endpointer(sampleRate, Params{}) {}
+
+Endpointer::Endpointer(int sampleRate, const Params& params) : sampleRate_(sampleRate), params_(params) {}
+
+void Endpointer::setParams(const Params& params) {
+    params_ = params;
+}
+
+void Endpointer::reset() {
+    position_ = 0;
+    speechStart_ = 0;
+    speechEnd_ = 0;
+    speechStarted_ = false;
+    inSpeech_ = false;
+    runStart_ = 0;
+    partial_.clear();
+    partialChanged_ = 0;
+    result_ = Result::Continue;
+}
+
+Endpointer::Result Endpointer::update(size_t samples, bool speech) {
+    if (result_ != Result::Continue) {
+        return result_;
+    }
+
+    const uint64_t start = position_;
+    position_ += samples;
+    if (speech) {
+        if (!inSpeech_) {
+            inSpeech_ = true;
+            runStart_ = start;
+        }
+        speechEnd_ = position_;
+        // The utterance begins with the first burst long enough not to be a click
+        if (!speechStarted_ && position_ - runStart_ >= toSamples(params_.minUtteranceMs)) {
+            speechStarted_ = true;
+            speechStart_ = runStart_;
+        }
+    } else {
+        inSpeech_ = false;
+    }
+
+    if (!speechStarted_) {
+        if (position_ >= toSamples(params_.noSpeechTimeoutMs)) {
+            result_ = Result::NoSpeech;
+        }
+        return result_;
+    }
+
+    if (position_ - speechStart_ >= toSamples(params_.maxUtteranceMs)) {
+        result_ = Result::MaxDuration;
+        return result_;
+    }
+
+    if (!speech) {
+        const uint64_t pause = position_ - speechEnd_;
+        const bool stable = !partial_.empty() && position_ - partialChanged_ >= toSamples(params_.partialStableMs);
+        if (pause >= toSamples(params_.maxPauseMs) || (stable && pause >= toSamples(params_.minPauseMs))) {
+            result_ = Result::EndOfTurn;
+        }
+    }
+    return result_;
+}
+
+void Endpointer::onPartialResult(const std::string& text) {
+    if (text != partial_) {
+        partial_ = text;
+        partialChanged_ = position_;
+    }
+}
+
+const char* Endpointer::resultName(Result result) {
+    switch (result) {
+        case Result::Continue: return "continue";
+        case Result::EndOfTurn: return "end of turn";
+        case Result::MaxDuration: return "maximum duration";
+        case Result::NoSpeech: return "no speech";
+    }
+    return "unknown";
+}
+
+uint64_t Endpointer::toSamples(int ms) const {
+    return static_cast<uint64_t>(std::max(0, ms)) * sampleRate_ / 1000;
+}
+
+} // namespace jarvis
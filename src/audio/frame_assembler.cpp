@@ -0,0 +1,51 @@
+#include "audio/frame_assembler.h"
+#include <algorithm>
+#include <cstring>
+
+namespace jarvis {
+
+FrameAssembler::FrameAssembler(size_t frameLength) : frame_(std::max<size_t>(1, frameLength)) {}
+
+void FrameAssembler::setFrameHandler(FrameHandler handler) {
+    handler_ = handler;
+}
+
+size_t FrameAssembler::push(std::span<const int16_t> samples) {
+    const size_t length = frame_.size();
+    const int16_t* data = samples.data();
+    size_t remaining = samples.size();
+    size_t frames = 0;
+
+    // Complete the frame left over from the previous block first
+    if (pending_ > 0) {
+        size_t take = std::min(remaining, length - pending_);
+        std::memcpy(frame_.data() + pending_, data, take * sizeof(int16_t));
+        pending_ += take;
+        data += take;
+        remaining -= take;
+        if (pending_ < length) {
+            return 0;
+        }
+        pending_ = 0;
+        ++assembledFrames_;
+        ++frames;
+        if (handler_) {
+            handler_(frame_.data());
+        }
+    }
+
+    // Whole frames are read where they lie
+    for (; remaining >= length; data += length, remaining -= length) {
+        ++directFrames_;
+        ++frames;
+        if (handler_) {
+            handler_(data);
+        }
+    }
+
+    std::memcpy(frame_.data(), data, remaining * sizeof(int16_t));
+    pending_ = remaining;
+    return frames;
+}
+
+} // namespace jarvis
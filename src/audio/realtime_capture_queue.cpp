@@ -0,0 +1,88 @@
+#include "audio/realtime_capture_queue.h"
+#include <algorithm>
+#include <bit>
+
+namespace jarvis {
+
+// Smallest block we size the timestamp queue for; smaller pushes may drop early
+static constexpr size_t kMinBlockSamples = 32;
+
+RealTimeCaptureQueue::RealTimeCaptureQueue(size_t capacity, int channels, int sampleRate)
+    : ring_(capacity), channels_(std::max(channels, 1)), sampleRate_(sampleRate),
+      stamps_(std::bit_ceil(std::max<size_t>(ring_.capacity() / kMinBlockSamples, 64))),
+      stampMask_(stamps_.size() - 1) {
+}
+
+RealTimeCaptureQueue::~RealTimeCaptureQueue() = default;
+
+bool RealTimeCaptureQueue::push(const int16_t* data, size_t count,
+                                AudioTimestamp::Clock::time_point captureTime) noexcept {
+    AudioTimestamp stamp{nextFrame_, captureTime};
+    nextFrame_ += count / channels_;
+
+    // Free space only grows under us, so this write cannot fail after the stamp is out
+    size_t tail = stampTail_.load(std::memory_order_relaxed);
+    if (ring_.freeSpace() < count ||
+        tail - stampHead_.load(std::memory_order_acquire) == stamps_.size()) {
+        droppedSamples_.fetch_add(count, std::memory_order_relaxed);
+        droppedBlocks_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    stamps_[tail & stampMask_] = {stamp, count};
+    stampTail_.store(tail + 1, std::memory_order_release);
+    ring_.write(data, count);
+
+    // Only enters the kernel when the delivery thread is actually asleep
+    dataReady_.release();
+    return true;
+}
+
+bool RealTimeCaptureQueue::waitForData(std::chrono::milliseconds timeout) {
+    return dataReady_.try_acquire_for(timeout);
+}
+
+size_t RealTimeCaptureQueue::pop(int16_t* buffer, size_t count, AudioTimestamp* stamp) {
+    size_t head = stampHead_.load(std::memory_order_relaxed);
+    if (stamp && head != stampTail_.load(std::memory_order_acquire)) {
+        const BlockStamp& front = stamps_[head & stampMask_];
+        *stamp = front.stamp.advancedBy(stampOffset_ / channels_, sampleRate_);
+    }
+
+    size_t got = ring_.read(buffer, count);
+
+    // Retire the stamps of every block we have now fully consumed
+    size_t remaining = got;
+    while (remaining > 0 && head != stampTail_.load(std::memory_order_acquire)) {
+        size_t left = stamps_[head & stampMask_].samples - stampOffset_;
+        if (remaining < left) {
+            stampOffset_ += remaining;
+            break;
+        }
+        remaining -= left;
+        stampOffset_ = 0;
+        ++head;
+    }
+    stampHead_.store(head, std::memory_order_release);
+    return got;
+}
+
+AudioRingBuffer::Stats RealTimeCaptureQueue::stats() const {
+    // Full blocks are rejected here before they reach the ring
+    AudioRingBuffer::Stats stats = ring_.getStats();
+    stats.droppedSamples = droppedSamples_.load(std::memory_order_relaxed);
+    stats.overflows = droppedBlocks_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void RealTimeCaptureQueue::clear() {
+    ring_.clear();
+    stampHead_.store(stampTail_.load(std::memory_order_acquire), std::memory_order_release);
+    stampOffset_ = 0;
+}
+
+void RealTimeCaptureQueue::interrupt() {
+    dataReady_.release();
+}
+
+} // namespace jarvis
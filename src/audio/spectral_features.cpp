@@ -0,0 +1,149 @@
+#include "audio/spectral_features.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace jarvis {
+
+// Log-mel energies are floored here, well below any 16-bit signal
+static constexpr float kMelFloor = 1e-10f;
+
+static size_t samplesFor(int sampleRate, int ms) {
+    return std::max<size_t>(1, static_cast<size_t>(sampleRate) * std::max(1, ms) / 1000);
+}
+
+static size_t fftSizeFor(size_t windowSize) {
+    size_t size = 16;
+    while (size < windowSize) {
+        size <<= 1;
+    }
+    return size;
+}
+
+SpectralFeatures::SpectralFeatures(int sampleRate) : SpectralFeatures(sampleRate, Params{}) {}
+
+SpectralFeatures::SpectralFeatures(int sampleRate, const Params& params)
+    : sampleRate_(sampleRate),
+      windowSize_(std::max<size_t>(16, samplesFor(sampleRate, params.windowMs))),
+      hopSize_(std::min(windowSize_, samplesFor(sampleRate, params.hopMs))),
+      fft_(fftSizeFor(windowSize_)),
+      filterbank_(static_cast<size_t>(std::max(1, params.mels)), fft_.size(), sampleRate, params.minFrequency,
+                  params.maxFrequency),
+      window_(dsp::hannWindow(windowSize_)),
+      input_(windowSize_),
+      windowed_(fft_.size(), 0.0f),
+      spectrum_(fft_.bins()) {
+    for (float w : window_) {
+        windowEnergy_ += w * w;
+    }
+
+    capacity_ = 1;
+    size_t frames = static_cast<size_t>(std::max(1, params.historyMs)) * sampleRate / 1000 / hopSize_ + 1;
+    while (capacity_ < frames) {
+        capacity_ <<= 1;
+    }
+    stride_ = numBins() + numMels();
+    storage_.assign(capacity_ * stride_, 0.0f);
+}
+
+SpectralFeatures::~SpectralFeatures() = default;
+
+size_t SpectralFeatures::process(std::span<const float> samples) {
+    size_t published = 0;
+    const float* in = samples.data();
+    size_t remaining = samples.size();
+    while (remaining > 0) {
+        size_t take = std::min(remaining, windowSize_ - inputFill_);
+        std::memcpy(input_.data() + inputFill_, in, take * sizeof(float));
+        inputFill_ += take;
+        in += take;
+        remaining -= take;
+        if (inputFill_ < windowSize_) {
+            break;
+        }
+
+        publish();
+        ++published;
+        std::memmove(input_.data(), input_.data() + hopSize_, (windowSize_ - hopSize_) * sizeof(float));
+        inputFill_ = windowSize_ - hopSize_;
+    }
+    return published;
+}
+
+void SpectralFeatures::publish() {
+    const uint64_t index = written_.load(std::memory_order_relaxed);
+
+    // Announce the slot before touching it, as the audio bus does, so readers
+    // can tell a frame they copied was being overwritten
+    writing_.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < windowSize_; ++i) {
+        windowed_[i] = input_[i] * window_[i];
+    }
+    fft_.forward(windowed_.data(), spectrum_.data());
+
+    float* power = storage_.data() + (index & (capacity_ - 1)) * stride_;
+    float* logMel = power + numBins();
+    dsp::powerSpectrum(spectrum_.data(), power, numBins());
+    filterbank_.apply(power, logMel);
+    for (size_t m = 0; m < numMels(); ++m) {
+        logMel[m] = std::log(std::max(logMel[m], kMelFloor));
+    }
+
+    written_.store(index + 1, std::memory_order_release);
+}
+
+void SpectralFeatures::reset(uint64_t position) {
+    origin_ = position;
+    inputFill_ = 0;
+    written_.store(0, std::memory_order_release);
+    writing_.store(0, std::memory_order_release);
+}
+
+uint64_t SpectralFeatures::oldestFrame() const {
+    uint64_t written = framesWritten();
+    return written > capacity_ ? written - capacity_ : 0;
+}
+
+bool SpectralFeatures::copyOut(uint64_t index, size_t offset, size_t count, float* out) const {
+    uint64_t written = written_.load(std::memory_order_acquire);
+    if (index >= written || written - index > capacity_) {
+        return false;
+    }
+    std::memcpy(out, storage_.data() + (index & (capacity_ - 1)) * stride_ + offset, count * sizeof(float));
+
+    // Valid only if the writer had not started on the slot's next frame
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return writing_.load(std::memory_order_relaxed) <= index + capacity_;
+}
+
+bool SpectralFeatures::read(uint64_t index, Frame& frame) const {
+    frame.power.resize(numBins());
+    frame.logMel.resize(numMels());
+    if (!copyOut(index, 0, numBins(), frame.power.data()) ||
+        !copyOut(index, numBins(), numMels(), frame.logMel.data())) {
+        return false;
+    }
+    frame.index = index;
+    frame.endPosition = endPosition(index);
+    return true;
+}
+
+bool SpectralFeatures::readPower(uint64_t index, float* power) const {
+    return copyOut(index, 0, numBins(), power);
+}
+
+bool SpectralFeatures::readLogMel(uint64_t index, float* logMel) const {
+    return copyOut(index, numBins(), numMels(), logMel);
+}
+
+bool SpectralFeatures::frameEndingBy(uint64_t position, uint64_t& index) const {
+    if (position < origin_ + windowSize_) {
+        return false;
+    }
+    index = (position - origin_ - windowSize_) / hopSize_;
+    return true;
+}
+
+} // namespace jarvis
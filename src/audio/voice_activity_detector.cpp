@@ -0,0 +1,300 @@
+#include "audio/voice_activity_detector.h"
+#include "audio/spectral_features.h"
+#include "dsp/kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace jarvis {
+
+// Band energies are smoothed over frames before their minimum is taken
+static constexpr float kBandSmoothing = 0.7f;
+
+// Band SNRs are clamped so one loud band cannot carry the average
+static constexpr float kMaxBandSnrDb = 30.0f;
+
+static constexpr float kTiny = 1e-20f;
+
+VoiceActivityDetector::VoiceActivityDetector(int sampleRate)
+    : VoiceActivityDetector(sampleRate, Params{}) {}
+
+VoiceActivityDetector::VoiceActivityDetector(int sampleRate, const Params& params)
+    : sampleRate_(sampleRate), params_(params), silenceTimeoutMs_(2000), voiceDetected_(false),
+      fft_(4) {
+    setParams(params);
+    setSilenceTimeout(silenceTimeoutMs_);
+}
+
+VoiceActivityDetector::~VoiceActivityDetector() = default;
+
+bool VoiceActivityDetector::processFrame(const int16_t* frame, size_t frameSize) {
+    while (frameSize > 0) {
+        size_t take = std::min(frameSize, frameLength_ - pendingCount_);
+        std::copy(frame, frame + take, pending_.begin() + pendingCount_);
+        pendingCount_ += take;
+        frame += take;
+        frameSize -= take;
+        if (pendingCount_ < frameLength_) {
+            break;
+        }
+        pendingCount_ = 0;
+
+        analyse(pending_.data(), frameLength_, nullptr);
+        decide(frameLength_);
+    }
+    return voiceDetected_;
+}
+
+void VoiceActivityDetector::useSharedSpectrum(const SpectralFeatures& features) {
+    sharedFftSize_ = features.fftSize();
+    sharedHopSize_ = features.hopSize();
+    sharedWindowEnergy_ = features.windowEnergy();
+    configureAnalysis();
+    features_ = Features{};
+}
+
+bool VoiceActivityDetector::processSpectrum(const int16_t* hop, size_t hopSize, const float* power) {
+    analyse(hop, hopSize, power);
+    decide(hopSize);
+    return voiceDetected_;
+}
+
+void VoiceActivityDetector::decide(size_t n) {
+    if (features_.speech) {
+        silentSamples_ = 0;
+        voiceDetected_ = true;
+        return;
+    }
+    silentSamples_ += n;
+    if (silentSamples_ >= silenceTimeoutSamples_) {
+        voiceDetected_ = false;
+        silentSamples_ = 0;
+    }
+}
+
+bool VoiceActivityDetector::isSilent(uint64_t sumSquares, size_t n) const {
+    // rms <= minRms  <=>  sum of squares <= (minRms * 32768)^2 * n. The sum is
+    // an integer, so comparing with the floor of the right side is exact;
+    // fraction * n fits in 64 bits for frames under 65536 samples
+    const uint64_t limit = silenceWhole_ * n + ((silenceFraction_ * n) >> silenceShift_);
+    return sumSquares <= limit;
+}
+
+void VoiceActivityDetector::analyse(const int16_t* frame, size_t n, const float* power) {
+    const uint64_t sumSquares = dsp::sumSquares(frame, n);
+
+    if (isSilent(sumSquares, n)) {
+        features_.snrDb = 0.0f;
+        features_.flatnessDb = 0.0f;
+        features_.zeroCrossingRate = 0.0f;
+        features_.probability *= params_.smoothing;
+        features_.speech = false;
+        updateNoiseFloor(false);
+        return;
+    }
+
+    int crossings = 0;
+    for (size_t i = 1; i < n; ++i) {
+        crossings += (frame[i - 1] < 0) != (frame[i] < 0);
+    }
+    features_.zeroCrossingRate = static_cast<float>(crossings) / static_cast<float>(n - 1);
+
+    const size_t firstBin = bandEdges_.front();
+    const size_t endBin = bandEdges_.back();
+    if (!power) {
+        dsp::int16ToFloat(frame, windowed_.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            windowed_[i] *= window_[i];
+        }
+        fft_.forward(windowed_.data(), spectrum_.data());
+        dsp::powerSpectrum(spectrum_.data() + firstBin, power_.data() + firstBin, endBin - firstBin);
+        power = power_.data();
+    }
+
+    const size_t bands = bandEdges_.size() - 1;
+    for (size_t b = 0; b < bands; ++b) {
+        float sum = 0.0f;
+        for (size_t k = bandEdges_[b]; k < bandEdges_[b + 1]; ++k) {
+            sum += power[k];
+        }
+        bandEnergy_[b] = sum / static_cast<float>(bandEdges_[b + 1] - bandEdges_[b]);
+    }
+    updateNoiseFloor(true);
+
+    // Mean band SNR, and the flatness of the spectrum divided by the noise:
+    // steady noise whitens to flat whatever its colour, voiced speech stays peaky
+    float snrSum = 0.0f;
+    double logSum = 0.0;
+    double linearSum = 0.0;
+    for (size_t b = 0; b < bands; ++b) {
+        float floor = noiseFloor_[b];
+        float snr = 10.0f * std::log10(std::max(bandEnergy_[b], kTiny) / floor);
+        snrSum += std::clamp(snr, 0.0f, kMaxBandSnrDb);
+        for (size_t k = bandEdges_[b]; k < bandEdges_[b + 1]; ++k) {
+            double whitened = std::max(power[k], kTiny) / floor;
+            logSum += std::log(whitened);
+            linearSum += whitened;
+        }
+    }
+    const double bins = static_cast<double>(endBin - firstBin);
+    features_.snrDb = snrSum / static_cast<float>(bands);
+    features_.flatnessDb = static_cast<float>(
+        10.0 * std::log10(std::exp(logSum / bins) / std::max(linearSum / bins, 1e-30)));
+
+    float logit = params_.snrWeight * (features_.snrDb - params_.snrMidpointDb) +
+                  params_.flatnessWeight * (params_.flatnessMidpointDb - features_.flatnessDb) +
+                  params_.zcrWeight * (params_.zcrMidpoint - features_.zeroCrossingRate);
+    float probability = 1.0f / (1.0f + std::exp(-logit));
+    features_.probability = params_.smoothing * features_.probability + (1.0f - params_.smoothing) * probability;
+    features_.speech = features_.probability >= params_.speechThreshold;
+}
+
+void VoiceActivityDetector::updateNoiseFloor(bool analysed) {
+    const size_t bands = noiseFloor_.size();
+    for (size_t b = 0; b < bands; ++b) {
+        // Gated frames sit at or below the gate; they count as that level
+        float energy = analysed ? std::max(bandEnergy_[b], minimumFloor_) : minimumFloor_;
+        float& smoothed = smoothedEnergy_[b];
+        smoothed = smoothed < 0.0f ? energy : kBandSmoothing * smoothed + (1.0f - kBandSmoothing) * energy;
+        currentMinimum_[b] = std::min(currentMinimum_[b], smoothed);
+
+        float minimum = currentMinimum_[b];
+        for (int w = 0; w < kNoiseSubwindows; ++w) {
+            minimum = std::min(minimum, subwindowMinima_[b * kNoiseSubwindows + w]);
+        }
+        noiseFloor_[b] = std::max(minimum * noiseBias_, minimumFloor_);
+    }
+
+    // Retire the oldest sub-window, so the floor follows a rising noise
+    // level within one window while a falling one is followed at once
+    if (++subwindowFill_ >= subwindowFrames_) {
+        for (size_t b = 0; b < bands; ++b) {
+            subwindowMinima_[b * kNoiseSubwindows + subwindowIndex_] = currentMinimum_[b];
+            currentMinimum_[b] = std::numeric_limits<float>::infinity();
+        }
+        subwindowIndex_ = (subwindowIndex_ + 1) % kNoiseSubwindows;
+        subwindowFill_ = 0;
+    }
+}
+
+void VoiceActivityDetector::configureAnalysis() {
+    size_t fftSize = 16;
+    if (sharedFftSize_ > 0) {
+        // Spectra come in ready-made, one per hop
+        frameLength_ = sharedHopSize_;
+        fftSize = sharedFftSize_;
+        windowEnergy_ = sharedWindowEnergy_;
+    } else {
+        frameLength_ = std::max<size_t>(16, static_cast<size_t>(sampleRate_) * std::max(1, params_.frameMs) / 1000);
+        while (fftSize < frameLength_) {
+            fftSize <<= 1;
+        }
+        fft_ = dsp::RealFft(fftSize);
+        window_ = dsp::hannWindow(frameLength_);
+        windowed_.assign(fftSize, 0.0f);
+        spectrum_.assign(fft_.bins(), {});
+        power_.assign(fft_.bins(), 0.0f);
+        windowEnergy_ = 0.0f;
+        for (float w : window_) {
+            windowEnergy_ += w * w;
+        }
+    }
+    pending_.assign(frameLength_, 0);
+    pendingCount_ = 0;
+
+    // Log-spaced band edges in bins; every band gets at least one bin
+    const double binHz = static_cast<double>(sampleRate_) / fftSize;
+    const size_t lastBin = fftSize / 2;
+    const double low = std::max(binHz, static_cast<double>(params_.minFrequency));
+    const double high = std::clamp(static_cast<double>(params_.maxFrequency), low + binHz, sampleRate_ / 2.0);
+    const int bands = std::max(1, params_.bands);
+    bandEdges_.clear();
+    for (int b = 0; b <= bands; ++b) {
+        double hz = low * std::pow(high / low, static_cast<double>(b) / bands);
+        size_t bin = std::min(lastBin, static_cast<size_t>(std::lround(hz / binHz)));
+        if (!bandEdges_.empty() && bin <= bandEdges_.back()) {
+            bin = bandEdges_.back() + 1;
+        }
+        if (bin > lastBin + 1) {
+            break;
+        }
+        bandEdges_.push_back(bin);
+    }
+    if (bandEdges_.size() < 2) {
+        bandEdges_ = {1, lastBin + 1};
+    }
+
+    // Expected band energy of noise at minRms: rms^2 times the window's energy
+    minimumFloor_ = params_.minRms * params_.minRms * windowEnergy_;
+    minimumFloor_ = std::max(minimumFloor_, kTiny);
+    noiseBias_ = std::pow(10.0f, params_.noiseBiasDb / 10.0f);
+
+    const uint64_t windowSamples = static_cast<uint64_t>(std::max(0, params_.noiseWindowMs)) * sampleRate_ / 1000;
+    subwindowFrames_ = std::max(1, static_cast<int>(windowSamples / frameLength_ / kNoiseSubwindows));
+
+    const size_t bandCount = bandEdges_.size() - 1;
+    bandEnergy_.assign(bandCount, 0.0f);
+    smoothedEnergy_.assign(bandCount, -1.0f);
+    currentMinimum_.assign(bandCount, std::numeric_limits<float>::infinity());
+    subwindowMinima_.assign(bandCount * kNoiseSubwindows, std::numeric_limits<float>::infinity());
+    noiseFloor_.assign(bandCount, minimumFloor_);
+    subwindowFill_ = 0;
+    subwindowIndex_ = 0;
+}
+
+void VoiceActivityDetector::setParams(const Params& params) {
+    params_ = params;
+
+    // minRms = m * 2^(e - 24) with a 24-bit integer m, so the squared level
+    // in 16-bit units is m^2 / 2^(18 - 2e): split into whole and fraction.
+    // No frame is louder than full scale, so larger levels gate everything.
+    silenceWhole_ = 0;
+    silenceFraction_ = 0;
+    silenceShift_ = 0;
+    float level = std::min(params_.minRms, 1.0f);
+    if (level > 0.0f) {
+        int exponent = 0;
+        uint64_t mantissa = static_cast<uint64_t>(std::ldexp(std::frexp(level, &exponent), 24));
+        uint64_t squared = mantissa * mantissa;
+        int shift = 18 - 2 * exponent;
+        if (shift < 64) {
+            silenceWhole_ = squared >> shift;
+            silenceFraction_ = squared & ((uint64_t{1} << shift) - 1);
+            silenceShift_ = shift;
+        }
+        // else under 1/256 of a 16-bit step: only digital silence is gated
+    }
+    configureAnalysis();
+    features_ = Features{};
+}
+
+void VoiceActivityDetector::setThreshold(float threshold) {
+    Params params = params_;
+    params.minRms = threshold;
+    setParams(params);
+}
+
+void VoiceActivityDetector::setSilenceTimeout(int ms) {
+    silenceTimeoutMs_ = ms;
+    silenceTimeoutSamples_ = static_cast<uint64_t>(std::max(0, ms)) * sampleRate_ / 1000;
+}
+
+std::vector<float> VoiceActivityDetector::getNoiseFloorDb() const {
+    // Back to the mean square of the audio, as the gate is expressed
+    std::vector<float> floors;
+    floors.reserve(noiseFloor_.size());
+    for (float floor : noiseFloor_) {
+        floors.push_back(static_cast<float>(10.0 * std::log10(static_cast<double>(floor) / windowEnergy_ + 1e-30)));
+    }
+    return floors;
+}
+
+void VoiceActivityDetector::reset() {
+    silentSamples_ = 0;
+    voiceDetected_ = false;
+    pendingCount_ = 0;
+    features_.probability = 0.0f;
+    features_.speech = false;
+}
+
+} // namespace jarvis
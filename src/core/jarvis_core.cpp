@@ -1,4 +1,5 @@
 #include "core/jarvis_core.h"
+#include "audio/audio_capture.h"
 #include "speech/wake_word_detector.h"
 #include "speech/speech_recognizer.h"
 #include "speech/text_to_speech.h"
@@ -26,19 +27,25 @@ bool JarvisCore::initialize() {
             LOG_WARNING("Failed to load configuration, using defaults");
         }
 
+        audioCapture_ = std::make_unique<AudioCapture>();
         wakeWordDetector_ = std::make_unique<WakeWordDetector>();
         speechRecognizer_ = std::make_unique<SpeechRecognizer>();
         textToSpeech_ = std::make_unique<TextToSpeech>();
         intentParser_ = std::make_unique<IntentParser>();
         pluginManager_ = std::make_unique<PluginManager>();
 
-        // Initialize wake word detector
-        std::string modelPath = configManager_->getString("wake_word.model_path", "models/porcupine_params.pv");
-        std::string keywordPath = configManager_->getString("wake_word.keyword_path", "models/hey-jarvis.ppn");
-        float sensitivity = configManager_->getFloat("wake_word.sensitivity", 0.5f);
+        // Initialize wake word detector with the configured engine and keywords; without one
+        // Jarvis still starts, it just never wakes
+        wakeWordReady_ = wakeWordDetector_->initialize(WakeWordDetector::readSettings(*configManager_));
+        if (!wakeWordReady_) {
+            LOG_WARNING("Wake word detector unavailable; add wake_word.recordings for the built-in spotter, "
+                        "or a Porcupine build with wake_word.keyword_path (.ppn)");
+        }
 
-        if (!wakeWordDetector_->initialize(modelPath, keywordPath, sensitivity)) {
-            LOG_ERROR("Failed to initialize wake word detector");
+        // The device is opened once here; detection only arms and disarms on it
+        int framesPerBuffer = configManager_->getInt("audio.frames_per_buffer", 1024);
+        if (!audioCapture_->initialize(wakeWordDetector_->getSampleRate(), 1, framesPerBuffer)) {
+            LOG_ERROR("Failed to initialize audio capture");
             return false;
         }
 
@@ -88,9 +95,22 @@ void JarvisCore::start() {
         running_ = true;
         processingThread_ = std::thread(&JarvisCore::processingLoop, this);
         
-        // Start wake word detection
-        wakeWordDetector_->startDetection([this]() {
-            handleWakeWordDetected();
+        // Start wake word detection on the shared capture stream. Detections
+        // arrive on the capture thread, which must not block; the turn runs on
+        // the processing thread
+        if (wakeWordReady_) {
+            wakeWordDetector_->startDetection([this](int keyword) {
+                if (keyword == 0) {
+                    {
+                        std::lock_guard<std::mutex> lock(runMutex_);
+                        wakePending_ = true;
+                    }
+                    runCV_.notify_all();
+                }
+            });
+        }
+        audioCapture_->startCapture([this](const std::vector<int16_t>& block) {
+            wakeWordDetector_->processAudio(block);
         });
         
         LOG_INFO("Jarvis started");
@@ -100,9 +120,16 @@ void JarvisCore::start() {
 
 void JarvisCore::stop() {
     if (running_) {
-        running_ = false;
+        {
+            std::lock_guard<std::mutex> lock(runMutex_);
+            running_ = false;
+        }
+        runCV_.notify_all();
         
         // Stop wake word detection
+        if (audioCapture_) {
+            audioCapture_->stopCapture();
+        }
         if (wakeWordDetector_) {
             wakeWordDetector_->stopDetection();
         }
@@ -152,10 +179,19 @@ void JarvisCore::processCommand(const std::string& command) {
 void JarvisCore::processingLoop() {
     LOG_INFO("Processing loop started");
     
-    while (running_) {
-        // Main processing happens here
-        // Currently handled by callbacks from wake word detector
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // Each wake word starts one turn; detections during a turn are dropped
+    std::unique_lock<std::mutex> lock(runMutex_);
+    while (true) {
+        runCV_.wait(lock, [this]() { return !running_ || wakePending_; });
+        if (!running_) {
+            break;
+        }
+        wakePending_ = false;
+        
+        lock.unlock();
+        handleWakeWordDetected();
+        lock.lock();
+        wakePending_ = false;
     }
     
     LOG_INFO("Processing loop stopped");
@@ -163,9 +199,9 @@ void JarvisCore::processingLoop() {
 
 void JarvisCore::handleWakeWordDetected() {
     LOG_INFO("Wake word detected");
-    textToSpeech_->speak("Yes?");
     
-    // Start speech recognition
+    // Listen straight away: a spoken prompt here would make the user wait
+    // for it and clip commands said in the same breath as the wake word
     if (speechRecognizer_->startRecognition()) {
         LOG_INFO("Listening for command...");
         
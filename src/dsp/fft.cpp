@@ -0,0 +1,105 @@
+#include "dsp/fft.h"
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+namespace jarvis::dsp {
+
+RealFft::RealFft(size_t size)
+    : size_(size), half_(size / 2), bitReversed_(half_), twiddles_(half_ / 2), unpack_(half_ + 1),
+      scratch_(half_ + 1) {
+    int bits = 0;
+    while ((size_t(1) << bits) < half_) {
+        ++bits;
+    }
+    for (size_t i = 0; i < half_; ++i) {
+        size_t reversed = 0;
+        for (int b = 0; b < bits; ++b) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        bitReversed_[i] = reversed;
+    }
+
+    // Computed in double so large transforms keep full float accuracy
+    for (size_t k = 0; k < twiddles_.size(); ++k) {
+        double angle = -2.0 * std::numbers::pi * k / half_;
+        twiddles_[k] = {static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle))};
+    }
+    for (size_t k = 0; k <= half_; ++k) {
+        double angle = -2.0 * std::numbers::pi * k / size_;
+        unpack_[k] = {static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle))};
+    }
+}
+
+void RealFft::transform(std::complex<float>* data) const {
+    for (size_t i = 0; i < half_; ++i) {
+        size_t j = bitReversed_[i];
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+    for (size_t length = 2; length <= half_; length <<= 1) {
+        size_t step = half_ / length;
+        size_t middle = length / 2;
+        for (size_t start = 0; start < half_; start += length) {
+            for (size_t k = 0; k < middle; ++k) {
+                std::complex<float> odd = data[start + k + middle] * twiddles_[k * step];
+                data[start + k + middle] = data[start + k] - odd;
+                data[start + k] += odd;
+            }
+        }
+    }
+}
+
+void RealFft::forward(const float* in, std::complex<float>* out) {
+    // Even samples as real parts, odd as imaginary
+    std::complex<float>* z = scratch_.data();
+    for (size_t n = 0; n < half_; ++n) {
+        z[n] = {in[2 * n], in[2 * n + 1]};
+    }
+    transform(z);
+    z[half_] = z[0];
+
+    // Split into the spectra of the even and odd samples and recombine
+    for (size_t k = 0; k <= half_; ++k) {
+        std::complex<float> a = z[k];
+        std::complex<float> b = std::conj(z[half_ - k]);
+        std::complex<float> even = 0.5f * (a + b);
+        std::complex<float> odd = std::complex<float>(0.0f, -0.5f) * (a - b);
+        out[k] = even + unpack_[k] * odd;
+    }
+}
+
+void RealFft::inverse(const std::complex<float>* in, float* out) {
+    std::complex<float>* z = scratch_.data();
+    for (size_t k = 0; k < half_; ++k) {
+        std::complex<float> a = in[k];
+        std::complex<float> b = std::conj(in[half_ - k]);
+        std::complex<float> even = 0.5f * (a + b);
+        std::complex<float> odd = 0.5f * (a - b) * std::conj(unpack_[k]);
+        // Conjugated, so the forward transform computes the inverse
+        z[k] = std::conj(even + std::complex<float>(0.0f, 1.0f) * odd);
+    }
+    transform(z);
+    const float scale = 1.0f / static_cast<float>(half_);
+    for (size_t n = 0; n < half_; ++n) {
+        out[2 * n] = z[n].real() * scale;
+        out[2 * n + 1] = -z[n].imag() * scale;
+    }
+}
+
+void powerSpectrum(const std::complex<float>* bins, float* power, size_t n) {
+    for (size_t k = 0; k < n; ++k) {
+        power[k] = bins[k].real() * bins[k].real() + bins[k].imag() * bins[k].imag();
+    }
+}
+
+std::vector<float> hannWindow(size_t length) {
+    std::vector<float> window(length);
+    for (size_t n = 0; n < length; ++n) {
+        window[n] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * std::numbers::pi * n / length));
+    }
+    return window;
+}
+
+} // namespace jarvis::dsp
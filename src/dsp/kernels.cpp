@@ -0,0 +1,896 @@
+#include "dsp/kernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define JARVIS_DSP_SSE2 1
+#endif
+
+#if defined(JARVIS_DSP_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define JARVIS_DSP_AVX2 1
+#define JARVIS_DSP_AVX512 1
+#endif
+
+namespace jarvis::dsp {
+
+namespace {
+
+// Reference implementations; every vector kernel finishes its tail with the next narrower one
+namespace scalar {
+
+int16_t saturate(float value) {
+    return static_cast<int16_t>(std::lrintf(std::min(std::max(value, -32768.0f), 32767.0f)));
+}
+
+void int16ToFloat(const int16_t* in, float* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = in[i] * (1.0f / 32768.0f);
+    }
+}
+
+void floatToInt16(const float* in, int16_t* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = saturate(in[i] * 32768.0f);
+    }
+}
+
+void gain(const int16_t* in, int16_t* out, size_t n, float gain) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = saturate(static_cast<float>(in[i]) * gain);
+    }
+}
+
+void gainClip(const float* in, float* out, size_t n, float gain, float limit) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = std::min(std::max(in[i] * gain, -limit), limit);
+    }
+}
+
+void mix(const int16_t* a, const int16_t* b, int16_t* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = static_cast<int16_t>(std::clamp(a[i] + b[i], -32768, 32767));
+    }
+}
+
+void mixAccumulate(float* acc, const float* in, size_t n, float gain) {
+    for (size_t i = 0; i < n; ++i) {
+        acc[i] += in[i] * gain;
+    }
+}
+
+uint64_t sumSquares(const int16_t* in, size_t n) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += static_cast<uint64_t>(static_cast<int32_t>(in[i]) * in[i]);
+    }
+    return sum;
+}
+
+float sumSquaresFloat(const float* in, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        sum += in[i] * in[i];
+    }
+    return sum;
+}
+
+int32_t peak(const int16_t* in, size_t n) {
+    int32_t peak = 0;
+    for (size_t i = 0; i < n; ++i) {
+        peak = std::max(peak, std::abs(static_cast<int32_t>(in[i])));
+    }
+    return peak;
+}
+
+float dot(const float* a, const float* b, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+void fir(const float* in, float* out, size_t n, const float* taps, size_t numTaps) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = dot(in + i, taps, numTaps);
+    }
+}
+
+float squaredDistance(const float* x, const float* row, size_t dim) {
+    float sum = 0.0f;
+    for (size_t k = 0; k < dim; ++k) {
+        float d = x[k] - row[k];
+        sum += d * d;
+    }
+    return sum;
+}
+
+void squaredDistances(const float* x, const float* rows, size_t count, size_t dim, float* out) {
+    for (size_t r = 0; r < count; ++r) {
+        out[r] = squaredDistance(x, rows + r * dim, dim);
+    }
+}
+
+int32_t dotInt8(const int8_t* w, const int8_t* x, size_t n) {
+    int32_t sum = 0;
+    for (size_t k = 0; k < n; ++k) {
+        sum += static_cast<int32_t>(w[k]) * x[k];
+    }
+    return sum;
+}
+
+void gemvInt8(const int8_t* w, const int8_t* x, size_t rows, size_t cols, int32_t* out) {
+    for (size_t r = 0; r < rows; ++r) {
+        out[r] = dotInt8(w + r * cols, x, cols);
+    }
+}
+
+} // namespace scalar
+
+#ifdef JARVIS_DSP_SSE2
+
+namespace sse2 {
+
+inline __m128i load(const int16_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+inline void store(int16_t* p, __m128i v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+
+// Sign-extended halves of eight 16-bit samples as floats
+inline __m128 lowFloats(__m128i x) { return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16)); }
+inline __m128 highFloats(__m128i x) { return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16)); }
+
+// Clamp before converting so out-of-range values saturate instead of becoming 0x80000000
+inline __m128i toInt32(__m128 v) {
+    return _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-32768.0f)), _mm_set1_ps(32767.0f)));
+}
+
+inline float horizontalSum(__m128 v) {
+    __m128 pairs = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+}
+
+void int16ToFloat(const int16_t* in, float* out, size_t n) {
+    const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i x = load(in + i);
+        _mm_storeu_ps(out + i, _mm_mul_ps(lowFloats(x), scale));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(highFloats(x), scale));
+    }
+    scalar::int16ToFloat(in + i, out + i, n - i);
+}
+
+void floatToInt16(const float* in, int16_t* out, size_t n) {
+    const __m128 scale = _mm_set1_ps(32768.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i lo = toInt32(_mm_mul_ps(_mm_loadu_ps(in + i), scale));
+        __m128i hi = toInt32(_mm_mul_ps(_mm_loadu_ps(in + i + 4), scale));
+        store(out + i, _mm_packs_epi32(lo, hi));
+    }
+    scalar::floatToInt16(in + i, out + i, n - i);
+}
+
+void gain(const int16_t* in, int16_t* out, size_t n, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i x = load(in + i);
+        store(out + i, _mm_packs_epi32(toInt32(_mm_mul_ps(lowFloats(x), g)),
+                                       toInt32(_mm_mul_ps(highFloats(x), g))));
+    }
+    scalar::gain(in + i, out + i, n - i, gain);
+}
+
+void gainClip(const float* in, float* out, size_t n, float gain, float limit) {
+    const __m128 g = _mm_set1_ps(gain);
+    const __m128 hi = _mm_set1_ps(limit);
+    const __m128 lo = _mm_set1_ps(-limit);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(out + i, _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i), g), lo), hi));
+    }
+    scalar::gainClip(in + i, out + i, n - i, gain, limit);
+}
+
+void mix(const int16_t* a, const int16_t* b, int16_t* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        store(out + i, _mm_adds_epi16(load(a + i), load(b + i)));
+    }
+    scalar::mix(a + i, b + i, out + i, n - i);
+}
+
+void mixAccumulate(float* acc, const float* in, size_t n, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(_mm_loadu_ps(in + i), g)));
+    }
+    scalar::mixAccumulate(acc + i, in + i, n - i, gain);
+}
+
+uint64_t sumSquares(const int16_t* in, size_t n) {
+    // A pair of squares fits 32 bits unsigned (2^31 at most); widen every pair to 64
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = zero;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i x = load(in + i);
+        __m128i pairs = _mm_madd_epi16(x, x);
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(pairs, zero));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(pairs, zero));
+    }
+    alignas(16) uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return lanes[0] + lanes[1] + scalar::sumSquares(in + i, n - i);
+}
+
+float sumSquaresFloat(const float* in, size_t n) {
+    __m128 a = _mm_setzero_ps();
+    __m128 b = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128 x = _mm_loadu_ps(in + i);
+        __m128 y = _mm_loadu_ps(in + i + 4);
+        a = _mm_add_ps(a, _mm_mul_ps(x, x));
+        b = _mm_add_ps(b, _mm_mul_ps(y, y));
+    }
+    return horizontalSum(_mm_add_ps(a, b)) + scalar::sumSquaresFloat(in + i, n - i);
+}
+
+int32_t peak(const int16_t* in, size_t n) {
+    // Track the extremes separately: |-32768| does not fit in 16 bits
+    __m128i high = _mm_setzero_si128();
+    __m128i low = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i x = load(in + i);
+        high = _mm_max_epi16(high, x);
+        low = _mm_min_epi16(low, x);
+    }
+    alignas(16) int16_t highs[8];
+    alignas(16) int16_t lows[8];
+    _mm_store_si128(reinterpret_cast<__m128i*>(highs), high);
+    _mm_store_si128(reinterpret_cast<__m128i*>(lows), low);
+    int32_t result = scalar::peak(in + i, n - i);
+    for (int k = 0; k < 8; ++k) {
+        result = std::max({result, static_cast<int32_t>(highs[k]), -static_cast<int32_t>(lows[k])});
+    }
+    return result;
+}
+
+float dot(const float* a, const float* b, size_t n) {
+    __m128 x = _mm_setzero_ps();
+    __m128 y = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        x = _mm_add_ps(x, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        y = _mm_add_ps(y, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    return horizontalSum(_mm_add_ps(x, y)) + scalar::dot(a + i, b + i, n - i);
+}
+
+// Vectorized across outputs: each tap is broadcast against eight consecutive windows
+void fir(const float* in, float* out, size_t n, const float* taps, size_t numTaps) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128 a = _mm_setzero_ps();
+        __m128 b = _mm_setzero_ps();
+        for (size_t k = 0; k < numTaps; ++k) {
+            __m128 h = _mm_set1_ps(taps[k]);
+            a = _mm_add_ps(a, _mm_mul_ps(h, _mm_loadu_ps(in + i + k)));
+            b = _mm_add_ps(b, _mm_mul_ps(h, _mm_loadu_ps(in + i + k + 4)));
+        }
+        _mm_storeu_ps(out + i, a);
+        _mm_storeu_ps(out + i + 4, b);
+    }
+    for (; i < n; ++i) {
+        out[i] = dot(in + i, taps, numTaps);
+    }
+}
+
+// Vectorized along each row; feature vectors are short, so no narrower table is called per row
+void squaredDistances(const float* x, const float* rows, size_t count, size_t dim, float* out) {
+    for (size_t r = 0; r < count; ++r) {
+        const float* row = rows + r * dim;
+        __m128 acc = _mm_setzero_ps();
+        size_t k = 0;
+        for (; k + 4 <= dim; k += 4) {
+            __m128 d = _mm_sub_ps(_mm_loadu_ps(x + k), _mm_loadu_ps(row + k));
+            acc = _mm_add_ps(acc, _mm_mul_ps(d, d));
+        }
+        out[r] = horizontalSum(acc) + scalar::squaredDistance(x + k, row + k, dim - k);
+    }
+}
+
+// Bytes sign-extended to 16 bits and multiplied in pairs; SSE2 has no byte multiply
+void gemvInt8(const int8_t* w, const int8_t* x, size_t rows, size_t cols, int32_t* out) {
+    for (size_t r = 0; r < rows; ++r) {
+        const int8_t* row = w + r * cols;
+        __m128i acc = _mm_setzero_si128();
+        size_t k = 0;
+        for (; k + 16 <= cols; k += 16) {
+            __m128i xv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + k));
+            __m128i wv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + k));
+            __m128i xlo = _mm_srai_epi16(_mm_unpacklo_epi8(xv, xv), 8);
+            __m128i xhi = _mm_srai_epi16(_mm_unpackhi_epi8(xv, xv), 8);
+            __m128i wlo = _mm_srai_epi16(_mm_unpacklo_epi8(wv, wv), 8);
+            __m128i whi = _mm_srai_epi16(_mm_unpackhi_epi8(wv, wv), 8);
+            acc = _mm_add_epi32(acc, _mm_add_epi32(_mm_madd_epi16(xlo, wlo), _mm_madd_epi16(xhi, whi)));
+        }
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+        out[r] = _mm_cvtsi128_si32(acc) + scalar::dotInt8(row + k, x + k, cols - k);
+    }
+}
+
+} // namespace sse2
+
+#endif
+
+#ifdef JARVIS_DSP_AVX2
+
+#define JARVIS_AVX2 __attribute__((target("avx2")))
+
+// Tails are handed to the SSE2 kernels, which are legacy-encoded: clear the
+// upper register halves first or every SSE instruction pays a merge penalty
+
+namespace avx2 {
+
+JARVIS_AVX2 inline __m256i load(const int16_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+JARVIS_AVX2 inline void store(int16_t* p, __m256i v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+
+JARVIS_AVX2 inline __m256 toFloats(const int16_t* p) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+}
+
+JARVIS_AVX2 inline __m256i toInt32(__m256 v) {
+    return _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(v, _mm256_set1_ps(-32768.0f)), _mm256_set1_ps(32767.0f)));
+}
+
+// packs works within 128-bit lanes; put the quadwords back in order
+JARVIS_AVX2 inline __m256i pack(__m256i lo, __m256i hi) {
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8);
+}
+
+JARVIS_AVX2 inline float horizontalSum(__m256 v) {
+    __m128 x = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    __m128 pairs = _mm_add_ps(x, _mm_movehl_ps(x, x));
+    return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+}
+
+JARVIS_AVX2 void int16ToFloat(const int16_t* in, float* out, size_t n) {
+    const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(toFloats(in + i), scale));
+        _mm256_storeu_ps(out + i + 8, _mm256_mul_ps(toFloats(in + i + 8), scale));
+    }
+    _mm256_zeroupper();
+    sse2::int16ToFloat(in + i, out + i, n - i);
+}
+
+JARVIS_AVX2 void floatToInt16(const float* in, int16_t* out, size_t n) {
+    const __m256 scale = _mm256_set1_ps(32768.0f);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i lo = toInt32(_mm256_mul_ps(_mm256_loadu_ps(in + i), scale));
+        __m256i hi = toInt32(_mm256_mul_ps(_mm256_loadu_ps(in + i + 8), scale));
+        store(out + i, pack(lo, hi));
+    }
+    _mm256_zeroupper();
+    sse2::floatToInt16(in + i, out + i, n - i);
+}
+
+JARVIS_AVX2 void gain(const int16_t* in, int16_t* out, size_t n, float gain) {
+    const __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i lo = toInt32(_mm256_mul_ps(toFloats(in + i), g));
+        __m256i hi = toInt32(_mm256_mul_ps(toFloats(in + i + 8), g));
+        store(out + i, pack(lo, hi));
+    }
+    _mm256_zeroupper();
+    sse2::gain(in + i, out + i, n - i, gain);
+}
+
+JARVIS_AVX2 void gainClip(const float* in, float* out, size_t n, float gain, float limit) {
+    const __m256 g = _mm256_set1_ps(gain);
+    const __m256 hi = _mm256_set1_ps(limit);
+    const __m256 lo = _mm256_set1_ps(-limit);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(in + i), g), lo), hi));
+    }
+    _mm256_zeroupper();
+    sse2::gainClip(in + i, out + i, n - i, gain, limit);
+}
+
+JARVIS_AVX2 void mix(const int16_t* a, const int16_t* b, int16_t* out, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        store(out + i, _mm256_adds_epi16(load(a + i), load(b + i)));
+    }
+    _mm256_zeroupper();
+    sse2::mix(a + i, b + i, out + i, n - i);
+}
+
+JARVIS_AVX2 void mixAccumulate(float* acc, const float* in, size_t n, float gain) {
+    const __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(acc + i, _mm256_add_ps(_mm256_loadu_ps(acc + i), _mm256_mul_ps(_mm256_loadu_ps(in + i), g)));
+    }
+    _mm256_zeroupper();
+    sse2::mixAccumulate(acc + i, in + i, n - i, gain);
+}
+
+JARVIS_AVX2 uint64_t sumSquares(const int16_t* in, size_t n) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc = zero;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i x = load(in + i);
+        __m256i pairs = _mm256_madd_epi16(x, x);
+        acc = _mm256_add_epi64(acc, _mm256_unpacklo_epi32(pairs, zero));
+        acc = _mm256_add_epi64(acc, _mm256_unpackhi_epi32(pairs, zero));
+    }
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    uint64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm256_zeroupper();
+    return sum + sse2::sumSquares(in + i, n - i);
+}
+
+JARVIS_AVX2 float sumSquaresFloat(const float* in, size_t n) {
+    __m256 a = _mm256_setzero_ps();
+    __m256 b = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 x = _mm256_loadu_ps(in + i);
+        __m256 y = _mm256_loadu_ps(in + i + 8);
+        a = _mm256_add_ps(a, _mm256_mul_ps(x, x));
+        b = _mm256_add_ps(b, _mm256_mul_ps(y, y));
+    }
+    float sum = horizontalSum(_mm256_add_ps(a, b));
+    _mm256_zeroupper();
+    return sum + sse2::sumSquaresFloat(in + i, n - i);
+}
+
+JARVIS_AVX2 int32_t peak(const int16_t* in, size_t n) {
+    __m256i high = _mm256_setzero_si256();
+    __m256i low = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i x = load(in + i);
+        high = _mm256_max_epi16(high, x);
+        low = _mm256_min_epi16(low, x);
+    }
+    __m128i high8 = _mm_max_epi16(_mm256_castsi256_si128(high), _mm256_extracti128_si256(high, 1));
+    __m128i low8 = _mm_min_epi16(_mm256_castsi256_si128(low), _mm256_extracti128_si256(low, 1));
+    alignas(16) int16_t highs[8];
+    alignas(16) int16_t lows[8];
+    _mm_store_si128(reinterpret_cast<__m128i*>(highs), high8);
+    _mm_store_si128(reinterpret_cast<__m128i*>(lows), low8);
+    _mm256_zeroupper();
+    int32_t result = sse2::peak(in + i, n - i);
+    for (int k = 0; k < 8; ++k) {
+        result = std::max({result, static_cast<int32_t>(highs[k]), -static_cast<int32_t>(lows[k])});
+    }
+    return result;
+}
+
+JARVIS_AVX2 float dot(const float* a, const float* b, size_t n) {
+    __m256 x = _mm256_setzero_ps();
+    __m256 y = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        x = _mm256_add_ps(x, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        y = _mm256_add_ps(y, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+    }
+    float sum = horizontalSum(_mm256_add_ps(x, y));
+    _mm256_zeroupper();
+    return sum + sse2::dot(a + i, b + i, n - i);
+}
+
+JARVIS_AVX2 void fir(const float* in, float* out, size_t n, const float* taps, size_t numTaps) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 a = _mm256_setzero_ps();
+        __m256 b = _mm256_setzero_ps();
+        for (size_t k = 0; k < numTaps; ++k) {
+            __m256 h = _mm256_set1_ps(taps[k]);
+            a = _mm256_add_ps(a, _mm256_mul_ps(h, _mm256_loadu_ps(in + i + k)));
+            b = _mm256_add_ps(b, _mm256_mul_ps(h, _mm256_loadu_ps(in + i + k + 8)));
+        }
+        _mm256_storeu_ps(out + i, a);
+        _mm256_storeu_ps(out + i + 8, b);
+    }
+    _mm256_zeroupper();
+    sse2::fir(in + i, out + i, n - i, taps, numTaps);
+}
+
+JARVIS_AVX2 void squaredDistances(const float* x, const float* rows, size_t count, size_t dim, float* out) {
+    for (size_t r = 0; r < count; ++r) {
+        const float* row = rows + r * dim;
+        __m256 acc = _mm256_setzero_ps();
+        size_t k = 0;
+        for (; k + 8 <= dim; k += 8) {
+            __m256 d = _mm256_sub_ps(_mm256_loadu_ps(x + k), _mm256_loadu_ps(row + k));
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(d, d));
+        }
+        float sum = horizontalSum(acc);
+        for (; k < dim; ++k) {
+            float d = x[k] - row[k];
+            sum += d * d;
+        }
+        out[r] = sum;
+    }
+    _mm256_zeroupper();
+}
+
+// |x| times w with x's sign moves the sign to the signed operand of the
+// unsigned-by-signed byte multiply; with w in [-127, 127] the pair sums
+// stay below 2 * 128 * 127 and never saturate
+JARVIS_AVX2 void gemvInt8(const int8_t* w, const int8_t* x, size_t rows, size_t cols, int32_t* out) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    for (size_t r = 0; r < rows; ++r) {
+        const int8_t* row = w + r * cols;
+        __m256i acc = _mm256_setzero_si256();
+        size_t k = 0;
+        for (; k + 32 <= cols; k += 32) {
+            __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + k));
+            __m256i wv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + k));
+            __m256i pairs = _mm256_maddubs_epi16(_mm256_abs_epi8(xv), _mm256_sign_epi8(wv, xv));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(pairs, ones));
+        }
+        __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        out[r] = _mm_cvtsi128_si32(sum) + scalar::dotInt8(row + k, x + k, cols - k);
+    }
+    _mm256_zeroupper();
+}
+
+} // namespace avx2
+
+#undef JARVIS_AVX2
+
+#endif
+
+#ifdef JARVIS_DSP_AVX512
+
+#define JARVIS_AVX512 __attribute__((target("avx512f,avx512bw")))
+
+namespace avx512 {
+
+JARVIS_AVX512 inline __m512i load(const int16_t* p) { return _mm512_loadu_si512(p); }
+
+JARVIS_AVX512 inline __m512 toFloats(const int16_t* p) {
+    return _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))));
+}
+
+// Sixteen clamped, rounded values narrowed to 16 bits
+JARVIS_AVX512 inline __m256i toInt16(__m512 v) {
+    v = _mm512_min_ps(_mm512_max_ps(v, _mm512_set1_ps(-32768.0f)), _mm512_set1_ps(32767.0f));
+    return _mm512_cvtsepi32_epi16(_mm512_cvtps_epi32(v));
+}
+
+JARVIS_AVX512 void int16ToFloat(const int16_t* in, float* out, size_t n) {
+    const __m512 scale = _mm512_set1_ps(1.0f / 32768.0f);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        _mm512_storeu_ps(out + i, _mm512_mul_ps(toFloats(in + i), scale));
+        _mm512_storeu_ps(out + i + 16, _mm512_mul_ps(toFloats(in + i + 16), scale));
+    }
+    avx2::int16ToFloat(in + i, out + i, n - i);
+}
+
+JARVIS_AVX512 void floatToInt16(const float* in, int16_t* out, size_t n) {
+    const __m512 scale = _mm512_set1_ps(32768.0f);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), toInt16(_mm512_mul_ps(_mm512_loadu_ps(in + i), scale)));
+    }
+    avx2::floatToInt16(in + i, out + i, n - i);
+}
+
+JARVIS_AVX512 void gain(const int16_t* in, int16_t* out, size_t n, float gain) {
+    const __m512 g = _mm512_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), toInt16(_mm512_mul_ps(toFloats(in + i), g)));
+    }
+    avx2::gain(in + i, out + i, n - i, gain);
+}
+
+JARVIS_AVX512 void gainClip(const float* in, float* out, size_t n, float gain, float limit) {
+    const __m512 g = _mm512_set1_ps(gain);
+    const __m512 hi = _mm512_set1_ps(limit);
+    const __m512 lo = _mm512_set1_ps(-limit);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(out + i, _mm512_min_ps(_mm512_max_ps(_mm512_mul_ps(_mm512_loadu_ps(in + i), g), lo), hi));
+    }
+    avx2::gainClip(in + i, out + i, n - i, gain, limit);
+}
+
+JARVIS_AVX512 void mix(const int16_t* a, const int16_t* b, int16_t* out, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        _mm512_storeu_si512(out + i, _mm512_adds_epi16(load(a + i), load(b + i)));
+    }
+    avx2::mix(a + i, b + i, out + i, n - i);
+}
+
+JARVIS_AVX512 void mixAccumulate(float* acc, const float* in, size_t n, float gain) {
+    const __m512 g = _mm512_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(acc + i, _mm512_add_ps(_mm512_loadu_ps(acc + i), _mm512_mul_ps(_mm512_loadu_ps(in + i), g)));
+    }
+    avx2::mixAccumulate(acc + i, in + i, n - i, gain);
+}
+
+JARVIS_AVX512 uint64_t sumSquares(const int16_t* in, size_t n) {
+    __m512i acc = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512i x = load(in + i);
+        __m512i pairs = _mm512_madd_epi16(x, x);
+        acc = _mm512_add_epi64(acc, _mm512_cvtepu32_epi64(_mm512_castsi512_si256(pairs)));
+        acc = _mm512_add_epi64(acc, _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(pairs, 1)));
+    }
+    return static_cast<uint64_t>(_mm512_reduce_add_epi64(acc)) + avx2::sumSquares(in + i, n - i);
+}
+
+JARVIS_AVX512 float sumSquaresFloat(const float* in, size_t n) {
+    __m512 a = _mm512_setzero_ps();
+    __m512 b = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512 x = _mm512_loadu_ps(in + i);
+        __m512 y = _mm512_loadu_ps(in + i + 16);
+        a = _mm512_add_ps(a, _mm512_mul_ps(x, x));
+        b = _mm512_add_ps(b, _mm512_mul_ps(y, y));
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(a, b)) + avx2::sumSquaresFloat(in + i, n - i);
+}
+
+JARVIS_AVX512 int32_t peak(const int16_t* in, size_t n) {
+    __m512i high = _mm512_setzero_si512();
+    __m512i low = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512i x = load(in + i);
+        high = _mm512_max_epi16(high, x);
+        low = _mm512_min_epi16(low, x);
+    }
+    // Widen to 32 bits to reduce; the halves cover all 32 lanes
+    __m512i highs = _mm512_max_epi32(_mm512_cvtepi16_epi32(_mm512_castsi512_si256(high)),
+                                      _mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(high, 1)));
+    __m512i lows = _mm512_min_epi32(_mm512_cvtepi16_epi32(_mm512_castsi512_si256(low)),
+                                     _mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(low, 1)));
+    return std::max({static_cast<int32_t>(_mm512_reduce_max_epi32(highs)),
+                     -static_cast<int32_t>(_mm512_reduce_min_epi32(lows)),
+                     avx2::peak(in + i, n - i)});
+}
+
+JARVIS_AVX512 float dot(const float* a, const float* b, size_t n) {
+    __m512 x = _mm512_setzero_ps();
+    __m512 y = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        x = _mm512_add_ps(x, _mm512_mul_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+        y = _mm512_add_ps(y, _mm512_mul_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16)));
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(x, y)) + avx2::dot(a + i, b + i, n - i);
+}
+
+JARVIS_AVX512 void fir(const float* in, float* out, size_t n, const float* taps, size_t numTaps) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512 a = _mm512_setzero_ps();
+        __m512 b = _mm512_setzero_ps();
+        for (size_t k = 0; k < numTaps; ++k) {
+            __m512 h = _mm512_set1_ps(taps[k]);
+            a = _mm512_add_ps(a, _mm512_mul_ps(h, _mm512_loadu_ps(in + i + k)));
+            b = _mm512_add_ps(b, _mm512_mul_ps(h, _mm512_loadu_ps(in + i + k + 16)));
+        }
+        _mm512_storeu_ps(out + i, a);
+        _mm512_storeu_ps(out + i + 16, b);
+    }
+    avx2::fir(in + i, out + i, n - i, taps, numTaps);
+}
+
+// A masked load covers the tail of each row
+JARVIS_AVX512 void squaredDistances(const float* x, const float* rows, size_t count, size_t dim, float* out) {
+    for (size_t r = 0; r < count; ++r) {
+        const float* row = rows + r * dim;
+        __m512 acc = _mm512_setzero_ps();
+        size_t k = 0;
+        for (; k + 16 <= dim; k += 16) {
+            __m512 d = _mm512_sub_ps(_mm512_loadu_ps(x + k), _mm512_loadu_ps(row + k));
+            acc = _mm512_fmadd_ps(d, d, acc);
+        }
+        if (k < dim) {
+            __mmask16 mask = static_cast<__mmask16>((1u << (dim - k)) - 1);
+            __m512 d = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, x + k), _mm512_maskz_loadu_ps(mask, row + k));
+            acc = _mm512_fmadd_ps(d, d, acc);
+        }
+        out[r] = _mm512_reduce_add_ps(acc);
+    }
+}
+
+// |x| and w with x's sign, as in the AVX2 kernel; the byte sign comes from a mask
+JARVIS_AVX512 inline void signedPair(__m512i xv, __m512i wv, __m512i& magnitude, __m512i& weight) {
+    magnitude = _mm512_abs_epi8(xv);
+    weight = _mm512_mask_sub_epi8(wv, _mm512_movepi8_mask(xv), _mm512_setzero_si512(), wv);
+}
+
+JARVIS_AVX512 void gemvInt8(const int8_t* w, const int8_t* x, size_t rows, size_t cols, int32_t* out) {
+    const __m512i ones = _mm512_set1_epi16(1);
+    const __mmask64 tail = (cols % 64) ? (~0ull >> (64 - cols % 64)) : 0;
+    for (size_t r = 0; r < rows; ++r) {
+        const int8_t* row = w + r * cols;
+        __m512i acc = _mm512_setzero_si512();
+        __m512i magnitude, weight;
+        size_t k = 0;
+        for (; k + 64 <= cols; k += 64) {
+            signedPair(_mm512_loadu_si512(x + k), _mm512_loadu_si512(row + k), magnitude, weight);
+            acc = _mm512_add_epi32(acc, _mm512_madd_epi16(_mm512_maddubs_epi16(magnitude, weight), ones));
+        }
+        if (tail) {
+            signedPair(_mm512_maskz_loadu_epi8(tail, x + k), _mm512_maskz_loadu_epi8(tail, row + k), magnitude,
+                       weight);
+            acc = _mm512_add_epi32(acc, _mm512_madd_epi16(_mm512_maddubs_epi16(magnitude, weight), ones));
+        }
+        out[r] = _mm512_reduce_add_epi32(acc);
+    }
+}
+
+} // namespace avx512
+
+#undef JARVIS_AVX512
+
+#define JARVIS_AVX512VNNI __attribute__((target("avx512f,avx512bw,avx512vnni")))
+
+// The AVX-512 table with one instruction for the byte multiply-accumulate
+namespace avx512vnni {
+
+using namespace avx512;
+
+JARVIS_AVX512VNNI void gemvInt8(const int8_t* w, const int8_t* x, size_t rows, size_t cols, int32_t* out) {
+    const __mmask64 tail = (cols % 64) ? (~0ull >> (64 - cols % 64)) : 0;
+    for (size_t r = 0; r < rows; ++r) {
+        const int8_t* row = w + r * cols;
+        __m512i acc = _mm512_setzero_si512();
+        __m512i magnitude, weight;
+        size_t k = 0;
+        for (; k + 64 <= cols; k += 64) {
+            signedPair(_mm512_loadu_si512(x + k), _mm512_loadu_si512(row + k), magnitude, weight);
+            acc = _mm512_dpbusd_epi32(acc, magnitude, weight);
+        }
+        if (tail) {
+            signedPair(_mm512_maskz_loadu_epi8(tail, x + k), _mm512_maskz_loadu_epi8(tail, row + k), magnitude,
+                       weight);
+            acc = _mm512_dpbusd_epi32(acc, magnitude, weight);
+        }
+        out[r] = _mm512_reduce_add_epi32(acc);
+    }
+}
+
+} // namespace avx512vnni
+
+#undef JARVIS_AVX512VNNI
+
+#endif
+
+#define JARVIS_KERNEL_TABLE(ns) \
+    Kernels{ns::int16ToFloat, ns::floatToInt16, ns::gain, ns::gainClip, ns::mix, ns::mixAccumulate, \
+            ns::sumSquares, ns::sumSquaresFloat, ns::peak, ns::dot, ns::fir, ns::squaredDistances, ns::gemvInt8}
+
+const Kernels scalarKernels = JARVIS_KERNEL_TABLE(scalar);
+#ifdef JARVIS_DSP_SSE2
+const Kernels sse2Kernels = JARVIS_KERNEL_TABLE(sse2);
+#endif
+#ifdef JARVIS_DSP_AVX2
+const Kernels avx2Kernels = JARVIS_KERNEL_TABLE(avx2);
+#endif
+#ifdef JARVIS_DSP_AVX512
+const Kernels avx512Kernels = JARVIS_KERNEL_TABLE(avx512);
+const Kernels avx512VnniKernels = JARVIS_KERNEL_TABLE(avx512vnni);
+#endif
+
+#undef JARVIS_KERNEL_TABLE
+
+std::atomic<const Kernels*>& activeKernels() {
+    static std::atomic<const Kernels*> active{kernelsFor(bestIsa())};
+    return active;
+}
+
+} // namespace
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return "scalar";
+        case Isa::SSE2: return "sse2";
+        case Isa::AVX2: return "avx2";
+        case Isa::AVX512: return "avx512";
+        case Isa::AVX512VNNI: return "avx512vnni";
+    }
+    return "unknown";
+}
+
+bool isSupported(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return true;
+#ifdef JARVIS_DSP_SSE2
+        case Isa::SSE2: return true;
+#endif
+#ifdef JARVIS_DSP_AVX2
+        case Isa::AVX2: return __builtin_cpu_supports("avx2");
+#endif
+#ifdef JARVIS_DSP_AVX512
+        case Isa::AVX512: return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+        case Isa::AVX512VNNI:
+            return isSupported(Isa::AVX512) && __builtin_cpu_supports("avx512vnni");
+#endif
+        default: return false;
+    }
+}
+
+Isa bestIsa() {
+    for (Isa isa : {Isa::AVX512VNNI, Isa::AVX512, Isa::AVX2, Isa::SSE2}) {
+        if (isSupported(isa)) {
+            return isa;
+        }
+    }
+    return Isa::Scalar;
+}
+
+const Kernels* kernelsFor(Isa isa) {
+    if (!isSupported(isa)) {
+        return nullptr;
+    }
+    switch (isa) {
+#ifdef JARVIS_DSP_SSE2
+        case Isa::SSE2: return &sse2Kernels;
+#endif
+#ifdef JARVIS_DSP_AVX2
+        case Isa::AVX2: return &avx2Kernels;
+#endif
+#ifdef JARVIS_DSP_AVX512
+        case Isa::AVX512: return &avx512Kernels;
+        case Isa::AVX512VNNI: return &avx512VnniKernels;
+#endif
+        default: return &scalarKernels;
+    }
+}
+
+const Kernels& kernels() {
+    return *activeKernels().load(std::memory_order_relaxed);
+}
+
+Isa activeIsa() {
+    const Kernels* active = activeKernels().load(std::memory_order_relaxed);
+    for (Isa isa : {Isa::AVX512VNNI, Isa::AVX512, Isa::AVX2, Isa::SSE2}) {
+        if (kernelsFor(isa) == active) {
+            return isa;
+        }
+    }
+    return Isa::Scalar;
+}
+
+bool setIsa(Isa isa) {
+    const Kernels* table = kernelsFor(isa);
+    if (!table) {
+        return false;
+    }
+    activeKernels().store(table, std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace jarvis::dsp
@@ -0,0 +1,60 @@
+#include "dsp/mel_filterbank.h"
+#include <algorithm>
+#include <cmath>
+
+namespace jarvis::dsp {
+
+MelFilterbank::MelFilterbank(size_t numMels, size_t fftSize, int sampleRate, float minFrequency,
+                             float maxFrequency)
+    : numBins_(fftSize / 2 + 1), filters_(numMels) {
+    const float nyquist = sampleRate / 2.0f;
+    const float low = hzToMel(std::clamp(minFrequency, 0.0f, nyquist));
+    const float high = hzToMel(std::clamp(maxFrequency, minFrequency, nyquist));
+    const float binHz = static_cast<float>(sampleRate) / fftSize;
+
+    // Filter m rises from edge m to a peak at edge m + 1 and falls to edge m + 2
+    std::vector<float> edges(numMels + 2);
+    for (size_t i = 0; i < edges.size(); ++i) {
+        edges[i] = melToHz(low + (high - low) * i / (numMels + 1)) / binHz;
+    }
+    for (size_t m = 0; m < numMels; ++m) {
+        const float left = edges[m], centre = edges[m + 1], right = edges[m + 2];
+        size_t first = static_cast<size_t>(std::ceil(left));
+        size_t last = std::min(numBins_ - 1, static_cast<size_t>(std::floor(right)));
+        Filter& filter = filters_[m];
+        filter.first = first;
+        for (size_t k = first; k <= last; ++k) {
+            float x = static_cast<float>(k);
+            float weight = x <= centre ? (x - left) / std::max(centre - left, 1e-6f)
+                                       : (right - x) / std::max(right - centre, 1e-6f);
+            filter.weights.push_back(std::max(0.0f, weight));
+        }
+        // Narrow low filters may fall between bins; give them the nearest one
+        if (filter.weights.empty() || *std::max_element(filter.weights.begin(), filter.weights.end()) == 0.0f) {
+            filter.first = std::min(numBins_ - 1, static_cast<size_t>(std::lround(centre)));
+            filter.weights.assign(1, 1.0f);
+        }
+    }
+}
+
+void MelFilterbank::apply(const float* power, float* out) const {
+    for (size_t m = 0; m < filters_.size(); ++m) {
+        const Filter& filter = filters_[m];
+        const float* p = power + filter.first;
+        float sum = 0.0f;
+        for (size_t k = 0; k < filter.weights.size(); ++k) {
+            sum += filter.weights[k] * p[k];
+        }
+        out[m] = sum;
+    }
+}
+
+float MelFilterbank::hzToMel(float hz) {
+    return 2595.0f * std::log10(1.0f + hz / 700.0f);
+}
+
+float MelFilterbank::melToHz(float mel) {
+    return 700.0f * (std::pow(10.0f, mel / 2595.0f) - 1.0f);
+}
+
+} // namespace jarvis::dsp
@@ -1,6 +1,9 @@
 #include <iostream>
 #include <csignal>
 #include <memory>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
 #include "core/jarvis_core.h"
 #include "utils/logger.h"
 #include "utils/config_manager.h"
@@ -17,9 +20,19 @@ void signalHandler(int signal) {
 }
 
 int main(int argc, char* argv[]) {
+#ifdef _WIN32
     // Set up signal handlers
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
+#else
+    // Block shutdown signals in every thread we spawn; the main thread
+    // sleeps in sigwait() instead of polling a flag
+    sigset_t shutdownSignals;
+    sigemptyset(&shutdownSignals);
+    sigaddset(&shutdownSignals, SIGINT);
+    sigaddset(&shutdownSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &shutdownSignals, nullptr);
+#endif
 
     std::cout << "==========================================" << std::endl;
     std::cout << "        Jarvis Voice Assistant v1.0.0     " << std::endl;
@@ -58,9 +71,15 @@ int main(int argc, char* argv[]) {
         jarvis->start();
 
         // Main loop
+#ifdef _WIN32
         while (running && jarvis->isRunning()) {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
+#else
+        int signal = 0;
+        sigwait(&shutdownSignals, &signal);
+        signalHandler(signal);
+#endif
 
         // Stop the voice assistant
         jarvis->stop();
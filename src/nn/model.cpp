@@ -0,0 +1,349 @@
+#include "nn/model.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace jarvis::nn {
+
+static_assert(sizeof(Model::FileHeader) == 32, "model file header layout");
+static_assert(sizeof(Model::LayerRecord) == 64, "model layer record layout");
+
+static size_t alignUp(size_t n) {
+    return (n + Model::kAlignment - 1) / Model::kAlignment * Model::kAlignment;
+}
+
+// a * b when it is at most limit; checked by division so a hostile header cannot wrap it
+static bool boundedProduct(size_t a, size_t b, size_t limit, size_t& product) {
+    if (a != 0 && b > limit / a) {
+        return false;
+    }
+    product = a * b;
+    return true;
+}
+
+size_t Model::Layer::macs() const {
+    return rows * cols + (type == LayerType::Gru ? rows * outputSize : 0);
+}
+
+const char* Model::layerTypeName(LayerType type) {
+    switch (type) {
+        case LayerType::Dense: return "dense";
+        case LayerType::Conv1d: return "conv1d";
+        case LayerType::Gru: return "gru";
+    }
+    return "unknown";
+}
+
+Model::Model() = default;
+
+Model::~Model() {
+    close();
+}
+
+bool Model::load(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        LOG_ERROR("Cannot open model: " + path);
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    CloseHandle(file);
+    if (!mapping) {
+        LOG_ERROR("Cannot map model: " + path);
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data_) {
+        CloseHandle(mapping);
+        LOG_ERROR("Cannot map model: " + path);
+        return false;
+    }
+    mapping_ = mapping;
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("Cannot open model: " + path);
+        return false;
+    }
+    struct stat info;
+    void* mapped = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        LOG_ERROR("Cannot map model: " + path);
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(mapped);
+    mapping_ = mapped;
+    size_ = static_cast<size_t>(info.st_size);
+#endif
+
+    if (!parse()) {
+        LOG_ERROR("Malformed model: " + path);
+        close();
+        return false;
+    }
+    LOG_INFO("Loaded model " + path + " (" + std::to_string(layers_.size()) + " layers, " +
+             std::to_string(size_) + " bytes)");
+    return true;
+}
+
+void Model::close() {
+    if (mapping_) {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+        CloseHandle(static_cast<HANDLE>(mapping_));
+#else
+        munmap(mapping_, size_);
+#endif
+    }
+    data_ = nullptr;
+    mapping_ = nullptr;
+    size_ = 0;
+    inputSize_ = 0;
+    layers_.clear();
+}
+
+bool Model::parse() {
+    if (size_ < sizeof(FileHeader)) {
+        return false;
+    }
+    FileHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (header.magic != kMagic || header.version != kVersion || header.layerCount == 0 || header.inputSize == 0 ||
+        header.layerCount > (size_ - sizeof(FileHeader)) / sizeof(LayerRecord)) {
+        return false;
+    }
+
+    // A blob of bytes at offset, aligned and inside the file
+    auto blob = [this](uint64_t offset, size_t bytes) -> const uint8_t* {
+        if (offset % kAlignment != 0 || offset > size_ || bytes > size_ - offset) {
+            return nullptr;
+        }
+        return data_ + offset;
+    };
+
+    size_t inputSize = header.inputSize;
+    inputSize_ = inputSize;
+    for (uint32_t i = 0; i < header.layerCount; ++i) {
+        LayerRecord record;
+        std::memcpy(&record, data_ + sizeof(FileHeader) + i * sizeof(LayerRecord), sizeof(record));
+
+        Layer layer;
+        layer.type = static_cast<LayerType>(record.type);
+        layer.activation = static_cast<Activation>(record.activation);
+        layer.inputSize = record.inputSize;
+        layer.outputSize = record.outputSize;
+        layer.kernelSize = record.kernelSize;
+        if (layer.inputSize != inputSize || layer.outputSize == 0 || layer.kernelSize == 0 ||
+            record.activation > static_cast<uint32_t>(Activation::Tanh)) {
+            return false;
+        }
+
+        // Every weight is a byte of the file, so no dimension or product of them can exceed its size
+        size_t recurrentCols = 0;
+        switch (layer.type) {
+            case LayerType::Dense:
+            case LayerType::Conv1d:
+                layer.rows = layer.outputSize;
+                if (!boundedProduct(layer.inputSize, layer.kernelSize, size_, layer.cols) ||
+                    (layer.type == LayerType::Dense && layer.kernelSize != 1)) {
+                    return false;
+                }
+                break;
+            case LayerType::Gru:
+                if (!boundedProduct(3, layer.outputSize, size_, layer.rows)) {
+                    return false;
+                }
+                layer.cols = layer.inputSize;
+                recurrentCols = layer.outputSize;
+                if (layer.kernelSize != 1) {
+                    return false;
+                }
+                break;
+            default:
+                return false;
+        }
+
+        const size_t sets = recurrentCols ? 2 : 1;
+        size_t weightBytes = 0;
+        size_t recurrentBytes = 0;
+        size_t vectorBytes = 0;
+        if (!boundedProduct(layer.rows, layer.cols, size_, weightBytes) ||
+            !boundedProduct(layer.rows, recurrentCols, size_, recurrentBytes) ||
+            !boundedProduct(sets * layer.rows, sizeof(float), size_, vectorBytes)) {
+            return false;
+        }
+        const uint8_t* weights = blob(record.weightsOffset, weightBytes + recurrentBytes);
+        const uint8_t* scales = blob(record.scalesOffset, vectorBytes);
+        const uint8_t* bias = blob(record.biasOffset, vectorBytes);
+        if (!weights || !scales || !bias) {
+            return false;
+        }
+
+        // The GEMV kernels take weights in [-127, 127]
+        const int8_t* w = reinterpret_cast<const int8_t*>(weights);
+        if (std::find(w, w + weightBytes + recurrentBytes, int8_t(-128)) != w + weightBytes + recurrentBytes) {
+            return false;
+        }
+
+        layer.weights = w;
+        layer.scales = reinterpret_cast<const float*>(scales);
+        layer.bias = reinterpret_cast<const float*>(bias);
+        if (recurrentCols) {
+            layer.recurrentWeights = w + weightBytes;
+            layer.recurrentScales = layer.scales + layer.rows;
+            layer.recurrentBias = layer.bias + layer.rows;
+        }
+        layers_.push_back(layer);
+        inputSize = layer.outputSize;
+    }
+    return true;
+}
+
+ModelWriter::ModelWriter(size_t inputSize) : inputSize_(inputSize), outputSize_(inputSize) {}
+
+void ModelWriter::quantizeRows(const std::vector<float>& weights, size_t rows, size_t cols, Pending& layer) const {
+    for (size_t r = 0; r < rows; ++r) {
+        const float* row = weights.data() + r * cols;
+        float peak = 0.0f;
+        for (size_t k = 0; k < cols; ++k) {
+            peak = std::max(peak, std::abs(row[k]));
+        }
+        float scale = peak > 0.0f ? peak / 127.0f : 1.0f;
+        for (size_t k = 0; k < cols; ++k) {
+            float q = std::round(row[k] / scale);
+            layer.weights.push_back(static_cast<int8_t>(std::clamp(q, -127.0f, 127.0f)));
+        }
+        layer.scales.push_back(scale);
+    }
+}
+
+void ModelWriter::addDense(size_t outputs, const std::vector<float>& weights, const std::vector<float>& bias,
+                           Activation activation) {
+    const size_t count = layers_.size();
+    addConv1d(outputs, 1, weights, bias, activation);
+    if (layers_.size() > count) {
+        layers_.back().record.type = static_cast<uint32_t>(Model::LayerType::Dense);
+    }
+}
+
+void ModelWriter::addConv1d(size_t outputs, size_t kernelSize, const std::vector<float>& weights,
+                            const std::vector<float>& bias, Activation activation) {
+    const size_t cols = outputSize_ * kernelSize;
+    if (outputs == 0 || kernelSize == 0 || weights.size() != outputs * cols || bias.size() != outputs) {
+        LOG_ERROR("Layer weights do not match its sizes");
+        valid_ = false;
+        return;
+    }
+
+    Pending layer{};
+    layer.record.type = static_cast<uint32_t>(Model::LayerType::Conv1d);
+    layer.record.activation = static_cast<uint32_t>(activation);
+    layer.record.inputSize = static_cast<uint32_t>(outputSize_);
+    layer.record.outputSize = static_cast<uint32_t>(outputs);
+    layer.record.kernelSize = static_cast<uint32_t>(kernelSize);
+    quantizeRows(weights, outputs, cols, layer);
+    layer.bias = bias;
+    layers_.push_back(std::move(layer));
+    outputSize_ = outputs;
+}
+
+void ModelWriter::addGru(size_t hidden, const std::vector<float>& inputWeights,
+                         const std::vector<float>& recurrentWeights, const std::vector<float>& inputBias,
+                         const std::vector<float>& recurrentBias) {
+    const size_t rows = 3 * hidden;
+    if (hidden == 0 || inputWeights.size() != rows * outputSize_ || recurrentWeights.size() != rows * hidden ||
+        inputBias.size() != rows || recurrentBias.size() != rows) {
+        LOG_ERROR("GRU weights do not match its sizes");
+        valid_ = false;
+        return;
+    }
+
+    Pending layer{};
+    layer.record.type = static_cast<uint32_t>(Model::LayerType::Gru);
+    layer.record.activation = static_cast<uint32_t>(Activation::None);
+    layer.record.inputSize = static_cast<uint32_t>(outputSize_);
+    layer.record.outputSize = static_cast<uint32_t>(hidden);
+    layer.record.kernelSize = 1;
+    quantizeRows(inputWeights, rows, outputSize_, layer);
+    quantizeRows(recurrentWeights, rows, hidden, layer);
+    layer.bias = inputBias;
+    layer.bias.insert(layer.bias.end(), recurrentBias.begin(), recurrentBias.end());
+    layers_.push_back(std::move(layer));
+    outputSize_ = hidden;
+}
+
+bool ModelWriter::save(const std::string& path) const {
+    if (!valid_ || layers_.empty()) {
+        LOG_ERROR("Nothing valid to save: " + path);
+        return false;
+    }
+
+    // Records first, then every layer's blobs on aligned offsets
+    std::vector<Model::LayerRecord> records;
+    size_t offset = alignUp(sizeof(Model::FileHeader) + layers_.size() * sizeof(Model::LayerRecord));
+    for (const auto& layer : layers_) {
+        Model::LayerRecord record = layer.record;
+        record.weightsOffset = offset;
+        offset = alignUp(offset + layer.weights.size());
+        record.scalesOffset = offset;
+        offset = alignUp(offset + layer.scales.size() * sizeof(float));
+        record.biasOffset = offset;
+        offset = alignUp(offset + layer.bias.size() * sizeof(float));
+        records.push_back(record);
+    }
+
+    std::vector<uint8_t> file(offset, 0);
+    Model::FileHeader header{};
+    header.magic = Model::kMagic;
+    header.version = Model::kVersion;
+    header.layerCount = static_cast<uint32_t>(layers_.size());
+    header.inputSize = static_cast<uint32_t>(inputSize_);
+    std::memcpy(file.data(), &header, sizeof(header));
+    for (size_t i = 0; i < layers_.size(); ++i) {
+        const Model::LayerRecord& record = records[i];
+        std::memcpy(file.data() + sizeof(header) + i * sizeof(record), &record, sizeof(record));
+        std::memcpy(file.data() + record.weightsOffset, layers_[i].weights.data(), layers_[i].weights.size());
+        std::memcpy(file.data() + record.scalesOffset, layers_[i].scales.data(),
+                    layers_[i].scales.size() * sizeof(float));
+        std::memcpy(file.data() + record.biasOffset, layers_[i].bias.data(), layers_[i].bias.size() * sizeof(float));
+    }
+
+    FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) {
+        LOG_ERROR("Cannot write model: " + path);
+        return false;
+    }
+    bool ok = std::fwrite(file.data(), 1, file.size(), out) == file.size();
+    ok &= std::fclose(out) == 0;
+    if (!ok) {
+        LOG_ERROR("Cannot write model: " + path);
+    }
+    return ok;
+}
+
+} // namespace jarvis::nn
@@ -0,0 +1,152 @@
+#include "nn/session.h"
+#include "dsp/kernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace jarvis::nn {
+
+using LayerType = Model::LayerType;
+using Activation = Model::Activation;
+
+static float sigmoid(float x) {
+    return 1.0f / (1.0f + std::exp(-x));
+}
+
+static void activate(Activation activation, float* x, size_t n) {
+    switch (activation) {
+        case Activation::None: break;
+        case Activation::Relu:
+            for (size_t i = 0; i < n; ++i) x[i] = std::max(x[i], 0.0f);
+            break;
+        case Activation::Sigmoid:
+            for (size_t i = 0; i < n; ++i) x[i] = sigmoid(x[i]);
+            break;
+        case Activation::Tanh:
+            for (size_t i = 0; i < n; ++i) x[i] = std::tanh(x[i]);
+            break;
+    }
+}
+
+Session::Session(const Model& model) : model_(model) {
+    size_t widest = model.inputSize();
+    size_t widestInput = 0;
+    size_t widestRows = 0;
+    for (const auto& layer : model.layers()) {
+        widest = std::max(widest, layer.outputSize);
+        widestInput = std::max({widestInput, layer.cols, layer.outputSize});
+        widestRows = std::max(widestRows, layer.rows);
+
+        LayerTiming timing;
+        timing.type = layer.type;
+        timing.macs = layer.macs();
+        timings_.push_back(timing);
+
+        switch (layer.type) {
+            case LayerType::Conv1d: state_.emplace_back(layer.cols, 0.0f); break;
+            case LayerType::Gru: state_.emplace_back(layer.outputSize, 0.0f); break;
+            default: state_.emplace_back(); break;
+        }
+    }
+    a_.resize(widest);
+    b_.resize(widest);
+    quantized_.resize(widestInput);
+    accumulators_.resize(widestRows);
+    gates_.resize(widestRows);
+    recurrentGates_.resize(widestRows);
+}
+
+void Session::reset() {
+    for (auto& state : state_) {
+        std::fill(state.begin(), state.end(), 0.0f);
+    }
+}
+
+void Session::resetTimings() {
+    for (auto& timing : timings_) {
+        timing.steps = 0;
+        timing.totalUs = 0.0;
+    }
+}
+
+float Session::quantize(const float* x, size_t n) {
+    float peak = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        peak = std::max(peak, std::abs(x[i]));
+    }
+    if (peak == 0.0f) {
+        std::fill(quantized_.begin(), quantized_.begin() + n, int8_t{0});
+        return 0.0f;
+    }
+    const float inverse = 127.0f / peak;
+    for (size_t i = 0; i < n; ++i) {
+        quantized_[i] = static_cast<int8_t>(std::lrintf(x[i] * inverse));
+    }
+    return peak / 127.0f;
+}
+
+void Session::affine(const int8_t* weights, const float* scales, const float* bias, size_t rows, size_t cols,
+                     float xScale, float* out) {
+    dsp::gemvInt8(weights, quantized_.data(), rows, cols, accumulators_.data());
+    for (size_t r = 0; r < rows; ++r) {
+        out[r] = static_cast<float>(accumulators_[r]) * (scales[r] * xScale) + bias[r];
+    }
+}
+
+void Session::runDense(const Model::Layer& layer, const float* in, float* out) {
+    float scale = quantize(in, layer.cols);
+    affine(layer.weights, layer.scales, layer.bias, layer.rows, layer.cols, scale, out);
+    activate(layer.activation, out, layer.outputSize);
+}
+
+void Session::runConv1d(size_t index, const Model::Layer& layer, const float* in, float* out) {
+    // Slide the window one frame and run it as one dense step
+    std::vector<float>& window = state_[index];
+    std::memmove(window.data(), window.data() + layer.inputSize, (layer.cols - layer.inputSize) * sizeof(float));
+    std::memcpy(window.data() + layer.cols - layer.inputSize, in, layer.inputSize * sizeof(float));
+    runDense(layer, window.data(), out);
+}
+
+void Session::runGru(size_t index, const Model::Layer& layer, const float* in, float* out) {
+    const size_t hidden = layer.outputSize;
+    std::vector<float>& h = state_[index];
+
+    float scale = quantize(in, layer.inputSize);
+    affine(layer.weights, layer.scales, layer.bias, layer.rows, layer.inputSize, scale, gates_.data());
+    scale = quantize(h.data(), hidden);
+    affine(layer.recurrentWeights, layer.recurrentScales, layer.recurrentBias, layer.rows, hidden, scale,
+           recurrentGates_.data());
+
+    for (size_t i = 0; i < hidden; ++i) {
+        float r = sigmoid(gates_[i] + recurrentGates_[i]);
+        float z = sigmoid(gates_[hidden + i] + recurrentGates_[hidden + i]);
+        float n = std::tanh(gates_[2 * hidden + i] + r * recurrentGates_[2 * hidden + i]);
+        h[i] = (1.0f - z) * n + z * h[i];
+    }
+    std::memcpy(out, h.data(), hidden * sizeof(float));
+}
+
+const float* Session::process(const float* input) {
+    const auto& layers = model_.layers();
+    const float* in = input;
+    float* out = a_.data();
+    for (size_t i = 0; i < layers.size(); ++i) {
+        auto start = timing_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        switch (layers[i].type) {
+            case LayerType::Dense: runDense(layers[i], in, out); break;
+            case LayerType::Conv1d: runConv1d(i, layers[i], in, out); break;
+            case LayerType::Gru: runGru(i, layers[i], in, out); break;
+        }
+        if (timing_) {
+            timings_[i].totalUs +=
+                std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            ++timings_[i].steps;
+        }
+        in = out;
+        out = out == a_.data() ? b_.data() : a_.data();
+    }
+    return in;
+}
+
+} // namespace jarvis::nn
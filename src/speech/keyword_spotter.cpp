@@ -0,0 +1,309 @@
+#include "speech/keyword_spotter.h"
+#include "audio/audio_source.h"
+#include "dsp/kernels.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <cmath>
+
+namespace jarvis {
+
+// Frames whose energy is this far below the loudest frame of a recording
+// (in natural log, about 20 dB) are silence around the keyword and not enrolled
+static constexpr float kTrimLogMel = 4.6f;
+
+// Shortest recording worth enrolling, in frames (100 ms)
+static constexpr size_t kMinTemplateFrames = 10;
+
+static SpectralFeatures::Params spotterAnalysis() {
+    // 25 ms windows every 10 ms; a few frames of history is all the spotter reads
+    SpectralFeatures::Params params;
+    params.historyMs = 100;
+    return params;
+}
+
+KeywordSpotter::KeywordSpotter() : KeywordSpotter(Params{}) {}
+
+KeywordSpotter::KeywordSpotter(const Params& params)
+    : params_(params),
+      features_(std::make_unique<SpectralFeatures>(kSampleRate, spotterAnalysis())) {
+    params_.cepstra = std::clamp(params_.cepstra, 1, static_cast<int>(kFeatureDim));
+    params_.maxStretch = std::max(1.0f, params_.maxStretch);
+
+    // Orthonormal DCT-II rows 1..cepstra; row 0 is the overall level, which
+    // depends on the microphone and distance rather than on what was said
+    const size_t mels = features_->numMels();
+    const float pi = 3.14159265358979f;
+    dct_.resize(static_cast<size_t>(params_.cepstra) * mels);
+    for (int k = 0; k < params_.cepstra; ++k) {
+        for (size_t m = 0; m < mels; ++m) {
+            dct_[k * mels + m] = std::sqrt(2.0f / mels) * std::cos(pi * (k + 1) * (m + 0.5f) / mels);
+        }
+    }
+
+    samples_.resize(features_->hopSize());
+    logMel_.resize(mels);
+    feature_.assign(kFeatureDim, 0.0f);
+    refractoryFrames_ = std::max(0, params_.refractoryMs) * kSampleRate / 1000 /
+                        static_cast<int>(features_->hopSize());
+}
+
+KeywordSpotter::~KeywordSpotter() = default;
+
+void KeywordSpotter::cepstrum(const float* logMel, float* out) const {
+    const size_t mels = logMel_.size();
+    for (int k = 0; k < params_.cepstra; ++k) {
+        out[k] = dsp::dot(dct_.data() + k * mels, logMel, mels);
+    }
+    std::fill(out + params_.cepstra, out + kFeatureDim, 0.0f);
+}
+
+KeywordSpotter::Template KeywordSpotter::extractTemplate(const std::vector<int16_t>& recording) const {
+    // A private analysis, long enough to hold the whole recording, so
+    // enrollment never disturbs the live stream
+    SpectralFeatures::Params params;
+    params.historyMs = static_cast<int>(recording.size() * 1000 / kSampleRate) + 100;
+    SpectralFeatures analysis(kSampleRate, params);
+    std::vector<float> samples(recording.size());
+    dsp::int16ToFloat(recording.data(), samples.data(), recording.size());
+
+    Template result;
+    const size_t mels = analysis.numMels();
+    const size_t frames = analysis.process(samples);
+    if (frames == 0) {
+        return result;
+    }
+
+    std::vector<float> logMel(frames * mels);
+    std::vector<float> level(frames);
+    for (size_t f = 0; f < frames; ++f) {
+        analysis.readLogMel(f, logMel.data() + f * mels);
+        float energy = 0.0f;
+        for (size_t m = 0; m < mels; ++m) {
+            energy += std::exp(logMel[f * mels + m]);
+        }
+        level[f] = std::log(energy);
+    }
+
+    // Keep the span between the first and last frame near the loudest level
+    const float floor = *std::max_element(level.begin(), level.end()) - kTrimLogMel;
+    size_t first = 0, last = frames;
+    while (first < last && level[first] < floor) {
+        ++first;
+    }
+    while (last > first && level[last - 1] < floor) {
+        --last;
+    }
+
+    result.frames = last - first;
+    result.features.assign(result.frames * kFeatureDim, 0.0f);
+    for (size_t f = 0; f < result.frames; ++f) {
+        cepstrum(logMel.data() + (first + f) * mels, result.features.data() + f * kFeatureDim);
+    }
+    return result;
+}
+
+int KeywordSpotter::enroll(const std::string& name, const std::vector<std::string>& wavPaths, float sensitivity) {
+    std::vector<std::vector<int16_t>> recordings;
+    for (const auto& path : wavPaths) {
+        FileAudioSource file;
+        if (!file.open(path)) {
+            LOG_WARNING("Cannot read keyword recording: " + path);
+            continue;
+        }
+        if (file.getSampleRate() != kSampleRate || file.getChannels() != 1) {
+            LOG_WARNING("Keyword recording is not 16 kHz mono: " + path);
+            continue;
+        }
+
+        std::vector<int16_t> recording;
+        int16_t block[1024];
+        for (size_t n; (n = file.read(block, 1024)) > 0;) {
+            recording.insert(recording.end(), block, block + n);
+        }
+        recordings.push_back(std::move(recording));
+    }
+    return enroll(name, recordings, sensitivity);
+}
+
+int KeywordSpotter::enroll(const std::string& name, const std::vector<std::vector<int16_t>>& recordings,
+                           float sensitivity) {
+    Keyword keyword;
+    keyword.name = name;
+    for (const auto& recording : recordings) {
+        Template reference = extractTemplate(recording);
+        if (reference.frames < kMinTemplateFrames) {
+            LOG_WARNING("Keyword recording too short or silent: " + name);
+            continue;
+        }
+        Alignment alignment;
+        alignment.reference = std::move(reference);
+        keyword.alignments.push_back(std::move(alignment));
+    }
+    if (keyword.alignments.empty()) {
+        LOG_ERROR("No usable recordings for keyword: " + name);
+        return kNoKeyword;
+    }
+
+    // Accept audio a few times as far from the recordings as they are from
+    // each other: at sensitivity 0 no farther, at 0.5 (the default) 2.5x, at 1 4x
+    sensitivity = std::clamp(sensitivity, 0.0f, 1.0f);
+    float spread = 0.0f;
+    int pairs = 0;
+    for (size_t a = 0; a < keyword.alignments.size(); ++a) {
+        for (size_t b = a + 1; b < keyword.alignments.size(); ++b) {
+            spread += alignmentCost(keyword.alignments[a].reference, keyword.alignments[b].reference);
+            ++pairs;
+        }
+    }
+    keyword.threshold = pairs > 0 ? std::max(spread / pairs, params_.minSpread) * (1.0f + 3.0f * sensitivity)
+                                  : params_.threshold * (0.5f + sensitivity);
+
+    for (auto& alignment : keyword.alignments) {
+        const size_t frames = alignment.reference.frames;
+        alignment.cost.assign(frames, kInfinity);
+        alignment.length.assign(frames, 0);
+        alignment.nextCost.resize(frames);
+        alignment.nextLength.resize(frames);
+    }
+    for (const auto& alignment : keyword.alignments) {
+        distances_.resize(std::max(distances_.size(), alignment.reference.frames));
+    }
+
+    LOG_INFO("Enrolled keyword '" + name + "' from " + std::to_string(keyword.alignments.size()) +
+             " recordings, threshold " + std::to_string(keyword.threshold));
+    keywords_.push_back(std::move(keyword));
+    return static_cast<int>(keywords_.size()) - 1;
+}
+
+void KeywordSpotter::step(Alignment& alignment, const float* distances, bool openBegin) const {
+    const size_t frames = alignment.reference.frames;
+    const uint32_t maxLength = static_cast<uint32_t>(params_.maxStretch * frames);
+    const float* cost = alignment.cost.data();
+    const uint32_t* length = alignment.length.data();
+    float* nextCost = alignment.nextCost.data();
+    uint32_t* nextLength = alignment.nextLength.data();
+
+    // Each input frame either holds the template frame, advances one, or
+    // skips one; of the paths that could reach a template frame, the one
+    // with the lowest mean distance per input frame continues
+    for (size_t j = 0; j < frames; ++j) {
+        float best = kInfinity;
+        float bestCost = kInfinity;
+        uint32_t bestLength = 0;
+        if (j == 0 && openBegin) {
+            best = distances[0];
+            bestCost = 0.0f;
+        }
+        for (size_t back = 0; back <= 2 && back <= j; ++back) {
+            const float c = cost[j - back];
+            const uint32_t l = length[j - back];
+            if (c == kInfinity || l >= maxLength) {
+                continue;
+            }
+            const float mean = (c + distances[j]) / (l + 1);
+            if (mean < best) {
+                best = mean;
+                bestCost = c;
+                bestLength = l;
+            }
+        }
+        nextCost[j] = bestCost == kInfinity ? kInfinity : bestCost + distances[j];
+        nextLength[j] = bestLength + 1;
+    }
+    alignment.cost.swap(alignment.nextCost);
+    alignment.length.swap(alignment.nextLength);
+}
+
+void KeywordSpotter::distancesTo(const Template& reference, const float* feature, float* out) const {
+    dsp::squaredDistances(feature, reference.features.data(), reference.frames, kFeatureDim, out);
+    for (size_t j = 0; j < reference.frames; ++j) {
+        out[j] = std::sqrt(out[j]);
+    }
+}
+
+float KeywordSpotter::alignmentCost(const Template& a, const Template& b) const {
+    // Both directions, since a path's mean is taken over the frames of its input
+    auto oneWay = [this](const Template& input, const Template& reference) {
+        Alignment alignment;
+        alignment.reference = reference;
+        alignment.cost.assign(reference.frames, kInfinity);
+        alignment.length.assign(reference.frames, 0);
+        alignment.nextCost.resize(reference.frames);
+        alignment.nextLength.resize(reference.frames);
+        std::vector<float> distances(reference.frames);
+        for (size_t i = 0; i < input.frames; ++i) {
+            distancesTo(reference, input.features.data() + i * kFeatureDim, distances.data());
+            step(alignment, distances.data(), i == 0);
+        }
+        const size_t end = reference.frames - 1;
+        return alignment.cost[end] / std::max<uint32_t>(1, alignment.length[end]);
+    };
+    if (a.frames == 0 || b.frames == 0) {
+        return kInfinity;
+    }
+    return 0.5f * (oneWay(a, b) + oneWay(b, a));
+}
+
+int KeywordSpotter::process(const int16_t* frame) {
+    dsp::int16ToFloat(frame, samples_.data(), samples_.size());
+    features_->process(samples_);
+
+    int detected = kNoKeyword;
+    float detectedMargin = 1.0f;
+    for (; nextFrame_ < features_->framesWritten(); ++nextFrame_) {
+        if (!features_->readLogMel(nextFrame_, logMel_.data())) {
+            continue;
+        }
+        cepstrum(logMel_.data(), feature_.data());
+
+        for (size_t k = 0; k < keywords_.size(); ++k) {
+            Keyword& keyword = keywords_[k];
+            float score = kInfinity;
+            for (auto& alignment : keyword.alignments) {
+                distancesTo(alignment.reference, feature_.data(), distances_.data());
+                step(alignment, distances_.data(), true);
+                const size_t end = alignment.reference.frames - 1;
+                if (alignment.cost[end] != kInfinity) {
+                    score = std::min(score, alignment.cost[end] / alignment.length[end]);
+                }
+            }
+            keyword.bestScore = std::min(keyword.bestScore, score);
+
+            if (keyword.refractory > 0) {
+                --keyword.refractory;
+                continue;
+            }
+            // Several keywords in one frame: report the clearest match
+            const float margin = score / keyword.threshold;
+            if (margin < detectedMargin) {
+                detected = static_cast<int>(k);
+                detectedMargin = margin;
+            }
+        }
+    }
+
+    if (detected != kNoKeyword) {
+        // Start the detected keyword's alignments afresh so the same utterance
+        // is not reported again
+        Keyword& keyword = keywords_[detected];
+        keyword.refractory = refractoryFrames_;
+        for (auto& alignment : keyword.alignments) {
+            std::fill(alignment.cost.begin(), alignment.cost.end(), kInfinity);
+        }
+    }
+    return detected;
+}
+
+void KeywordSpotter::reset() {
+    features_->reset();
+    nextFrame_ = 0;
+    for (auto& keyword : keywords_) {
+        keyword.refractory = 0;
+        keyword.bestScore = kInfinity;
+        for (auto& alignment : keyword.alignments) {
+            std::fill(alignment.cost.begin(), alignment.cost.end(), kInfinity);
+        }
+    }
+}
+
+} // namespace jarvis
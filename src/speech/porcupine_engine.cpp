@@ -0,0 +1,119 @@
+#include "speech/porcupine_engine.h"
+#include "utils/logger.h"
+#include <cstdlib>
+
+#ifdef PORCUPINE_FOUND
+#include <pv_porcupine.h>
+#endif
+
+namespace jarvis {
+
+PorcupineEngine::PorcupineEngine(pv_porcupine_t* porcupine, size_t keywordCount)
+    : porcupine_(porcupine), keywordCount_(keywordCount) {}
+
+#ifdef PORCUPINE_FOUND
+
+bool PorcupineEngine::available() {
+    return true;
+}
+
+std::unique_ptr<PorcupineEngine> PorcupineEngine::create(const std::string& modelPath,
+                                                         const std::vector<Keyword>& keywords) {
+    if (modelPath.empty()) {
+        LOG_ERROR("Model path is empty");
+        return nullptr;
+    }
+
+    std::vector<const char*> paths;
+    std::vector<float> sensitivities;
+    for (const auto& keyword : keywords) {
+        if (keyword.path.empty()) {
+            LOG_ERROR("Keyword path is empty");
+            return nullptr;
+        }
+        paths.push_back(keyword.path.c_str());
+        sensitivities.push_back(keyword.sensitivity);
+    }
+
+    const char* access_key = std::getenv("PICOVOICE_ACCESS_KEY");
+    if (!access_key) {
+        LOG_ERROR("PICOVOICE_ACCESS_KEY environment variable not set");
+        return nullptr;
+    }
+
+    pv_porcupine_t* porcupine = nullptr;
+    pv_status_t status = pv_porcupine_init(
+        access_key,
+        modelPath.c_str(),
+        static_cast<int32_t>(paths.size()),
+        paths.data(),
+        sensitivities.data(),
+        &porcupine
+    );
+
+    if (status != PV_STATUS_SUCCESS) {
+        LOG_ERROR(std::string("Failed to initialize Porcupine: ") + pv_status_to_string(status));
+        return nullptr;
+    }
+
+    return std::unique_ptr<PorcupineEngine>(new PorcupineEngine(porcupine, keywords.size()));
+}
+
+PorcupineEngine::~PorcupineEngine() {
+    if (porcupine_) {
+        pv_porcupine_delete(porcupine_);
+    }
+}
+
+int PorcupineEngine::sampleRate() const {
+    return pv_sample_rate();
+}
+
+int PorcupineEngine::frameLength() const {
+    return pv_porcupine_frame_length();
+}
+
+int PorcupineEngine::process(const int16_t* frame) {
+    int32_t keyword_index = -1;
+    pv_status_t status = pv_porcupine_process(porcupine_, frame, &keyword_index);
+
+    if (status != PV_STATUS_SUCCESS) {
+        LOG_ERROR(std::string("Porcupine processing failed: ") + pv_status_to_string(status));
+        return kNoKeyword;
+    }
+
+    return keyword_index >= 0 && keyword_index < static_cast<int32_t>(keywordCount_) ? keyword_index : kNoKeyword;
+}
+
+#else
+
+bool PorcupineEngine::available() {
+    return false;
+}
+
+std::unique_ptr<PorcupineEngine> PorcupineEngine::create(const std::string& modelPath,
+                                                         const std::vector<Keyword>& keywords) {
+    (void)modelPath;
+    (void)keywords;
+    LOG_WARNING("Porcupine not available in this build");
+    return nullptr;
+}
+
+PorcupineEngine::~PorcupineEngine() = default;
+
+int PorcupineEngine::sampleRate() const {
+    return 16000;
+}
+
+int PorcupineEngine::frameLength() const {
+    return 512;
+}
+
+int PorcupineEngine::process(const int16_t* frame) {
+    (void)frame;
+    return kNoKeyword;
+}
+
+#endif
+
+} // namespace jarvis
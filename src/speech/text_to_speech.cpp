@@ -1,5 +1,8 @@
 #include "speech/text_to_speech.h"
+#include "audio/audio_resampler.h"
 #include "utils/logger.h"
+#include <atomic>
+#include <cmath>
 #include <iostream>
 #include <stdexcept>
 
@@ -16,6 +19,9 @@ public:
     int rate = 175;  // Words per minute
     int volume = 100;  // 0-100
     bool blocking = false;
+    bool renderOnly = false;
+    int synthRate = 22050;  // eSpeak's output rate, reported by espeak_Initialize()
+    std::atomic<bool> cancelled{false};
     
 #ifdef ESPEAK_FOUND
     espeak_POSITION_TYPE positionType = POS_CHARACTER;
@@ -23,6 +29,26 @@ public:
 #endif
 };
 
+#ifdef ESPEAK_FOUND
+// Synthesis in progress: where the audio goes and whether stop() was called
+struct SynthTarget {
+    std::vector<int16_t>* speech;
+    const std::atomic<bool>* cancelled;
+};
+
+// Appends each block eSpeak renders; returning 1 aborts the synthesis
+static int collectSpeech(short* wav, int numSamples, espeak_EVENT* events) {
+    auto* target = static_cast<SynthTarget*>(events->user_data);
+    if (!target || target->cancelled->load(std::memory_order_relaxed)) {
+        return 1;
+    }
+    if (wav && numSamples > 0) {
+        target->speech->insert(target->speech->end(), wav, wav + numSamples);
+    }
+    return 0;
+}
+#endif
+
 TextToSpeech::TextToSpeech() : impl_(std::make_unique<Impl>()) {}
 TextToSpeech::~TextToSpeech() {
     cleanup();
@@ -30,8 +56,17 @@ TextToSpeech::~TextToSpeech() {
 
 bool TextToSpeech::initialize() {
 #ifdef ESPEAK_FOUND
-    // Initialize eSpeak NG
-    espeak_Initialize(impl_->outputType, 0, nullptr, 0);
+    // Initialize eSpeak NG; rendering to a buffer runs synthesis on the caller's thread
+    if (impl_->renderOnly) {
+        impl_->outputType = AUDIO_OUTPUT_SYNCHRONOUS;
+    }
+    int rate = espeak_Initialize(impl_->outputType, 0, nullptr, 0);
+    if (rate > 0) {
+        impl_->synthRate = rate;
+    }
+    if (impl_->renderOnly) {
+        espeak_SetSynthCallback(collectSpeech);
+    }
     
     // Set voice properties
     espeak_SetVoiceByName(impl_->voice.c_str());
@@ -112,6 +147,52 @@ bool TextToSpeech::speakAsync(const std::string& text) {
     return true;
 }
 
+std::vector<int16_t> TextToSpeech::synthesize(const std::string& text, int sampleRate) {
+    std::vector<int16_t> speech;
+    if (!impl_->initialized || text.empty()) {
+        return speech;
+    }
+    impl_->cancelled = false;
+
+#ifdef ESPEAK_FOUND
+    if (!impl_->renderOnly) {
+        LOG_ERROR("Text-to-speech plays on its own device; set render-only before initialize()");
+        return speech;
+    }
+
+    SynthTarget target{&speech, &impl_->cancelled};
+    espeak_ERROR result = espeak_Synth(text.c_str(), text.length() + 1, 0, POS_CHARACTER, 0,
+                                       espeakCHARS_AUTO, nullptr, &target);
+    if (result != EE_OK || impl_->cancelled) {
+        return {};
+    }
+
+    // Pad by the filter delay so resampling does not clip the last phoneme
+    AudioResampler resampler(impl_->synthRate, sampleRate);
+    speech.resize(speech.size() + static_cast<size_t>(std::ceil(resampler.getLatencyFrames())), 0);
+    return resampler.resample(speech.data(), speech.size());
+#else
+    // Placeholder implementation: nothing to play
+    (void)sampleRate;
+    std::cout << "[TTS] " << text << std::endl;
+    LOG_INFO("Placeholder TTS: " << text);
+    return speech;
+#endif
+}
+
+void TextToSpeech::setRenderOnly(bool renderOnly) {
+    impl_->renderOnly = renderOnly;
+}
+
+void TextToSpeech::stop() {
+    impl_->cancelled = true;
+#ifdef ESPEAK_FOUND
+    if (impl_->initialized && !impl_->renderOnly) {
+        espeak_Cancel();
+    }
+#endif
+}
+
 void TextToSpeech::setVoice(const std::string& voice) {
     impl_->voice = voice;
 #ifdef ESPEAK_FOUND
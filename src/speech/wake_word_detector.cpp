@@ -1,98 +1,20 @@
 #include "speech/wake_word_detector.h"
+#include "speech/keyword_spotter.h"
+#include "speech/porcupine_engine.h"
+#include "utils/config_manager.h"
 #include "utils/logger.h"
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
-#ifdef PORCUPINE_FOUND
-#include <pv_porcupine.h>
-#endif
-
 namespace jarvis {
 
-class WakeWordDetector::AudioCapture {
-public:
-    AudioCapture() : stream_(nullptr) {}
-    ~AudioCapture() {
-        stopCapture();
-    }
-    
-    bool initialize(int sampleRate, int channels) {
-        sampleRate_ = sampleRate;
-        channels_ = channels;
-        
-        PaError err = Pa_Initialize();
-        if (err != paNoError) {
-            LOG_ERROR("PortAudio initialization failed: " << Pa_GetErrorText(err));
-            return false;
-        }
-        
-        err = Pa_OpenDefaultStream(&stream_, 
-                                   channels, 
-                                   0, 
-                                   paInt16, 
-                                   sampleRate, 
-                                   512, 
-                                   nullptr, 
-                                   nullptr);
-        
-        if (err != paNoError) {
-            LOG_ERROR("Failed to open audio stream: " << Pa_GetErrorText(err));
-            return false;
-        }
-        
-        return true;
-    }
-    
-    void startCapture(std::function<void(const std::vector<int16_t>&)> callback) {
-        if (!stream_) return;
-        
-        captureCallback_ = callback;
-        shouldCapture_ = true;
-        
-        PaError err = Pa_StartStream(stream_);
-        if (err != paNoError) {
-            LOG_ERROR("Failed to start audio stream: " << Pa_GetErrorText(err));
-            return;
-        }
-        
-        captureThread_ = std::thread([this]() {
-            while (shouldCapture_) {
-                std::vector<int16_t> buffer(512);
-                Pa_ReadStream(stream_, buffer.data(), buffer.size());
-                if (captureCallback_) {
-                    captureCallback_(buffer);
-                }
-            }
-        });
-    }
-    
-    void stopCapture() {
-        shouldCapture_ = false;
-        if (captureThread_.joinable()) {
-            captureThread_.join();
-        }
-        
-        if (stream_) {
-            Pa_StopStream(stream_);
-            Pa_CloseStream(stream_);
-            stream_ = nullptr;
-        }
-        
-        Pa_Terminate();
-    }
-
-private:
-    PaStream* stream_;
-    int sampleRate_;
-    int channels_;
-    std::thread captureThread_;
-    std::atomic<bool> shouldCapture_{false};
-    std::function<void(const std::vector<int16_t>&)> captureCallback_;
-};
+// Frame length until an engine is set: Porcupine's
+static constexpr int kDefaultFrameLength = 512;
+static constexpr int kDefaultSampleRate = 16000;
 
 WakeWordDetector::WakeWordDetector() 
-    : porcupine_(nullptr, [](pv_porcupine_t*) {})
-    , audioCapture_(std::make_unique<AudioCapture>()) {}
+    : frameAssembler_(std::make_unique<FrameAssembler>(kDefaultFrameLength)) {}
 
 WakeWordDetector::~WakeWordDetector() {
     stopDetection();
@@ -101,41 +23,126 @@ WakeWordDetector::~WakeWordDetector() {
 bool WakeWordDetector::initialize(const std::string& modelPath, 
                                 const std::string& keywordPath, 
                                 float sensitivity) {
-#ifdef PORCUPINE_FOUND
-    if (modelPath.empty() || keywordPath.empty()) {
-        LOG_ERROR("Model path or keyword path is empty");
+    Keyword keyword;
+    keyword.name = "wake word";
+    keyword.path = keywordPath;
+    keyword.sensitivity = sensitivity;
+    return initialize(modelPath, std::vector<Keyword>{keyword});
+}
+
+bool WakeWordDetector::initialize(const std::string& modelPath, const std::vector<Keyword>& keywords,
+                                  Engine engine) {
+    if (keywords.empty()) {
+        LOG_ERROR("No keywords to detect");
         return false;
     }
 
-    pv_porcupine_t* porcupine = nullptr;
-    const char* access_key = std::getenv("PICOVOICE_ACCESS_KEY");
-    if (!access_key) {
-        LOG_ERROR("PICOVOICE_ACCESS_KEY environment variable not set");
-        return false;
+    bool allPaths = std::all_of(keywords.begin(), keywords.end(), [](const Keyword& k) { return !k.path.empty(); });
+    bool allRecordings =
+        std::all_of(keywords.begin(), keywords.end(), [](const Keyword& k) { return !k.recordings.empty(); });
+    if (engine == Engine::Auto) {
+        if (PorcupineEngine::available() && allPaths && !modelPath.empty()) {
+            engine = Engine::Porcupine;
+        } else if (allRecordings) {
+            engine = Engine::Builtin;
+        } else {
+            LOG_WARNING(std::string("No usable wake word engine: ") +
+                        (PorcupineEngine::available() ? "Porcupine needs a model and a .ppn keyword file"
+                                                      : "this build has no Porcupine") +
+                        ", and the built-in spotter needs recordings for every keyword");
+            return false;
+        }
+    }
+
+    if (engine == Engine::Porcupine) {
+        // One engine instance scores every keyword in the same call
+        std::vector<PorcupineEngine::Keyword> files;
+        for (const auto& keyword : keywords) {
+            files.push_back({keyword.path, keyword.sensitivity});
+        }
+        return setEngine(PorcupineEngine::create(modelPath, files), keywords);
+    }
+
+    auto spotter = std::make_unique<KeywordSpotter>();
+    for (const auto& keyword : keywords) {
+        if (spotter->enroll(keyword.name, keyword.recordings, keyword.sensitivity) == kNoKeyword) {
+            LOG_ERROR("Failed to enroll keyword: " + keyword.name);
+            return false;
+        }
+    }
+    return setEngine(std::move(spotter), keywords);
+}
+
+WakeWordDetector::Settings WakeWordDetector::readSettings(ConfigManager& config) {
+    Settings settings;
+    settings.modelPath = config.getString("wake_word.model_path", "models/porcupine_params.pv");
+
+    std::string engine = config.getString("wake_word.engine", "auto");
+    if (engine == "porcupine") {
+        settings.engine = Engine::Porcupine;
+    } else if (engine == "builtin") {
+        settings.engine = Engine::Builtin;
+    } else if (engine != "auto") {
+        LOG_WARNING("Unknown wake word engine '" + engine + "'; choosing automatically");
+    }
+
+    float sensitivity = config.getFloat("wake_word.sensitivity", 0.5f);
+    try {
+        for (const auto& entry : config.getConfig().at("wake_word").at("keywords")) {
+            Keyword keyword;
+            keyword.path = entry.value("path", std::string());
+            keyword.recordings = entry.value("recordings", std::vector<std::string>());
+            keyword.name = entry.value("name", keyword.path);
+            keyword.sensitivity = entry.value("sensitivity", sensitivity);
+            settings.keywords.push_back(keyword);
+        }
+    } catch (const std::exception&) {
+        // Not set: the single wake word below
     }
 
-    pv_status_t status = pv_porcupine_init(
-        access_key,
-        modelPath.c_str(),
-        1,
-        &keywordPath.c_str(),
-        &sensitivity,
-        &porcupine
-    );
+    if (settings.keywords.empty()) {
+        Keyword keyword;
+        keyword.name = "wake word";
+        keyword.path = config.getString("wake_word.keyword_path", "models/hey-jarvis.ppn");
+        keyword.sensitivity = sensitivity;
+        try {
+            keyword.recordings = config.getConfig().at("wake_word").at("recordings").get<std::vector<std::string>>();
+        } catch (const std::exception&) {
+            // Not set: Porcupine only
+        }
+        settings.keywords.push_back(keyword);
+    }
+    return settings;
+}
 
-    if (status != PV_STATUS_SUCCESS) {
-        LOG_ERROR("Failed to initialize Porcupine: " << pv_status_to_string(status));
+bool WakeWordDetector::initialize(const Settings& settings) {
+    return initialize(settings.modelPath, settings.keywords, settings.engine);
+}
+
+bool WakeWordDetector::setEngine(std::unique_ptr<WakeWordEngine> engine, const std::vector<Keyword>& keywords) {
+    if (running_) {
+        LOG_ERROR("Cannot change keywords while detection is running");
+        return false;
+    }
+    if (!engine) {
+        return false;
+    }
+    if (engine->keywordCount() != keywords.size()) {
+        LOG_ERROR("Wake word engine keyword count does not match");
         return false;
     }
 
-    porcupine_.reset(porcupine);
-    LOG_INFO("Wake word detector initialized successfully with Porcupine");
-    
+    engine_ = std::move(engine);
+    keywords_ = keywords;
+    frameAssembler_ = std::make_unique<FrameAssembler>(static_cast<size_t>(engine_->frameLength()));
+    frameAssembler_->setFrameHandler([this](const int16_t* frame) { processAudioFrame(frame); });
+    LOG_INFO(std::string("Wake word detector initialized successfully with ") + engine_->name() + " (" +
+             std::to_string(keywords_.size()) + " keywords)");
     return true;
-#else
-    LOG_WARNING("Porcupine not available - using placeholder implementation");
-    return true;
-#endif
+}
+
+const char* WakeWordDetector::getEngineName() const {
+    return engine_ ? engine_->name() : "none";
 }
 
 void WakeWordDetector::startDetection(WakeWordCallback callback) {
@@ -145,99 +152,57 @@ void WakeWordDetector::startDetection(WakeWordCallback callback) {
     }
 
     callback_ = callback;
-    
-    if (!audioCapture_->initialize(getSampleRate(), 1)) {
-        LOG_ERROR("Failed to initialize audio capture");
-        return;
-    }
-
+    restart_ = true;
     running_ = true;
-    shouldStop_ = false;
-    
-    detectionThread_ = std::thread(&WakeWordDetector::detectionLoop, this);
     LOG_INFO("Wake word detection started");
 }
 
 void WakeWordDetector::stopDetection() {
     if (!running_) return;
 
-    shouldStop_ = true;
     running_ = false;
-    
-    if (detectionThread_.joinable()) {
-        detectionThread_.join();
-    }
-    
-    audioCapture_->stopCapture();
     LOG_INFO("Wake word detection stopped");
 }
 
-void WakeWordDetector::detectionLoop() {
-    // Start audio capture with callback
-    audioCapture_->startCapture([this](const std::vector<int16_t>& audioData) {
-        // Accumulate audio data until we have a full frame
-        static std::vector<int16_t> accumulatedAudio;
-        accumulatedAudio.insert(accumulatedAudio.end(), audioData.begin(), audioData.end());
-        
-        int frameLength = getFrameLength();
-        
-        // Process complete frames
-        while (accumulatedAudio.size() >= static_cast<size_t>(frameLength)) {
-            std::vector<int16_t> frame(accumulatedAudio.begin(), accumulatedAudio.begin() + frameLength);
-            accumulatedAudio.erase(accumulatedAudio.begin(), accumulatedAudio.begin() + frameLength);
-            
-            if (processAudioFrame(frame)) {
-                if (callback_) {
-                    callback_();
-                }
-            }
-        }
-    });
-    
-    // Wait until stop is requested
-    while (!shouldStop_) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+void WakeWordDetector::reset() {
+    restart_ = true;
+}
+
+int WakeWordDetector::processAudio(std::span<const int16_t> samples) {
+    if (!running_ || !engine_) {
+        return kNoKeyword;
     }
+    if (restart_.exchange(false)) {
+        frameAssembler_->reset();
+        engine_->reset();
+    }
+
+    // Complete frames go to the engine in place; only those spanning two blocks are copied
+    detected_ = kNoKeyword;
+    frameAssembler_->push(samples);
+    return detected_;
 }
 
-bool WakeWordDetector::processAudioFrame(const std::vector<int16_t>& frame) {
-#ifdef PORCUPINE_FOUND
-    if (!porcupine_) return false;
-    
-    int32_t keyword_index = -1;
-    pv_status_t status = pv_porcupine_process(
-        porcupine_.get(),
-        frame.data(),
-        &keyword_index
-    );
-    
-    if (status != PV_STATUS_SUCCESS) {
-        LOG_ERROR("Porcupine processing failed: " << pv_status_to_string(status));
-        return false;
+void WakeWordDetector::processAudioFrame(const int16_t* frame) {
+    int keyword = engine_->process(frame);
+    if (keyword == kNoKeyword) {
+        return;
+    }
+    detected_ = keyword;
+    if (keywords_[keyword].callback) {
+        keywords_[keyword].callback(keyword);
+    }
+    if (callback_) {
+        callback_(keyword);
     }
-    
-    return keyword_index == 0;
-#else
-    // Placeholder implementation - randomly trigger for testing
-    static int counter = 0;
-    return (++counter % 100) == 0;
-#endif
 }
 
 int WakeWordDetector::getSampleRate() const {
-#ifdef PORCUPINE_FOUND
-    return pv_sample_rate();
-#else
-    return 16000; // Default fallback
-#endif
+    return engine_ ? engine_->sampleRate() : kDefaultSampleRate;
 }
 
 int WakeWordDetector::getFrameLength() const {
-#ifdef PORCUPINE_FOUND
-    return pv_porcupine_frame_length();
-#else
-    return 512; // Default fallback
-#endif
+    return engine_ ? engine_->frameLength() : kDefaultFrameLength;
 }
 
-} // namespace jarvis
\ No newline at end of file
+} // namespace jarvis
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+#include "audio/audio_resampler.h"
+
+// Previous linear-interpolation implementation, kept here as the baseline
+class LegacyResampler {
+public:
+    LegacyResampler(int inputRate, int outputRate)
+        : inputRate_(inputRate), outputRate_(outputRate),
+          ratio_(static_cast<double>(outputRate) / inputRate) {}
+
+    std::vector<int16_t> resample(const int16_t* input, size_t inputFrames) {
+        if (inputRate_ == outputRate_) {
+            return std::vector<int16_t>(input, input + inputFrames);
+        }
+
+        size_t outputFrames = static_cast<size_t>(inputFrames * ratio_);
+        std::vector<int16_t> output(outputFrames);
+
+        for (size_t i = 0; i < outputFrames; ++i) {
+            double inputIndex = static_cast<double>(i) / ratio_;
+            size_t index = static_cast<size_t>(inputIndex);
+            double fraction = inputIndex - index;
+
+            if (index + 1 < inputFrames) {
+                output[i] = static_cast<int16_t>(
+                    input[index] * (1.0 - fraction) + input[index + 1] * fraction
+                );
+            } else {
+                output[i] = input[index];
+            }
+        }
+
+        return output;
+    }
+
+private:
+    int inputRate_;
+    int outputRate_;
+    double ratio_;
+};
+
+class AudioResamplerBenchmark {
+public:
+    // Two minutes of mono audio in the wake word thread's 512-frame reads
+    static constexpr size_t kBlockFrames = 512;
+    static constexpr int kSeconds = 120;
+    static constexpr int kRuns = 5;
+
+    template <typename Resampler>
+    static double run(Resampler& resampler, int inputRate) {
+        std::vector<int16_t> block(kBlockFrames);
+        for (size_t i = 0; i < block.size(); ++i) {
+            block[i] = static_cast<int16_t>(8000.0 * std::sin(0.05 * i));
+        }
+
+        std::vector<int16_t> output(kBlockFrames * 2);
+
+        // Best of several runs, to keep other load on the machine out of the comparison
+        size_t blocks = static_cast<size_t>(inputRate) * kSeconds / kBlockFrames;
+        int64_t checksum = 0;
+        double best = 1e9;
+        for (int run = 0; run < kRuns; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < blocks; ++i) {
+                if constexpr (std::is_same_v<Resampler, jarvis::AudioResampler>) {
+                    // The pipeline's allocation-free path
+                    size_t frames = resampler.resample(block, output);
+                    checksum += frames == 0 ? 0 : output[frames - 1];
+                } else {
+                    auto result = resampler.resample(block.data(), block.size());
+                    checksum += result.empty() ? 0 : result.back();
+                }
+            }
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double>(end - start).count());
+        }
+
+        if (checksum == 0x7fffffff) {
+            std::cout << "  (checksum " << checksum << ")" << std::endl;
+        }
+        return best;
+    }
+
+    static void benchmarkRate(int inputRate) {
+        using Quality = jarvis::AudioResampler::Quality;
+
+        LegacyResampler legacy(inputRate, 16000);
+        double legacySec = run(legacy, inputRate);
+        std::cout << std::fixed << std::setprecision(0) << "  " << inputRate << " Hz: legacy "
+                  << kSeconds / legacySec << "x real time";
+
+        for (Quality quality : {Quality::Fast, Quality::Balanced, Quality::High}) {
+            jarvis::AudioResampler resampler(inputRate, 16000, 1, quality);
+            double sec = run(resampler, inputRate);
+            const char* name = quality == Quality::Fast ? "fast" : quality == Quality::High ? "high" : "balanced";
+            std::cout << std::setprecision(0) << ", " << name << " (" << jarvis::AudioResampler::filterLength(
+                         inputRate, 16000, quality) << " taps) " << kSeconds / sec << "x ("
+                      << std::setprecision(2) << legacySec / sec << "x legacy)";
+        }
+        std::cout << std::endl;
+    }
+};
+
+int main() {
+    std::cout << "=== Audio Resampler Benchmark ===" << std::endl;
+
+    for (int inputRate : {48000, 44100, 32000, 22050}) {
+        AudioResamplerBenchmark::benchmarkRate(inputRate);
+    }
+
+    std::cout << "=== Benchmark Complete ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,173 @@
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include "audio/audio_ring_buffer.h"
+
+// Previous per-sample implementation, kept here as the baseline
+class LegacyRingBuffer {
+public:
+    LegacyRingBuffer(size_t capacity)
+        : capacity_(capacity + 1), buffer_(capacity + 1) {}
+
+    bool write(const int16_t* data, size_t count) {
+        if (count > freeSpace()) {
+            return false;
+        }
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            buffer_[tail] = data[i];
+            tail = (tail + 1) % capacity_;
+        }
+        tail_.store(tail, std::memory_order_release);
+        return true;
+    }
+
+    size_t read(int16_t* buffer, size_t count) {
+        size_t toRead = std::min(count, available());
+        size_t head = head_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < toRead; ++i) {
+            buffer[i] = buffer_[head];
+            head = (head + 1) % capacity_;
+        }
+        head_.store(head, std::memory_order_release);
+        return toRead;
+    }
+
+    size_t available() const {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return (tail + capacity_ - head) % capacity_;
+    }
+
+    size_t freeSpace() const { return capacity_ - available() - 1; }
+
+private:
+    const size_t capacity_;
+    std::vector<int16_t> buffer_;
+    std::atomic<size_t> head_{0};
+    std::atomic<size_t> tail_{0};
+};
+
+class AudioRingBufferBenchmark {
+public:
+    // 10 ms blocks of 4-channel 48 kHz audio, 10 minutes worth of samples
+    static constexpr size_t kBlockSize = 480 * 4;
+    static constexpr size_t kCapacity = 48000 * 4;
+    static constexpr size_t kTotalSamples = 48000ull * 4 * 600;
+
+    template <typename Buffer>
+    static double runSingleThread(Buffer& buffer) {
+        std::vector<int16_t> in(kBlockSize), out(kBlockSize);
+        for (size_t i = 0; i < in.size(); ++i) {
+            in[i] = static_cast<int16_t>(i);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t done = 0; done < kTotalSamples; done += kBlockSize) {
+            buffer.write(in.data(), in.size());
+            buffer.read(out.data(), out.size());
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        if (out[kBlockSize - 1] != in[kBlockSize - 1]) {
+            std::cout << "✗ Data mismatch" << std::endl;
+        }
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    template <typename Buffer>
+    static double runTwoThreads(Buffer& buffer) {
+        std::vector<int16_t> in(kBlockSize, 1);
+
+        auto start = std::chrono::steady_clock::now();
+        std::thread consumer([&buffer]() {
+            std::vector<int16_t> out(kBlockSize);
+            size_t received = 0;
+            while (received < kTotalSamples) {
+                received += buffer.read(out.data(), out.size());
+            }
+        });
+        for (size_t sent = 0; sent < kTotalSamples;) {
+            if (buffer.write(in.data(), in.size())) {
+                sent += in.size();
+            }
+        }
+        consumer.join();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    static double runSpanApi(jarvis::AudioRingBuffer& buffer) {
+        int64_t checksum = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t done = 0; done < kTotalSamples; done += kBlockSize) {
+            // Producer fills in place
+            for (size_t written = 0; written < kBlockSize;) {
+                auto region = buffer.acquireWrite(kBlockSize - written);
+                std::fill(region.begin(), region.end(), static_cast<int16_t>(1));
+                buffer.commitWrite(region.size());
+                written += region.size();
+            }
+            // Consumer processes in place
+            for (size_t consumed = 0; consumed < kBlockSize;) {
+                auto region = buffer.acquireRead(kBlockSize - consumed);
+                for (int16_t sample : region) {
+                    checksum += sample;
+                }
+                buffer.commitRead(region.size());
+                consumed += region.size();
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        if (checksum != static_cast<int64_t>(kTotalSamples)) {
+            std::cout << "✗ Span API checksum mismatch" << std::endl;
+        }
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    static void report(const char* name, double legacySec, double newSec) {
+        double samples = static_cast<double>(kTotalSamples);
+        std::cout << std::fixed << std::setprecision(1)
+                  << "  " << name << ": legacy " << samples / legacySec / 1e6 << " MS/s, "
+                  << "new " << samples / newSec / 1e6 << " MS/s, "
+                  << "speedup " << std::setprecision(2) << legacySec / newSec << "x" << std::endl;
+    }
+
+    static void benchmarkSingleThread() {
+        std::cout << "Benchmarking write/read on one thread..." << std::endl;
+        LegacyRingBuffer legacy(kCapacity);
+        jarvis::AudioRingBuffer ring(kCapacity);
+        report("single thread", runSingleThread(legacy), runSingleThread(ring));
+    }
+
+    static void benchmarkTwoThreads() {
+        std::cout << "Benchmarking producer/consumer threads..." << std::endl;
+        LegacyRingBuffer legacy(kCapacity);
+        jarvis::AudioRingBuffer ring(kCapacity);
+        report("two threads", runTwoThreads(legacy), runTwoThreads(ring));
+    }
+
+    static void benchmarkSpanApi() {
+        std::cout << "Benchmarking acquire/commit span API..." << std::endl;
+        LegacyRingBuffer legacy(kCapacity);
+        jarvis::AudioRingBuffer ring(kCapacity);
+        report("span api", runSingleThread(legacy), runSpanApi(ring));
+    }
+};
+
+int main() {
+    std::cout << "=== Audio Ring Buffer Benchmark ===" << std::endl;
+
+    AudioRingBufferBenchmark::benchmarkSingleThread();
+    AudioRingBufferBenchmark::benchmarkTwoThreads();
+    AudioRingBufferBenchmark::benchmarkSpanApi();
+
+    std::cout << "=== Benchmark Complete ===" << std::endl;
+    return 0;
+}
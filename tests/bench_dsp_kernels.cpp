@@ -0,0 +1,141 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include "dsp/kernels.h"
+
+using jarvis::dsp::Isa;
+using jarvis::dsp::Kernels;
+
+class DspKernelsBenchmark {
+public:
+    // One 10 ms block at 48 kHz, the size the capture thread hands over
+    static constexpr size_t kBlock = 480;
+    static constexpr size_t kFirTaps = 32;
+    static constexpr int kRepeats = 20000;
+    static constexpr int kRuns = 5;
+
+    struct Buffers {
+        std::vector<int16_t> a = samples(0.3);
+        std::vector<int16_t> b = samples(0.7);
+        std::vector<int16_t> s = std::vector<int16_t>(kBlock);
+        std::vector<float> x = floats(0.2, kBlock + kFirTaps);
+        std::vector<float> y = floats(0.9, kBlock);
+        std::vector<float> out = std::vector<float>(kBlock);
+        std::vector<float> taps = floats(1.3, kFirTaps);
+        std::vector<int8_t> qx = bytes(0.4, kBlock);
+        std::vector<int8_t> qw = bytes(1.1, kBlock);
+        std::vector<int32_t> qout = std::vector<int32_t>(kBlock);
+    };
+
+    static std::vector<int16_t> samples(double phase) {
+        std::vector<int16_t> v(kBlock);
+        for (size_t i = 0; i < v.size(); ++i) {
+            v[i] = static_cast<int16_t>(20000.0 * std::sin(0.01 * i + phase));
+        }
+        return v;
+    }
+
+    static std::vector<int8_t> bytes(double phase, size_t n) {
+        std::vector<int8_t> v(n);
+        for (size_t i = 0; i < v.size(); ++i) {
+            v[i] = static_cast<int8_t>(120.0 * std::sin(0.37 * i + phase));
+        }
+        return v;
+    }
+
+    static std::vector<float> floats(double phase, size_t n) {
+        std::vector<float> v(n);
+        for (size_t i = 0; i < v.size(); ++i) {
+            v[i] = static_cast<float>(0.5 * std::sin(0.013 * i + phase));
+        }
+        return v;
+    }
+
+    // Best of several runs, in samples per second
+    static double run(const std::function<void(const Kernels&, Buffers&)>& kernel, const Kernels& k) {
+        Buffers buffers;
+        double best = 1e9;
+        for (int run = 0; run < kRuns; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < kRepeats; ++i) {
+                kernel(k, buffers);
+            }
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double>(end - start).count());
+        }
+        return static_cast<double>(kBlock) * kRepeats / best;
+    }
+
+    static void benchmark(const char* name, const std::function<void(const Kernels&, Buffers&)>& kernel) {
+        double scalar = run(kernel, *jarvis::dsp::kernelsFor(Isa::Scalar));
+        std::cout << std::fixed << std::setprecision(0) << "  " << std::left << std::setw(16) << name
+                  << std::right << "scalar " << std::setw(6) << scalar / 1e6 << " M/s";
+        for (Isa isa : {Isa::SSE2, Isa::AVX2, Isa::AVX512, Isa::AVX512VNNI}) {
+            const Kernels* k = jarvis::dsp::kernelsFor(isa);
+            if (!k) {
+                continue;
+            }
+            double rate = run(kernel, *k);
+            std::cout << ", " << jarvis::dsp::isaName(isa) << " " << std::setw(6) << rate / 1e6 << " M/s ("
+                      << std::setprecision(1) << rate / scalar << "x)" << std::setprecision(0);
+        }
+        std::cout << std::endl;
+    }
+};
+
+// Keeps reductions from being optimized away
+static volatile double sink;
+
+int main() {
+    std::cout << "=== DSP Kernels Benchmark ===" << std::endl;
+    std::cout << "  " << DspKernelsBenchmark::kBlock << "-sample blocks, millions of samples per second" << std::endl;
+
+    using Buffers = DspKernelsBenchmark::Buffers;
+    DspKernelsBenchmark::benchmark("int16ToFloat", [](const Kernels& k, Buffers& b) {
+        k.int16ToFloat(b.a.data(), b.out.data(), b.a.size());
+    });
+    DspKernelsBenchmark::benchmark("floatToInt16", [](const Kernels& k, Buffers& b) {
+        k.floatToInt16(b.y.data(), b.s.data(), b.y.size());
+    });
+    DspKernelsBenchmark::benchmark("gain", [](const Kernels& k, Buffers& b) {
+        k.gain(b.a.data(), b.s.data(), b.a.size(), 1.7f);
+    });
+    DspKernelsBenchmark::benchmark("gainClip", [](const Kernels& k, Buffers& b) {
+        k.gainClip(b.y.data(), b.out.data(), b.y.size(), 1.7f, 1.0f);
+    });
+    DspKernelsBenchmark::benchmark("mix", [](const Kernels& k, Buffers& b) {
+        k.mix(b.a.data(), b.b.data(), b.s.data(), b.a.size());
+    });
+    DspKernelsBenchmark::benchmark("mixAccumulate", [](const Kernels& k, Buffers& b) {
+        k.mixAccumulate(b.out.data(), b.y.data(), b.y.size(), 1e-3f);
+    });
+    DspKernelsBenchmark::benchmark("sumSquares", [](const Kernels& k, Buffers& b) {
+        sink = static_cast<double>(k.sumSquares(b.a.data(), b.a.size()));
+    });
+    DspKernelsBenchmark::benchmark("sumSquaresFloat", [](const Kernels& k, Buffers& b) {
+        sink = k.sumSquaresFloat(b.y.data(), b.y.size());
+    });
+    DspKernelsBenchmark::benchmark("peak", [](const Kernels& k, Buffers& b) {
+        sink = k.peak(b.a.data(), b.a.size());
+    });
+    DspKernelsBenchmark::benchmark("dot", [](const Kernels& k, Buffers& b) {
+        sink = k.dot(b.x.data(), b.y.data(), b.y.size());
+    });
+    DspKernelsBenchmark::benchmark("fir (32 taps)", [](const Kernels& k, Buffers& b) {
+        k.fir(b.x.data(), b.out.data(), b.out.size(), b.taps.data(), b.taps.size());
+    });
+    DspKernelsBenchmark::benchmark("distances (16d)", [](const Kernels& k, Buffers& b) {
+        k.squaredDistances(b.x.data(), b.y.data(), b.y.size() / 16, 16, b.out.data());
+    });
+    // A block's worth of multiply-accumulates: 4 rows of 120 int8 weights
+    DspKernelsBenchmark::benchmark("gemvInt8 4x120", [](const Kernels& k, Buffers& b) {
+        k.gemvInt8(b.qw.data(), b.qx.data(), 4, b.qw.size() / 4, b.qout.data());
+    });
+
+    std::cout << "=== Benchmark Complete ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <string>
+#include <cstdio>
+#include <algorithm>
+#include "nn/model.h"
+#include "nn/session.h"
+#include "dsp/kernels.h"
+
+using jarvis::nn::Model;
+using jarvis::nn::ModelWriter;
+using jarvis::nn::Session;
+using jarvis::dsp::Isa;
+
+class NnRuntimeBenchmark {
+public:
+    // Ten minutes of 10 ms hops
+    static constexpr int kSteps = 60000;
+    static constexpr int kRuns = 3;
+    static constexpr size_t kMels = 40;
+
+    static std::vector<float> randomFloats(size_t n, float range, std::mt19937& rng) {
+        std::uniform_real_distribution<float> value(-range, range);
+        std::vector<float> v(n);
+        for (auto& x : v) {
+            x = value(rng);
+        }
+        return v;
+    }
+
+    // Log-mel frame in, per-hop scores out: conv1d front, GRU layers, dense head
+    static bool writeModel(const std::string& path, size_t channels, size_t hidden, int grus, size_t outputs) {
+        std::mt19937 rng(1);
+        ModelWriter writer(kMels);
+        writer.addConv1d(channels, 5, randomFloats(channels * 5 * kMels, 0.1f, rng), randomFloats(channels, 0.1f, rng),
+                         Model::Activation::Relu);
+        for (int g = 0; g < grus; ++g) {
+            size_t in = writer.outputSize();
+            writer.addGru(hidden, randomFloats(3 * hidden * in, 0.2f, rng), randomFloats(3 * hidden * hidden, 0.2f, rng),
+                          randomFloats(3 * hidden, 0.1f, rng), randomFloats(3 * hidden, 0.1f, rng));
+        }
+        writer.addDense(outputs, randomFloats(outputs * hidden, 0.3f, rng), randomFloats(outputs, 0.1f, rng),
+                        Model::Activation::Sigmoid);
+        return writer.save(path);
+    }
+
+    // Best of several runs, in microseconds per step
+    static double run(Session& session, const std::vector<float>& frames) {
+        double best = 1e9;
+        for (int run = 0; run < kRuns; ++run) {
+            session.reset();
+            auto start = std::chrono::steady_clock::now();
+            for (int t = 0; t < kSteps; ++t) {
+                session.process(frames.data() + (t % 100) * kMels);
+            }
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double>(end - start).count());
+        }
+        return best * 1e6 / kSteps;
+    }
+
+    static void benchmark(const char* name, size_t channels, size_t hidden, int grus, size_t outputs) {
+        const std::string path = std::string("bench_nn_runtime_") + name + ".jnn";
+        Model model;
+        if (!writeModel(path, channels, hidden, grus, outputs) || !model.load(path)) {
+            std::cout << "  " << name << ": failed to build the model" << std::endl;
+            return;
+        }
+        std::remove(path.c_str());
+
+        size_t macs = 0;
+        for (const auto& layer : model.layers()) {
+            macs += layer.macs();
+        }
+        std::cout << "  " << name << ": " << macs / 1000 << "k MACs per hop, " << model.size() / 1024
+                  << " KiB mapped" << std::endl;
+
+        std::mt19937 rng(2);
+        auto frames = randomFloats(100 * kMels, 3.0f, rng);
+        Session session(model);
+        for (Isa isa : {Isa::Scalar, Isa::SSE2, Isa::AVX2, Isa::AVX512, Isa::AVX512VNNI}) {
+            if (!jarvis::dsp::setIsa(isa)) {
+                continue;
+            }
+            double us = run(session, frames);
+            // Share of one core spent keeping up with real time (10 ms per hop)
+            std::cout << std::fixed << std::setprecision(1) << "    " << std::left << std::setw(11)
+                      << jarvis::dsp::isaName(isa) << std::right << std::setw(7) << us << " us per hop, "
+                      << std::setprecision(2) << us / 100.0 << "% of a core" << std::endl;
+        }
+
+        // Where the time goes, on the best instruction set
+        jarvis::dsp::setIsa(jarvis::dsp::bestIsa());
+        session.setTiming(true);
+        run(session, frames);
+        const auto& layers = model.layers();
+        for (size_t i = 0; i < layers.size(); ++i) {
+            const auto& timing = session.timings()[i];
+            std::cout << std::fixed << std::setprecision(2) << "      " << i << " " << std::left << std::setw(7)
+                      << Model::layerTypeName(layers[i].type) << std::right << std::setw(4) << layers[i].inputSize
+                      << " -> " << std::setw(4) << layers[i].outputSize << std::setw(8) << timing.meanUs() << " us"
+                      << std::endl;
+        }
+    }
+};
+
+int main() {
+    std::cout << "=== NN Runtime Benchmark ===" << std::endl;
+    std::cout << "  One step per 10 ms hop of " << NnRuntimeBenchmark::kMels << " log-mels" << std::endl;
+
+    // Sizes of a streaming VAD and a small keyword model
+    NnRuntimeBenchmark::benchmark("vad", 32, 32, 1, 1);
+    NnRuntimeBenchmark::benchmark("keywords", 128, 128, 2, 4);
+
+    std::cout << "=== Benchmark Complete ===" << std::endl;
+    return 0;
+}
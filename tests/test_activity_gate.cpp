@@ -0,0 +1,146 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <numbers>
+#include <algorithm>
+#include "audio/activity_gate.h"
+
+using jarvis::ActivityGate;
+
+class SimpleActivityGateTest {
+public:
+    static constexpr int kRate = 16000;
+    static constexpr size_t kFrame = 512;
+
+    static std::vector<int16_t> noise(double seconds, double rms, std::mt19937& rng) {
+        std::normal_distribution<double> white(0.0, rms * 32768.0);
+        std::vector<int16_t> x(static_cast<size_t>(seconds * kRate));
+        for (auto& v : x) {
+            v = static_cast<int16_t>(std::clamp(std::lround(white(rng)), -32768L, 32767L));
+        }
+        return x;
+    }
+
+    // A keyword whose first syllable is soft: 300 ms rising from the noise, then 500 ms loud
+    static void addKeyword(std::vector<int16_t>& x, size_t at) {
+        for (size_t i = 0; i < static_cast<size_t>(0.8 * kRate) && at + i < x.size(); ++i) {
+            double t = static_cast<double>(i) / kRate;
+            double level = t < 0.3 ? 0.003 + 0.01 * t / 0.3 : 0.2;
+            double s = level * std::sin(2.0 * std::numbers::pi * 150.0 * t) * 32768.0;
+            x[at + i] = static_cast<int16_t>(std::clamp(std::lround(x[at + i] + s), -32768L, 32767L));
+        }
+    }
+
+    // Run the gate the way the pipeline does: on opening, rewind by the
+    // lookback in whole frames, or to the end of the audio already seen, and
+    // replay without re-gating. Returns, per sample, whether the engine saw it.
+    static std::vector<bool> run(ActivityGate& gate, const std::vector<int16_t>& x) {
+        std::vector<bool> seen(x.size(), false);
+        const size_t lookback = (gate.lookbackSamples() + kFrame - 1) / kFrame * kFrame;
+        size_t position = 0;
+        size_t replayEnd = 0;
+        size_t fedEnd = 0;
+        while (position + kFrame <= x.size()) {
+            size_t frameStart = position;
+            position += kFrame;
+            if (position > replayEnd) {
+                if (!gate.process(x.data() + frameStart, kFrame)) {
+                    continue;
+                }
+                if (gate.justOpened()) {
+                    position = std::max(frameStart - std::min(lookback, frameStart), std::min(fedEnd, frameStart));
+                    gate.countReplayed((frameStart - position) / kFrame);
+                    replayEnd = frameStart + kFrame;
+                    continue;
+                }
+            }
+            std::fill(seen.begin() + frameStart, seen.begin() + position, true);
+            fedEnd = position;
+        }
+        return seen;
+    }
+
+    static bool testIdleRoom() {
+        std::cout << "Testing a quiet room and steady noise..." << std::endl;
+
+        std::mt19937 rng(1);
+        ActivityGate quiet(kRate);
+        run(quiet, noise(60.0, 0.001, rng));
+        double quietDuty = quiet.getStats().dutyCycle();
+
+        // A fan switched on is absorbed into the background within a few seconds
+        auto fan = noise(2.0, 0.001, rng);
+        auto loud = noise(30.0, 0.05, rng);
+        fan.insert(fan.end(), loud.begin(), loud.end());
+        ActivityGate steady(kRate);
+        run(steady, fan);
+        auto stats = steady.getStats();
+
+        std::cout << "  quiet room duty cycle " << quietDuty * 100.0 << "%, fan " << stats.dutyCycle() * 100.0
+                  << "% with " << stats.openings << " opening(s)" << std::endl;
+        bool ok = quietDuty == 0.0 && stats.dutyCycle() < 0.25 && !steady.isOpen();
+        std::cout << (ok ? "✓ " : "✗ ") << "The engine idles without activity" << std::endl;
+        return ok;
+    }
+
+    static bool testLookback() {
+        std::cout << "Testing the lookback replay..." << std::endl;
+
+        std::mt19937 rng(2);
+        auto x = noise(6.0, 0.002, rng);
+        const size_t keyword = 3 * kRate + 123;
+        addKeyword(x, keyword);
+
+        ActivityGate gate(kRate);
+        auto seen = run(gate, x);
+        bool whole = std::all_of(seen.begin() + keyword, seen.begin() + keyword + static_cast<size_t>(0.8 * kRate),
+                                 [](bool s) { return s; });
+        bool before = !seen[keyword - kRate];
+        auto stats = gate.getStats();
+
+        // The replayed frames are the engine's work too
+        bool counted = stats.openFrames == static_cast<uint64_t>(std::count(seen.begin(), seen.end(), true)) / kFrame;
+        std::cout << "  " << stats.openings << " opening(s), duty cycle " << stats.dutyCycle() * 100.0 << "%"
+                  << std::endl;
+
+        bool ok = whole && before && counted && stats.openings == 1 && stats.dutyCycle() < 0.5;
+        std::cout << (ok ? "✓ " : "✗ ") << "The soft onset reaches the engine" << std::endl;
+        return ok;
+    }
+
+    static bool testHold() {
+        std::cout << "Testing the hold time..." << std::endl;
+
+        ActivityGate::Params params;
+        params.holdMs = 1000;
+        params.lookbackMs = 0;
+        ActivityGate gate(kRate, params);
+        std::vector<int16_t> silence(kFrame, 0), loud(kFrame, 8000);
+        for (int i = 0; i < 20; ++i) {
+            gate.process(silence.data(), kFrame);
+        }
+        bool ok = gate.process(loud.data(), kFrame) && gate.justOpened();
+
+        // 1000 ms is 31.25 frames of 512: open for 31 quiet frames, closed on the 32nd
+        int openFor = 0;
+        while (gate.process(silence.data(), kFrame)) {
+            ok &= !gate.justOpened();
+            ++openFor;
+        }
+        ok &= openFor == 31;
+        std::cout << (ok ? "✓ " : "✗ ") << "Held open " << openFor << " frames after the last loud one" << std::endl;
+        return ok;
+    }
+};
+
+int main() {
+    std::cout << "=== Activity Gate Test ===" << std::endl;
+
+    bool ok = SimpleActivityGateTest::testIdleRoom();
+    ok &= SimpleActivityGateTest::testLookback();
+    ok &= SimpleActivityGateTest::testHold();
+
+    std::cout << "=== Test Complete ===" << std::endl;
+    return ok ? 0 : 1;
+}
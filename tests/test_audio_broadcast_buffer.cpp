@@ -0,0 +1,187 @@
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "audio/audio_broadcast_buffer.h"
+
+class SimpleAudioBroadcastBufferTest {
+public:
+    static void testFanOut() {
+        std::cout << "Testing fan-out to independent readers..." << std::endl;
+
+        jarvis::AudioBroadcastBuffer bus(1024);
+        auto wake = bus.addReader("wake_word");
+        auto stt = bus.addReader("stt");
+
+        std::vector<int16_t> block(256);
+        for (size_t i = 0; i < block.size(); ++i) {
+            block[i] = static_cast<int16_t>(i);
+        }
+        bus.write(block.data(), block.size());
+
+        std::vector<int16_t> a(256), b(256);
+        size_t readA = bus.read(wake, a.data(), a.size());
+        size_t readB = bus.read(stt, b.data(), b.size());
+
+        if (readA == block.size() && readB == block.size() && a == block && b == block) {
+            std::cout << "✓ Both readers received every sample" << std::endl;
+        } else {
+            std::cout << "✗ Readers did not see the same audio" << std::endl;
+        }
+    }
+
+    static void testOverrun() {
+        std::cout << "Testing overrun accounting..." << std::endl;
+
+        jarvis::AudioBroadcastBuffer bus(1024);
+        auto slow = bus.addReader("slow");
+        auto fast = bus.addReader("fast");
+
+        std::vector<int16_t> block(512, 1);
+        std::vector<int16_t> out(512);
+        for (int i = 0; i < 4; ++i) {
+            bus.write(block.data(), block.size());
+            bus.read(fast, out.data(), out.size());
+        }
+
+        auto lagging = bus.getReaderStats(slow);
+        std::cout << "  Slow reader lag: " << lagging.lagSamples << " samples" << std::endl;
+
+        size_t got = bus.read(slow, out.data(), out.size());
+        auto slowStats = bus.getReaderStats(slow);
+        auto fastStats = bus.getReaderStats(fast);
+
+        if (got == out.size() && slowStats.overruns == 1 && slowStats.droppedSamples == 1024 &&
+            fastStats.overruns == 0 && fastStats.lagSamples == 0) {
+            std::cout << "✓ Overrun reported for the slow reader only" << std::endl;
+        } else {
+            std::cout << "✗ Unexpected overrun stats (overruns=" << slowStats.overruns
+                      << ", dropped=" << slowStats.droppedSamples << ")" << std::endl;
+        }
+    }
+
+    static void testPeekConsume() {
+        std::cout << "Testing zero-copy peek/consume..." << std::endl;
+
+        jarvis::AudioBroadcastBuffer bus(1024);
+        auto reader = bus.addReader("reader");
+
+        std::vector<int16_t> block(900, 7);
+        bus.write(block.data(), block.size());
+        bus.read(reader, block.data(), block.size());
+        bus.write(block.data(), block.size());
+
+        // The second block wraps, so it arrives in two contiguous regions
+        size_t total = 0;
+        int regions = 0;
+        while (bus.available(reader) > 0) {
+            auto region = bus.peek(reader, 900);
+            total += region.size();
+            ++regions;
+            if (!bus.consume(reader, region.size())) {
+                break;
+            }
+        }
+
+        if (total == 900 && regions == 2) {
+            std::cout << "✓ Wrapped block delivered in place" << std::endl;
+        } else {
+            std::cout << "✗ Unexpected peek result (" << total << " samples, "
+                      << regions << " regions)" << std::endl;
+        }
+    }
+
+    static void testBlockingWait() {
+        std::cout << "Testing blocking wait for a full frame..." << std::endl;
+
+        jarvis::AudioBroadcastBuffer bus(4096);
+        auto reader = bus.addReader("reader");
+
+        // Produce 10 ms blocks; the reader asks for a 512-sample frame
+        std::thread producer([&bus]() {
+            std::vector<int16_t> block(160, 1);
+            for (int i = 0; i < 8; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                bus.write(block.data(), block.size());
+            }
+        });
+
+        bool ready = bus.waitForAvailable(reader, 512, std::chrono::milliseconds(1000));
+        size_t available = bus.available(reader);
+        producer.join();
+
+        if (ready && available >= 512) {
+            std::cout << "✓ Reader woken with " << available << " samples available" << std::endl;
+        } else {
+            std::cout << "✗ Wait returned without a full frame" << std::endl;
+        }
+
+        // interrupt() releases a waiter that would otherwise time out
+        std::thread interrupter([&bus]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            bus.interrupt();
+        });
+        auto start = std::chrono::steady_clock::now();
+        bus.waitForAvailable(reader, 4096, std::chrono::milliseconds(5000));
+        auto waited = std::chrono::steady_clock::now() - start;
+        interrupter.join();
+
+        if (waited < std::chrono::milliseconds(1000)) {
+            std::cout << "✓ interrupt() woke the waiting reader" << std::endl;
+        } else {
+            std::cout << "✗ interrupt() did not wake the reader" << std::endl;
+        }
+    }
+
+    static void testTimestamps() {
+        std::cout << "Testing capture timestamps..." << std::endl;
+
+        // Stereo at 16 kHz: 320 samples per 10 ms block
+        jarvis::AudioBroadcastBuffer bus(8192, 16000, 2);
+        std::vector<int16_t> block(320);
+        auto t0 = std::chrono::steady_clock::now();
+
+        jarvis::AudioTimestamp stamp{0, t0};
+        bus.write(block.data(), block.size(), stamp);
+        // A dropped block upstream leaves a 160-frame gap in the frame index
+        stamp = stamp.advancedBy(320, 16000);
+        bus.write(block.data(), block.size(), stamp);
+
+        auto mid = bus.timestampAt(100);          // frame 50 of the first block
+        auto second = bus.timestampAt(320 + 40);  // frame 20 of the second block
+        auto ms = [t0](const jarvis::AudioTimestamp& ts) {
+            return std::chrono::duration<double, std::milli>(ts.captureTime - t0).count();
+        };
+
+        bool ok = mid.frameIndex == 50 && std::abs(ms(mid) - 3.125) < 0.01 &&
+                  second.frameIndex == 340 && std::abs(ms(second) - 21.25) < 0.01;
+        if (ok) {
+            std::cout << "✓ Positions map to frame index and capture time across gaps" << std::endl;
+        } else {
+            std::cout << "✗ Unexpected timestamps (frames " << mid.frameIndex << ", "
+                      << second.frameIndex << ")" << std::endl;
+        }
+
+        jarvis::AudioBroadcastBuffer unstamped(1024);
+        unstamped.write(block.data(), block.size());
+        if (!unstamped.timestampAt(0).valid()) {
+            std::cout << "✓ Unstamped writes report no timestamp" << std::endl;
+        } else {
+            std::cout << "✗ Unstamped write produced a timestamp" << std::endl;
+        }
+    }
+};
+
+int main() {
+    std::cout << "=== Audio Broadcast Buffer Test ===" << std::endl;
+
+    SimpleAudioBroadcastBufferTest::testFanOut();
+    SimpleAudioBroadcastBufferTest::testOverrun();
+    SimpleAudioBroadcastBufferTest::testPeekConsume();
+    SimpleAudioBroadcastBufferTest::testBlockingWait();
+    SimpleAudioBroadcastBufferTest::testTimestamps();
+
+    std::cout << "=== Test Complete ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <numbers>
+#include "audio/audio_front_end.h"
+
+class SimpleAudioFrontEndTest {
+public:
+    using Clock = jarvis::AudioTimestamp::Clock;
+
+    struct Output {
+        std::vector<int16_t> pcm;
+        std::vector<float> samples;
+        std::vector<jarvis::AudioTimestamp> stamps;    // one per output frame
+    };
+
+    // Feed 10 ms blocks stamped as a real capture would, collecting everything the front end publishes
+    static Output run(jarvis::AudioFrontEnd& frontEnd, const std::vector<int16_t>& input, int inputRate,
+                      Clock::time_point start) {
+        Output out;
+        const size_t block = inputRate / 100;
+        for (size_t i = 0; i < input.size(); i += block) {
+            jarvis::AudioTimestamp stamp = jarvis::AudioTimestamp{0, start}.advancedBy(i, inputRate);
+            size_t frames = frontEnd.process({input.data() + i, std::min(block, input.size() - i)}, stamp);
+            auto pcm = frontEnd.pcm();
+            auto samples = frontEnd.samples();
+            out.pcm.insert(out.pcm.end(), pcm.begin(), pcm.end());
+            out.samples.insert(out.samples.end(), samples.begin(), samples.end());
+            for (size_t f = 0; f < frames; ++f) {
+                out.stamps.push_back(frontEnd.timestamp().advancedBy(f, frontEnd.getOutputRate()));
+            }
+        }
+        return out;
+    }
+
+    static bool testDcRemoval() {
+        std::cout << "Testing DC removal and float conversion..." << std::endl;
+
+        // 1 kHz tone riding on a large offset, as from a mic with a biased ADC
+        const int rate = 48000;
+        std::vector<int16_t> input(rate * 2);
+        for (size_t i = 0; i < input.size(); ++i) {
+            input[i] = static_cast<int16_t>(std::lround(
+                5000.0 + 8000.0 * std::sin(2.0 * std::numbers::pi * 1000.0 * i / rate)));
+        }
+
+        jarvis::AudioFrontEnd frontEnd(rate, rate / 100);
+        auto out = run(frontEnd, input, rate, Clock::now());
+
+        // Skip the first second while the highpass settles
+        double mean = 0.0;
+        double power = 0.0;
+        double maxFloatError = 0.0;
+        const size_t settle = 16000;
+        for (size_t i = settle; i < out.pcm.size(); ++i) {
+            mean += out.pcm[i];
+            power += static_cast<double>(out.pcm[i]) * out.pcm[i];
+            maxFloatError = std::max(maxFloatError, std::abs(out.samples[i] * 32768.0 - out.pcm[i]));
+        }
+        size_t n = out.pcm.size() - settle;
+        mean /= n;
+        double toneDb = 20.0 * std::log10(std::sqrt(power / n) / (8000.0 / std::sqrt(2.0)));
+
+        bool ok = out.pcm.size() + 1 >= input.size() / 3 && std::abs(mean) < 10.0 &&
+                  std::abs(toneDb) < 0.1 && maxFloatError <= 0.5;
+        std::cout << "  mean " << mean << ", tone " << toneDb << " dB, float vs pcm "
+                  << maxFloatError << " LSB" << std::endl;
+
+        // Disabled, the offset comes through
+        jarvis::AudioFrontEnd raw(rate, rate / 100);
+        raw.setDcRemoval(false);
+        auto rawOut = run(raw, input, rate, Clock::now());
+        double rawMean = 0.0;
+        for (size_t i = settle; i < rawOut.pcm.size(); ++i) {
+            rawMean += rawOut.pcm[i];
+        }
+        rawMean /= rawOut.pcm.size() - settle;
+        ok &= std::abs(rawMean - 5000.0) < 10.0;
+
+        std::cout << (ok ? "✓ " : "✗ ") << "Offset removed, tone and float output intact" << std::endl;
+        return ok;
+    }
+
+    static bool testTimeline() {
+        std::cout << "Testing output timestamps..." << std::endl;
+
+        // A click at exactly 0.5 s must come out stamped 0.5 s, whatever the filter delay
+        bool ok = true;
+        for (int rate : {48000, 44100, 32000, 16000}) {
+            std::vector<int16_t> input(rate, 0);
+            input[rate / 2] = 30000;
+
+            jarvis::AudioFrontEnd frontEnd(rate, rate / 100);
+            frontEnd.setDcRemoval(false);
+            auto start = Clock::now();
+            auto out = run(frontEnd, input, rate, start);
+
+            size_t peak = 0;
+            for (size_t i = 0; i < out.pcm.size(); ++i) {
+                if (out.pcm[i] > out.pcm[peak]) {
+                    peak = i;
+                }
+            }
+            double clickMs = std::chrono::duration<double, std::milli>(out.stamps[peak].captureTime - start).count();
+
+            // Stamps run continuously at 16 kHz from block to block
+            bool continuous = true;
+            for (size_t i = 1; i < out.stamps.size(); ++i) {
+                int64_t step = static_cast<int64_t>(out.stamps[i].frameIndex - out.stamps[i - 1].frameIndex);
+                continuous &= std::abs(step - 1) <= 1;
+            }
+
+            bool pass = std::abs(clickMs - 500.0) < 1000.0 / 16000 && continuous;
+            ok &= pass;
+            std::cout << "  " << (pass ? "" : "FAIL ") << rate << " Hz: click at " << clickMs << " ms, frame "
+                      << out.stamps[peak].frameIndex << std::endl;
+        }
+        std::cout << (ok ? "✓ " : "✗ ") << "Output stamped on the capture timeline" << std::endl;
+        return ok;
+    }
+
+    static bool testPassThrough() {
+        std::cout << "Testing 16 kHz capture..." << std::endl;
+
+        std::vector<int16_t> input(1600);
+        for (size_t i = 0; i < input.size(); ++i) {
+            input[i] = static_cast<int16_t>(i * 37 % 20000 - 10000);
+        }
+        jarvis::AudioFrontEnd frontEnd(16000, 160);
+        frontEnd.setDcRemoval(false);
+        auto start = Clock::now();
+        auto out = run(frontEnd, input, 16000, start);
+
+        bool ok = out.pcm == input && out.stamps[800].frameIndex == 800 &&
+                  out.stamps[800].captureTime == jarvis::AudioTimestamp{0, start}.advancedBy(800, 16000).captureTime;
+        std::cout << (ok ? "✓ " : "✗ ") << "Samples and stamps unchanged" << std::endl;
+        return ok;
+    }
+};
+
+int main() {
+    std::cout << "=== Audio Front End Test ===" << std::endl;
+
+    bool ok = SimpleAudioFrontEndTest::testDcRemoval();
+    ok &= SimpleAudioFrontEndTest::testTimeline();
+    ok &= SimpleAudioFrontEndTest::testPassThrough();
+
+    std::cout << "=== Test Complete ===" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <mutex>
+#include "audio/audio_player.h"
+#include "audio/audio_capture.h"
+#include "audio/audio_source.h"
+
+class SimpleAudioPlayerTest {
+public:
+    static bool testScheduledPlayback() {
+        std::cout << "Testing sample-accurate scheduling and stop..." << std::endl;
+
+        // The player rides on a free-running capture, so no device is needed
+        jarvis::AudioCapture capture;
+        capture.setSource(std::make_unique<jarvis::ToneSource>(16000, 1, 440.0, 0.5, 1000),
+                          jarvis::SourcePacing::FreeRun);
+        capture.initialize(16000, 1, 160);
+
+        jarvis::AudioPlayer player;
+        player.initialize(16000, 1, 160);
+        std::mutex mutex;
+        std::vector<jarvis::PlaybackEvent> events;
+        player.setPositionCallback([&](const jarvis::PlaybackEvent& event) {
+            if (event.type != jarvis::PlaybackEvent::Type::Progress) {
+                std::lock_guard<std::mutex> lock(mutex);
+                events.push_back(event);
+            }
+        });
+        capture.attachPlayer(&player);
+        player.start();
+
+        // A at 1000, B right behind it and cut off at 5000, C queued after the stop
+        uint64_t a = player.enqueue(std::vector<int16_t>(2000, 1), 1000);
+        uint64_t b = player.enqueue(std::vector<int16_t>(3000, 2));
+        player.stopAt(5000);
+        uint64_t c = player.enqueue(std::vector<int16_t>(500, 3), 8000);
+
+        capture.startCapture([](const std::vector<int16_t>&) {});
+        while (capture.isRunning()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        capture.stopCapture();
+        uint64_t rendered = player.getOutputPosition();
+        bool drained = !player.isPlaying();
+        player.stop();
+
+        using Type = jarvis::PlaybackEvent::Type;
+        auto find = [&](uint64_t id, Type type) -> const jarvis::PlaybackEvent* {
+            for (const auto& event : events) {
+                if (event.chunkId == id && event.type == type) {
+                    return &event;
+                }
+            }
+            return nullptr;
+        };
+        auto at = [&](uint64_t id, Type type, uint64_t frame) {
+            const auto* event = find(id, type);
+            return event && event->outputFrame == frame;
+        };
+
+        const auto* stopped = find(b, Type::Stopped);
+        bool ok = at(a, Type::Started, 1000) && at(a, Type::Finished, 3000) &&
+                  at(b, Type::Started, 3000) && stopped && stopped->outputFrame == 5000 &&
+                  stopped->chunkFrame == 2000 && !find(b, Type::Finished) &&
+                  at(c, Type::Started, 8000) && at(c, Type::Finished, 8500) &&
+                  rendered == 16000 && drained;
+        std::cout << (ok ? "✓ " : "✗ ") << events.size() << " events, B stopped at frame "
+                  << (stopped ? stopped->outputFrame : 0) << ", " << rendered << " frames rendered"
+                  << std::endl;
+        return ok;
+    }
+
+    static bool testQueueLimit() {
+        std::cout << "Testing bounded chunk queue..." << std::endl;
+
+        jarvis::AudioPlayer player;
+        player.initialize(16000, 1, 160, 4);
+
+        size_t accepted = 0;
+        for (int i = 0; i < 8; ++i) {
+            accepted += player.enqueue(std::vector<int16_t>(160, 1)) != 0;
+        }
+        bool empty = player.enqueue({}) == 0;
+
+        bool ok = accepted == 4 && empty && player.isPlaying();
+        std::cout << (ok ? "✓ " : "✗ ") << "Accepted " << accepted << " of 8 chunks" << std::endl;
+        return ok;
+    }
+};
+
+int main() {
+    std::cout << "=== Audio Player Test ===" << std::endl;
+
+    bool ok = SimpleAudioPlayerTest::testScheduledPlayback();
+    ok &= SimpleAudioPlayerTest::testQueueLimit();
+
+    std::cout << "=== Test Complete ===" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <numbers>
+#include "audio/audio_resampler.h"
+
+class SimpleAudioResamplerTest {
+public:
+    static std::vector<int16_t> tone(int sampleRate, double frequency, double amplitude, size_t frames) {
+        std::vector<int16_t> samples(frames);
+        for (size_t i = 0; i < frames; ++i) {
+            samples[i] = static_cast<int16_t>(std::lround(
+                amplitude * 32767.0 * std::sin(2.0 * std::numbers::pi * frequency * i / sampleRate)));
+        }
+        return samples;
+    }
+
+    static double rms(const std::vector<int16_t>& samples, size_t skip) {
+        double sum = 0.0;
+        for (size_t i = skip; i < samples.size(); ++i) {
+            sum += static_cast<double>(samples[i]) * samples[i];
+        }
+        return std::sqrt(sum / (samples.size() - skip));
+    }
+
+    static std::vector<int16_t> convert(int inputRate, double frequency,
+                                        jarvis::AudioResampler::Quality quality) {
+        jarvis::AudioResampler resampler(inputRate, 16000, 1, quality);
+        auto input = tone(inputRate, frequency, 0.5, inputRate);
+        std::vector<int16_t> output;
+        for (size_t i = 0; i < input.size(); i += 480) {
+            auto block = resampler.resample(input.data() + i, std::min<size_t>(480, input.size() - i));
+            output.insert(output.end(), block.begin(), block.end());
+        }
+        return output;
+    }
+
+    static bool testBlockBoundaries() {
+        std::cout << "Testing continuity across block boundaries..." << std::endl;
+
+        // Any split of the stream must give exactly the one-shot output
+        bool ok = true;
+        std::mt19937 rng(3);
+        for (int inputRate : {48000, 44100, 32000, 22050}) {
+            for (int channels : {1, 2}) {
+                std::vector<int16_t> input(inputRate / 2 * channels);
+                std::uniform_int_distribution<int> sample(-20000, 20000);
+                for (auto& s : input) {
+                    s = static_cast<int16_t>(sample(rng));
+                }
+
+                jarvis::AudioResampler whole(inputRate, 16000, channels);
+                auto expected = whole.resample(input.data(), input.size() / channels);
+
+                jarvis::AudioResampler split(inputRate, 16000, channels);
+                std::vector<int16_t> actual;
+                std::uniform_int_distribution<size_t> blockSize(1, 700);
+                for (size_t frame = 0; frame < input.size() / channels;) {
+                    size_t frames = std::min(blockSize(rng), input.size() / channels - frame);
+                    auto block = split.resample(input.data() + frame * channels, frames);
+                    if (block.size() > split.maxOutputFrames(frames) * channels) {
+                        ok = false;
+                    }
+                    actual.insert(actual.end(), block.begin(), block.end());
+                    frame += frames;
+                }
+
+                size_t expectedFrames = static_cast<size_t>(input.size() / channels) * 16000 / inputRate;
+                if (actual != expected || expected.size() / channels + 1 < expectedFrames) {
+                    std::cout << "  " << inputRate << " Hz x" << channels << ": " << actual.size()
+                              << " vs " << expected.size() << " samples" << std::endl;
+                    ok = false;
+                }
+            }
+        }
+        std::cout << (ok ? "✓ " : "✗ ") << "Split and one-shot output identical at all four rates" << std::endl;
+        return ok;
+    }
+
+    static bool testPassbandAndAliasing() {
+        std::cout << "Testing passband gain and alias rejection..." << std::endl;
+
+        using Quality = jarvis::AudioResampler::Quality;
+        bool ok = true;
+        const double reference = 0.5 * 32767.0 / std::sqrt(2.0);
+        const size_t settle = 200;
+        for (Quality quality : {Quality::Fast, Quality::Balanced, Quality::High}) {
+            for (int inputRate : {48000, 44100, 32000, 22050}) {
+                double passDb = 20.0 * std::log10(rms(convert(inputRate, 1000.0, quality), settle) / reference);
+                // Above the output Nyquist, and below the input one
+                double aliasFrequency = std::min(inputRate / 2.0 - 500.0, 11000.0);
+                double aliasDb = 20.0 * std::log10(
+                    rms(convert(inputRate, aliasFrequency, quality), settle) / reference + 1e-9);
+
+                double required = quality == Quality::Fast ? -50.0 : -65.0;
+                bool pass = std::abs(passDb) < 0.1 && aliasDb < required;
+                ok &= pass;
+                std::cout << "  " << (pass ? "" : "FAIL ") << inputRate << " Hz q" << static_cast<int>(quality)
+                          << ": 1 kHz " << passDb << " dB, " << aliasFrequency << " Hz " << aliasDb
+                          << " dB" << std::endl;
+            }
+        }
+        std::cout << (ok ? "✓ " : "✗ ") << "Flat passband, aliases suppressed" << std::endl;
+        return ok;
+    }
+
+    static bool testPassThrough() {
+        std::cout << "Testing equal rates..." << std::endl;
+
+        jarvis::AudioResampler resampler(16000, 16000);
+        auto input = tone(16000, 440.0, 0.5, 512);
+        bool ok = resampler.resample(input.data(), input.size()) == input &&
+                  resampler.getLatencyFrames() == 0.0;
+        std::cout << (ok ? "✓ " : "✗ ") << "Output equals input" << std::endl;
+        return ok;
+    }
+
+    static bool testCallerBuffers() {
+        std::cout << "Testing conversion into caller buffers..." << std::endl;
+
+        // Same stream as the allocating call, including the specialized 2:1 and 3:1 kernels
+        bool ok = true;
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> sample(-30000, 30000);
+        for (int inputRate : {48000, 44100, 32000}) {
+            for (int channels : {1, 2}) {
+                jarvis::AudioResampler allocating(inputRate, 16000, channels);
+                jarvis::AudioResampler into(inputRate, 16000, channels);
+                std::vector<int16_t> block(480 * channels);
+                std::vector<int16_t> output(into.maxOutputFrames(480) * channels);
+                for (int i = 0; i < 50; ++i) {
+                    for (auto& s : block) {
+                        s = static_cast<int16_t>(sample(rng));
+                    }
+                    auto expected = allocating.resample(block.data(), 480);
+                    size_t frames = into.resample(block, output);
+                    if (frames * channels != expected.size() ||
+                        !std::equal(expected.begin(), expected.end(), output.begin())) {
+                        ok = false;
+                    }
+                }
+            }
+        }
+
+        // Too small an output buffer consumes nothing
+        jarvis::AudioResampler resampler(48000, 16000);
+        std::vector<int16_t> input(480, 1000);
+        std::vector<int16_t> small(resampler.maxOutputFrames(480) - 1);
+        ok &= resampler.resample(input, small) == 0;
+
+        // Equal rates: a copy, or nothing at all in place
+        jarvis::AudioResampler same(16000, 16000);
+        auto tone440 = tone(16000, 440.0, 0.5, 512);
+        auto inPlace = tone440;
+        std::vector<int16_t> copy(512);
+        ok &= same.isPassthrough() && !resampler.isPassthrough() &&
+              same.resample(tone440, copy) == 512 && copy == tone440 &&
+              same.resample(inPlace, inPlace) == 512 && inPlace == tone440;
+
+        std::cout << (ok ? "✓ " : "✗ ") << "Caller-buffer output matches the allocating call" << std::endl;
+        return ok;
+    }
+};
+
+int main() {
+    std::cout << "=== Audio Resampler Test ===" << std::endl;
+
+    bool ok = SimpleAudioResamplerTest::testBlockBoundaries();
+    ok &= SimpleAudioResamplerTest::testPassbandAndAliasing();
+    ok &= SimpleAudioResamplerTest::testPassThrough();
+    ok &= SimpleAudioResamplerTest::testCallerBuffers();
+
+    std::cout << "=== Test Complete ===" << std::endl;
+    return ok ? 0 : 1;
+}
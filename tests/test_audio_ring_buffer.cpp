@@ -0,0 +1,146 @@
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <numeric>
+#include "audio/audio_ring_buffer.h"
+
+class SimpleAudioRingBufferTest {
+public:
+    static bool testDropNewest() {
+        std::cout << "Testing drop-newest policy..." << std::endl;
+
+        jarvis::AudioRingBuffer ring(1024, jarvis::OverflowPolicy::DropNewest);
+        std::vector<int16_t> block(400);
+        std::iota(block.begin(), block.end(), 0);
+
+        bool accepted = ring.write(block.data(), block.size()) && ring.write(block.data(), block.size());
+        bool rejected = !ring.write(block.data(), block.size());
+        auto stats = ring.getStats();
+
+        std::vector<int16_t> out(800);
+        size_t got = ring.read(out.data(), out.size());
+
+        bool ok = accepted && rejected && stats.droppedSamples == 400 && stats.overflows == 1 &&
+                  stats.highWaterMark == 800 && got == 800 && out[400] == 0;
+        std::cout << (ok ? "✓ " : "✗ ") << "Rejected write counted (dropped=" << stats.droppedSamples
+                  << ", high water=" << stats.highWaterMark << ")" << std::endl;
+        return ok;
+    }
+
+    static bool testDropOldest() {
+        std::cout << "Testing drop-oldest policy..." << std::endl;
+
+        jarvis::AudioRingBuffer ring(1024, jarvis::OverflowPolicy::DropOldest);
+        std::vector<int16_t> block(400);
+        for (int16_t i = 0; i < 4; ++i) {
+            std::fill(block.begin(), block.end(), i);
+            ring.write(block.data(), block.size());
+        }
+        auto stats = ring.getStats();
+
+        // Block 0 is gone entirely, block 1 survives in part
+        std::vector<int16_t> out(1024);
+        size_t got = ring.read(out.data(), out.size());
+        bool ok = got == 1024 && stats.droppedSamples == 576 && stats.overflows == 2 &&
+                  out.front() == 1 && out.back() == 3 && stats.highWaterMark == 1024;
+        std::cout << (ok ? "✓ " : "✗ ") << "Kept the newest " << got << " samples (dropped="
+                  << stats.droppedSamples << ")" << std::endl;
+        return ok;
+    }
+
+    static bool testDropOldestConcurrent() {
+        std::cout << "Testing drop-oldest with a slow consumer..." << std::endl;
+
+        // Each sample is its own sequence number; whatever the consumer sees must be in order
+        jarvis::AudioRingBuffer ring(256, jarvis::OverflowPolicy::DropOldest);
+        const int total = 200000;
+        std::thread producer([&]() {
+            std::vector<int16_t> block(64);
+            for (int n = 0; n < total; n += 64) {
+                for (int i = 0; i < 64; ++i) {
+                    block[i] = static_cast<int16_t>((n + i) & 0x7fff);
+                }
+                ring.write(block.data(), block.size());
+                if ((n / 64) % 4 == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        std::vector<int16_t> out(100);
+        size_t received = 0;
+        bool ordered = true;
+        int last = -1;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            size_t got = ring.read(out.data(), out.size());
+            for (size_t i = 0; i < got; ++i) {
+                // Sequence numbers wrap at 15 bits; any forward step is fine
+                int value = out[i];
+                int step = (value - last) & 0x7fff;
+                if (last >= 0 && (step == 0 || step > 0x4000)) {
+                    ordered = false;
+                }
+                last = value;
+            }
+            received += got;
+            if (got == 0 && ring.available() == 0 && ring.getStats().droppedSamples + received >= total) {
+                break;
+            }
+        }
+        producer.join();
+
+        auto stats = ring.getStats();
+        bool ok = ordered && received + stats.droppedSamples == total;
+        std::cout << (ok ? "✓ " : "✗ ") << "Received " << received << " in order, dropped "
+                  << stats.droppedSamples << " of " << total << std::endl;
+        return ok;
+    }
+
+    static bool testBlock() {
+        std::cout << "Testing block-with-timeout policy..." << std::endl;
+
+        jarvis::AudioRingBuffer ring(1024, jarvis::OverflowPolicy::Block, std::chrono::milliseconds(500));
+        std::vector<int16_t> block(1024, 1);
+        ring.write(block.data(), block.size());
+
+        // Consumer frees space after 50 ms; the blocked write then goes through
+        std::thread consumer([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            std::vector<int16_t> out(512);
+            ring.read(out.data(), out.size());
+        });
+        bool written = ring.write(block.data(), 512);
+        consumer.join();
+        auto afterWait = ring.getStats();
+
+        // Nobody reads now, so the write times out and is dropped
+        jarvis::AudioRingBuffer stalled(1024, jarvis::OverflowPolicy::Block, std::chrono::milliseconds(20));
+        stalled.write(block.data(), block.size());
+        bool timedOut = !stalled.write(block.data(), 1);
+        auto afterTimeout = stalled.getStats();
+
+        bool ok = written && afterWait.droppedSamples == 0 &&
+                  afterWait.stallTime >= std::chrono::milliseconds(40) &&
+                  timedOut && afterTimeout.droppedSamples == 1 &&
+                  afterTimeout.stallTime >= std::chrono::milliseconds(15);
+        std::cout << (ok ? "✓ " : "✗ ") << "Stalled "
+                  << std::chrono::duration<double, std::milli>(afterWait.stallTime).count()
+                  << " ms before the write fit; timeout dropped " << afterTimeout.droppedSamples
+                  << " sample" << std::endl;
+        return ok;
+    }
+};
+
+int main() {
+    std::cout << "=== Audio Ring Buffer Test ===" << std::endl;
+
+    bool ok = SimpleAudioRingBufferTest::testDropNewest();
+    ok &= SimpleAudioRingBufferTest::testDropOldest();
+    ok &= SimpleAudioRingBufferTest::testDropOldestConcurrent();
+    ok &= SimpleAudioRingBufferTest::testBlock();
+
+    std::cout << "=== Test Complete ===" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <cstdio>
+#include "audio/audio_source.h"
+#include "audio/audio_capture.h"
+
+class SimpleAudioSourceTest {
+public:
+    static bool testWavRoundTrip() {
+        std::cout << "Testing WAV file source round trip..." << std::endl;
+
+        const char* path = "test_audio_source.wav";
+        std::vector<int16_t> written(16000 * 2);
+        for (size_t i = 0; i < written.size(); ++i) {
+            written[i] = static_cast<int16_t>(i * 7);
+        }
+
+        if (!jarvis::FileAudioSource::writeWav(path, written.data(), written.size() / 2, 16000, 2)) {
+            std::cout << "✗ Failed to write " << path << std::endl;
+            return false;
+        }
+
+        jarvis::FileAudioSource source;
+        if (!source.open(path)) {
+            std::cout << "✗ Failed to open " << path << std::endl;
+            return false;
+        }
+
+        std::vector<int16_t> read(written.size());
+        size_t frames = source.read(read.data(), read.size() / 2);
+        size_t extra = source.read(read.data(), 1);
+        std::remove(path);
+
+        bool ok = source.getSampleRate() == 16000 && source.getChannels() == 2 &&
+                  frames == written.size() / 2 && extra == 0 && read == written;
+        std::cout << (ok ? "✓ " : "✗ ") << "Read back " << frames << " stereo frames" << std::endl;
+        return ok;
+    }
+
+    static bool testLoopingCorpus() {
+        std::cout << "Testing looping corpus..." << std::endl;
+
+        std::vector<std::unique_ptr<jarvis::AudioSource>> corpus;
+        corpus.push_back(std::make_unique<jarvis::ToneSource>(16000, 1, 440.0, 0.5, 100));
+        corpus.push_back(std::make_unique<jarvis::NoiseSource>(16000, 1, 0.1, 50));
+        jarvis::LoopingSource source(std::move(corpus), 3);
+
+        std::vector<int16_t> block(256);
+        size_t total = 0;
+        while (size_t frames = source.read(block.data(), block.size())) {
+            total += frames;
+        }
+
+        bool ok = total == 3 * (1600 + 800) && source.getCompletedLoops() == 3;
+        std::cout << (ok ? "✓ " : "✗ ") << "Played " << total << " frames over "
+                  << source.getCompletedLoops() << " loops" << std::endl;
+        return ok;
+    }
+
+    static bool testFreeRunCapture() {
+        std::cout << "Testing free-running capture from a synthetic source..." << std::endl;
+
+        // One minute of audio through the full AudioCapture path, no device required
+        const int durationMs = 60000;
+        jarvis::AudioCapture capture;
+        capture.setSource(std::make_unique<jarvis::ToneSource>(16000, 1, 440.0, 0.5, durationMs),
+                          jarvis::SourcePacing::FreeRun);
+        if (!capture.initialize(16000, 1, 512)) {
+            std::cout << "✗ Initialization failed" << std::endl;
+            return false;
+        }
+
+        std::atomic<size_t> received{0};
+        auto start = std::chrono::steady_clock::now();
+        capture.startCapture([&](const std::vector<int16_t>& block) {
+            received += block.size();
+        });
+        while (capture.isRunning()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        auto elapsed = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        capture.stopCapture();
+
+        // The last block is padded with silence to a full buffer
+        size_t expected = (16000 * durationMs / 1000 + 511) / 512 * 512;
+        bool ok = received == expected && elapsed < durationMs;
+        std::cout << (ok ? "✓ " : "✗ ") << "Captured " << received << " samples in "
+                  << elapsed << " ms (" << durationMs / elapsed << "x real time)" << std::endl;
+        return ok;
+    }
+
+    static bool testRealTimePacing() {
+        std::cout << "Testing real-time pacing..." << std::endl;
+
+        const int durationMs = 300;
+        jarvis::AudioCapture capture;
+        capture.setSource(std::make_unique<jarvis::NoiseSource>(16000, 1, 0.1, durationMs));
+        capture.initialize(16000, 1, 160);
+
+        std::atomic<size_t> received{0};
+        auto start = std::chrono::steady_clock::now();
+        capture.startCapture([&](const std::vector<int16_t>& block) {
+            received += block.size();
+        });
+        while (capture.isRunning()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        auto elapsed = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        capture.stopCapture();
+
+        bool ok = received == 16000 * durationMs / 1000 && elapsed >= durationMs - 20;
+        std::cout << (ok ? "✓ " : "✗ ") << "Captured " << received << " samples in "
+                  << elapsed << " ms" << std::endl;
+        return ok;
+    }
+};
+
+int main() {
+    std::cout << "=== Audio Source Test ===" << std::endl;
+
+    bool ok = SimpleAudioSourceTest::testWavRoundTrip();
+    ok &= SimpleAudioSourceTest::testLoopingCorpus();
+    ok &= SimpleAudioSourceTest::testFreeRunCapture();
+    ok &= SimpleAudioSourceTest::testRealTimePacing();
+
+    std::cout << "=== Test Complete ===" << std::endl;
+    return ok ? 0 : 1;
+}
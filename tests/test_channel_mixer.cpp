@@ -0,0 +1,131 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include "audio/channel_mixer.h"
+
+class SimpleChannelMixerTest {
+public:
+    static std::vector<int16_t> randomBlock(size_t samples, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> dist(-32768, 32767);
+        std::vector<int16_t> block(samples);
+        for (auto& sample : block) {
+            sample = static_cast<int16_t>(dist(rng));
+        }
+        return block;
+    }
+
+    static bool testDeinterleave() {
+        std::cout << "Testing deinterleave for 1-6 channels..." << std::endl;
+
+        // Odd frame counts exercise the scalar tail after the vector loop
+        bool ok = true;
+        for (int channels = 1; channels <= 6; ++channels) {
+            for (size_t frames : {1u, 7u, 8u, 161u, 1024u}) {
+                auto block = randomBlock(frames * channels, channels * 1000 + frames);
+                jarvis::ChannelMixer mixer(channels);
+                mixer.process(block.data(), frames);
+                for (int c = 0; c < channels; ++c) {
+                    auto plane = mixer.channel(c);
+                    for (size_t i = 0; i < frames && ok; ++i) {
+                        ok = plane.size() == frames && plane[i] == block[i * channels + c];
+                    }
+                }
+            }
+        }
+        std::cout << (ok ? "✓ " : "✗ ") << "Every plane matches its interleaved channel" << std::endl;
+        return ok;
+    }
+
+    static bool testDownmix() {
+        std::cout << "Testing weighted downmix..." << std::endl;
+
+        const size_t frames = 1003;
+        auto block = randomBlock(frames * 4, 42);
+        jarvis::ChannelMixer mixer(4, 256);
+        std::vector<float> weights = {0.7f, 0.5f, -0.25f, 0.6f};
+        bool accepted = mixer.setWeights(weights) && !mixer.setWeights({1.0f});
+        mixer.process(block.data(), frames);
+
+        // Reference in double; the sum exceeds 16 bits often enough to check saturation
+        auto mono = mixer.mono();
+        int maxError = 0;
+        size_t clipped = 0;
+        for (size_t i = 0; i < frames; ++i) {
+            double sum = 0.0;
+            for (int c = 0; c < 4; ++c) {
+                sum += block[i * 4 + c] * static_cast<double>(weights[c]);
+            }
+            clipped += std::abs(sum) > 32767.0;
+            long expected = std::clamp(std::lround(sum), -32768L, 32767L);
+            maxError = std::max(maxError, static_cast<int>(std::abs(expected - mono[i])));
+        }
+
+        bool ok = accepted && mono.size() == frames && maxError <= 1 && clipped > 0;
+        std::cout << (ok ? "✓ " : "✗ ") << "Max error " << maxError << " LSB, " << clipped
+                  << " frames saturated" << std::endl;
+        return ok;
+    }
+
+    static bool testMonoPassthrough() {
+        std::cout << "Testing mono passthrough..." << std::endl;
+
+        auto block = randomBlock(512, 7);
+        jarvis::ChannelMixer mixer(1);
+        mixer.process(block.data(), block.size());
+        bool ok = mixer.mono().data() == block.data() && mixer.channel(0).data() == block.data();
+        std::cout << (ok ? "✓ " : "✗ ") << "Views point at the input block" << std::endl;
+        return ok;
+    }
+
+    static void benchQuad() {
+        std::cout << "Benchmarking 4-channel deinterleave + downmix..." << std::endl;
+
+        // One minute of 4-channel 48 kHz audio in 10 ms blocks
+        const size_t frames = 480;
+        auto block = randomBlock(frames * 4, 1);
+        jarvis::ChannelMixer mixer(4, frames);
+        std::vector<int16_t> scalar(frames);
+
+        auto start = std::chrono::steady_clock::now();
+        long checksum = 0;
+        for (int i = 0; i < 6000; ++i) {
+            mixer.process(block.data(), frames);
+            checksum += mixer.mono()[i % frames];
+        }
+        double vectorMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 6000; ++i) {
+            for (size_t f = 0; f < frames; ++f) {
+                float sum = 0.0f;
+                for (int c = 0; c < 4; ++c) {
+                    sum += block[f * 4 + c] * 0.25f;
+                }
+                scalar[f] = static_cast<int16_t>(std::lrintf(sum));
+            }
+            checksum += scalar[i % frames];
+        }
+        double scalarMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "  Mixer: " << vectorMs << " ms, per-sample loop: " << scalarMs
+                  << " ms for 60 s of audio (checksum " << checksum << ")" << std::endl;
+    }
+};
+
+int main() {
+    std::cout << "=== Channel Mixer Test ===" << std::endl;
+
+    bool ok = SimpleChannelMixerTest::testDeinterleave();
+    ok &= SimpleChannelMixerTest::testDownmix();
+    ok &= SimpleChannelMixerTest::testMonoPassthrough();
+    SimpleChannelMixerTest::benchQuad();
+
+    std::cout << "=== Test Complete ===" << std::endl;
+    return ok ? 0 : 1;
+}
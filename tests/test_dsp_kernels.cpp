@@ -0,0 +1,254 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "dsp/kernels.h"
+
+using jarvis::dsp::Isa;
+using jarvis::dsp::Kernels;
+
+class SimpleDspKernelsTest {
+public:
+    static std::vector<int16_t> randomSamples(size_t n, std::mt19937& rng) {
+        // Full range, with the extremes overrepresented
+        std::uniform_int_distribution<int> sample(-32768, 32767);
+        std::uniform_int_distribution<int> pick(0, 9);
+        std::vector<int16_t> samples(n);
+        for (auto& s : samples) {
+            int p = pick(rng);
+            s = static_cast<int16_t>(p == 0 ? -32768 : p == 1 ? 32767 : sample(rng));
+        }
+        return samples;
+    }
+
+    static std::vector<float> randomFloats(size_t n, std::mt19937& rng) {
+        std::uniform_real_distribution<float> value(-1.5f, 1.5f);
+        std::vector<float> values(n);
+        for (auto& v : values) {
+            v = value(rng);
+        }
+        return values;
+    }
+
+    // Bytes from lowest upward, the extremes overrepresented
+    static std::vector<int8_t> randomBytes(size_t n, int lowest, std::mt19937& rng) {
+        std::uniform_int_distribution<int> value(lowest, 127);
+        std::uniform_int_distribution<int> pick(0, 9);
+        std::vector<int8_t> bytes(n);
+        for (auto& b : bytes) {
+            int p = pick(rng);
+            b = static_cast<int8_t>(p == 0 ? lowest : p == 1 ? 127 : value(rng));
+        }
+        return bytes;
+    }
+
+    // Float reductions may add in any order; allow rounding relative to the size of the terms
+    static bool close(float actual, float expected, float magnitude) {
+        return std::abs(actual - expected) <= 1e-5f * magnitude + 1e-30f;
+    }
+
+    static std::vector<Isa> vectorIsas() {
+        std::vector<Isa> isas;
+        for (Isa isa : {Isa::SSE2, Isa::AVX2, Isa::AVX512, Isa::AVX512VNNI}) {
+            if (jarvis::dsp::isSupported(isa)) {
+                isas.push_back(isa);
+            } else {
+                std::cout << "  (" << jarvis::dsp::isaName(isa) << " not supported here)" << std::endl;
+            }
+        }
+        return isas;
+    }
+
+    static bool testConversionsExhaustive(const Kernels& k, const Kernels& ref) {
+        // Every 16-bit value, through every conversion and a spread of gains
+        std::vector<int16_t> all(65536);
+        for (int i = 0; i < 65536; ++i) {
+            all[i] = static_cast<int16_t>(i - 32768);
+        }
+
+        std::vector<float> f(all.size()), fRef(all.size());
+        k.int16ToFloat(all.data(), f.data(), all.size());
+        ref.int16ToFloat(all.data(), fRef.data(), all.size());
+        bool ok = std::memcmp(f.data(), fRef.data(), f.size() * sizeof(float)) == 0;
+
+        // Exact values, half-LSB ties either side, and out of range
+        std::vector<float> values;
+        for (int16_t s : all) {
+            float x = s / 32768.0f;
+            values.insert(values.end(), {x, x + 0.5f / 32768.0f, x - 0.5f / 32768.0f, x + 0.3f / 32768.0f});
+        }
+        values.insert(values.end(), {1.0f, -1.0f, 1.5f, -1.5f, 1e10f, -1e10f, 65536.0f, -65536.0f});
+        std::vector<int16_t> s(values.size()), sRef(values.size());
+        k.floatToInt16(values.data(), s.data(), values.size());
+        ref.floatToInt16(values.data(), sRef.data(), values.size());
+        ok &= s == sRef;
+
+        std::vector<int16_t> g(all.size()), gRef(all.size());
+        for (float gain : {0.0f, 0.5f, 1.0f, 1.7f, -1.0f, -3.25f, 100.0f, 1e6f}) {
+            k.gain(all.data(), g.data(), all.size(), gain);
+            ref.gain(all.data(), gRef.data(), all.size(), gain);
+            ok &= g == gRef;
+        }
+        return ok;
+    }
+
+    static bool testLengthsAndAlignment(const Kernels& k, const Kernels& ref) {
+        // Every tail length against every vector width, at misaligned starts
+        std::mt19937 rng(11);
+        bool ok = true;
+        for (size_t offset = 0; offset < 4; ++offset) {
+            for (size_t n = 0; n <= 140; ++n) {
+                auto a = randomSamples(n + offset, rng);
+                auto b = randomSamples(n + offset, rng);
+                auto x = randomFloats(n + offset + 40, rng);
+                auto y = randomFloats(n + offset, rng);
+                const int16_t* pa = a.data() + offset;
+                const int16_t* pb = b.data() + offset;
+                const float* px = x.data() + offset;
+                const float* py = y.data() + offset;
+
+                std::vector<int16_t> mixed(n), mixedRef(n);
+                k.mix(pa, pb, mixed.data(), n);
+                ref.mix(pa, pb, mixedRef.data(), n);
+                ok &= mixed == mixedRef;
+
+                ok &= k.sumSquares(pa, n) == ref.sumSquares(pa, n);
+                ok &= k.peak(pa, n) == ref.peak(pa, n);
+
+                std::vector<float> clipped(n), clippedRef(n);
+                k.gainClip(px, clipped.data(), n, 1.3f, 0.9f);
+                ref.gainClip(px, clippedRef.data(), n, 1.3f, 0.9f);
+                ok &= clipped == clippedRef;
+
+                float magnitude = 0.0f;
+                float squares = 0.0f;
+                for (size_t i = 0; i < n; ++i) {
+                    magnitude += std::abs(px[i] * py[i]);
+                    squares += px[i] * px[i];
+                }
+                ok &= close(k.dot(px, py, n), ref.dot(px, py, n), magnitude);
+                ok &= close(k.sumSquaresFloat(px, n), ref.sumSquaresFloat(px, n), squares);
+
+                std::vector<float> acc(y.begin() + offset, y.end()), accRef = acc;
+                k.mixAccumulate(acc.data(), px, n, -0.7f);
+                ref.mixAccumulate(accRef.data(), px, n, -0.7f);
+                for (size_t i = 0; i < n; ++i) {
+                    ok &= close(acc[i], accRef[i], std::abs(py[i]) + std::abs(px[i]));
+                }
+
+                // n rows of every short feature length
+                for (size_t dim : {1, 4, 13, 16, 20, 40}) {
+                    auto rows = randomFloats(n * dim, rng);
+                    std::vector<float> d(n), dRef(n);
+                    k.squaredDistances(px, rows.data(), n, dim, d.data());
+                    ref.squaredDistances(px, rows.data(), n, dim, dRef.data());
+                    for (size_t r = 0; r < n; ++r) {
+                        ok &= close(d[r], dRef[r], 9.0f * dim);
+                    }
+                }
+
+                // Weight rows of n columns; int8 products sum exactly
+                auto xq = randomBytes(n + offset, -128, rng);
+                auto wq = randomBytes(5 * n + offset, -127, rng);
+                std::vector<int32_t> q(5), qRef(5);
+                k.gemvInt8(wq.data() + offset, xq.data() + offset, 5, n, q.data());
+                ref.gemvInt8(wq.data() + offset, xq.data() + offset, 5, n, qRef.data());
+                ok &= q == qRef;
+
+                for (size_t taps : {1, 3, 16, 33}) {
+                    auto h = randomFloats(taps, rng);
+                    std::vector<float> out(n), outRef(n);
+                    k.fir(px, out.data(), n, h.data(), taps);
+                    ref.fir(px, outRef.data(), n, h.data(), taps);
+                    for (size_t i = 0; i < n; ++i) {
+                        float m = 0.0f;
+                        for (size_t t = 0; t < taps; ++t) {
+                            m += std::abs(h[t] * px[i + t]);
+                        }
+                        ok &= close(out[i], outRef[i], m);
+                    }
+                }
+            }
+        }
+        return ok;
+    }
+
+    static bool testAgainstScalar() {
+        std::cout << "Testing vector kernels against the scalar reference..." << std::endl;
+
+        const Kernels& ref = *jarvis::dsp::kernelsFor(Isa::Scalar);
+        bool ok = true;
+        for (Isa isa : vectorIsas()) {
+            const Kernels& k = *jarvis::dsp::kernelsFor(isa);
+            bool conversions = testConversionsExhaustive(k, ref);
+            bool lengths = testLengthsAndAlignment(k, ref);
+            std::cout << "  " << jarvis::dsp::isaName(isa) << ": conversions " << (conversions ? "exact" : "FAIL")
+                      << ", all lengths " << (lengths ? "match" : "FAIL") << std::endl;
+            ok &= conversions && lengths;
+        }
+        std::cout << (ok ? "✓ " : "✗ ") << "Every instruction set matches the reference" << std::endl;
+        return ok;
+    }
+
+    static bool testReference() {
+        std::cout << "Testing reference values..." << std::endl;
+
+        bool ok = true;
+        float unit[4] = {1.0f, -1.0f, 0.5f / 32768.0f, 1.5f / 32768.0f};
+        int16_t converted[4];
+        jarvis::dsp::floatToInt16(unit, converted, 4);
+        ok &= converted[0] == 32767 && converted[1] == -32768 && converted[2] == 0 && converted[3] == 2;
+
+        // Squares of full-scale negative samples overflow anything narrower than 64 bits
+        std::vector<int16_t> loud(1 << 20, -32768);
+        ok &= jarvis::dsp::sumSquares(loud.data(), loud.size()) == (uint64_t(1) << 50);
+        ok &= jarvis::dsp::peak(loud.data(), loud.size()) == 32768;
+        ok &= jarvis::dsp::rms(loud.data(), loud.size()) == 1.0f;
+
+        // The largest products in every lane: no 16-bit intermediate saturates
+        std::vector<int8_t> xq(300, -128), wq(2 * 300, -127);
+        std::fill(wq.begin() + 300, wq.end(), 127);
+        int32_t q[2];
+        jarvis::dsp::gemvInt8(wq.data(), xq.data(), 2, 300, q);
+        ok &= q[0] == 300 * 128 * 127 && q[1] == -300 * 128 * 127;
+
+        int16_t a[3] = {30000, -30000, 100};
+        int16_t b[3] = {30000, -30000, -50};
+        int16_t sum[3];
+        jarvis::dsp::mix(a, b, sum, 3);
+        ok &= sum[0] == 32767 && sum[1] == -32768 && sum[2] == 50;
+
+        std::cout << (ok ? "✓ " : "✗ ") << "Rounding, saturation and exact integer sums as specified" << std::endl;
+        return ok;
+    }
+
+    static bool testDispatch() {
+        std::cout << "Testing dispatch..." << std::endl;
+
+        Isa best = jarvis::dsp::bestIsa();
+        bool ok = jarvis::dsp::activeIsa() == best;
+        ok &= jarvis::dsp::setIsa(Isa::Scalar) && jarvis::dsp::activeIsa() == Isa::Scalar &&
+              &jarvis::dsp::kernels() == jarvis::dsp::kernelsFor(Isa::Scalar);
+        ok &= jarvis::dsp::setIsa(best) && jarvis::dsp::activeIsa() == best;
+        for (Isa isa : {Isa::SSE2, Isa::AVX2, Isa::AVX512, Isa::AVX512VNNI}) {
+            if (!jarvis::dsp::isSupported(isa)) {
+                ok &= !jarvis::dsp::setIsa(isa) && jarvis::dsp::activeIsa() == best;
+            }
+        }
+        std::cout << (ok ? "✓ " : "✗ ") << "Started on " << jarvis::dsp::isaName(best) << std::endl;
+        return ok;
+    }
+};
+
+int main() {
+    std::cout << "=== DSP Kernels Test ===" << std::endl;
+
+    bool ok = SimpleDspKernelsTest::testDispatch();
+    ok &= SimpleDspKernelsTest::testReference();
+    ok &= SimpleDspKernelsTest::testAgainstScalar();
+
+    std::cout << "=== Test Complete ===" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <numbers>
+#include <string>
+#include <algorithm>
+#include "audio/endpointer.h"
+#include "audio/voice_activity_detector.h"
+
+using jarvis::Endpointer;
+using jarvis::VoiceActivityDetector;
+
+class SimpleEndpointerTest {
+public:
+    static constexpr int kRate = 16000;
+    static constexpr size_t kStep = kRate / 100;
+
+    // Feed a script of (milliseconds, speech) spans in 10 ms steps; returns
+    // the result and the time it was reached
+    struct Outcome {
+        Endpointer::Result result = Endpointer::Result::Continue;
+        int atMs = -1;
+    };
+
+    static Outcome feed(Endpointer& endpointer, const std::vector<std::pair<int, bool>>& script, int startMs = 0) {
+        Outcome outcome;
+        int t = startMs;
+        for (auto [ms, speech] : script) {
+            for (int i = 0; i < ms; i += 10) {
+                t += 10;
+                auto result = endpointer.update(kStep, speech);
+                if (result != Endpointer::Result::Continue && outcome.atMs < 0) {
+                    outcome = {result, t};
+                }
+            }
+        }
+        return outcome;
+    }
+
+    static bool testPauseLimits() {
+        std::cout << "Testing the pause limits..." << std::endl;
+
+        // Without a transcript only the maximum pause ends the turn
+        Endpointer endpointer(kRate);
+        Outcome vadOnly = feed(endpointer, {{200, false}, {600, true}, {2000, false}});
+        bool ok = vadOnly.result == Endpointer::Result::EndOfTurn && vadOnly.atMs == 800 + 800;
+
+        // A partial that has settled lets the minimum pause end it
+        endpointer.reset();
+        feed(endpointer, {{200, false}, {500, true}});
+        endpointer.onPartialResult("lights on");
+        Outcome stable = feed(endpointer, {{100, true}, {2000, false}}, 700);
+        ok &= stable.result == Endpointer::Result::EndOfTurn && stable.atMs == 800 + 240;
+
+        // A partial still changing in the pause holds the turn open until it settles
+        endpointer.reset();
+        feed(endpointer, {{600, true}});
+        endpointer.onPartialResult("turn");
+        feed(endpointer, {{200, false}}, 600);
+        endpointer.onPartialResult("turn off");
+        Outcome revised = feed(endpointer, {{2000, false}}, 800);
+        ok &= revised.result == Endpointer::Result::EndOfTurn && revised.atMs == 800 + 200;
+
+        // Pauses within the utterance shorter than the limits do not end it
+        endpointer.reset();
+        endpointer.onPartialResult("set a timer");
+        Outcome gaps = feed(endpointer, {{400, true}, {200, false}, {400, true}, {150, false}, {300, true},
+                                         {1000, false}});
+        ok &= gaps.result == Endpointer::Result::EndOfTurn && gaps.atMs == 1450 + 240;
+
+        std::cout << "  VAD only " << vadOnly.atMs << " ms, stable partial " << stable.atMs << " ms, revised "
+                  << revised.atMs << " ms, with gaps " << gaps.atMs << " ms" << std::endl;
+        std::cout << (ok ? "✓ " : "✗ ") << "Stable partials end the turn at the short pause" << std::endl;
+        return ok;
+    }
+
+    static bool testUtteranceLimits() {
+        std::cout << "Testing the utterance limits..." << std::endl;
+
+        Endpointer::Params params;
+        params.maxUtteranceMs = 3000;
+        Endpointer endpointer(kRate, params);
+        Outcome longest = feed(endpointer, {{500, false}, {10000, true}});
+        bool ok = longest.result == Endpointer::Result::MaxDuration && longest.atMs == 3500;
+
+        // Clicks shorter than the minimum never start the utterance
+        endpointer.reset();
+        Outcome clicks = feed(endpointer, {{100, true}, {1000, false}, {50, true}, {5000, false}});
+        ok &= clicks.result == Endpointer::Result::NoSpeech && clicks.atMs == 5000 && !endpointer.speechStarted();
+
+        // Once over, the result holds
+        ok &= endpointer.update(kStep, true) == Endpointer::Result::NoSpeech;
+
+        // Positions mark the utterance itself
+        endpointer.reset();
+        feed(endpointer, {{300, false}, {200, true}, {100, false}, {700, true}, {1000, false}});
+        ok &= endpointer.speechStartSample() == 300u * kRate / 1000 &&
+              endpointer.speechEndSample() == 1300u * kRate / 1000;
+
+        std::cout << (ok ? "✓ " : "✗ ") << "Maximum enforced, short bursts ignored, positions exact" << std::endl;
+        return ok;
+    }
+
+    static bool testWithVad() {
+        std::cout << "Testing end of turn on a short command..." << std::endl;
+
+        // "Lights on": 0.6 s of voiced syllables over fan noise, then the
+        // recognizer's last partial shortly after the speech stops
+        std::mt19937 rng(9);
+        std::normal_distribution<double> white(0.0, 1.0);
+        const int speechFrom = kRate, speechTo = kRate * 16 / 10;
+        std::vector<int16_t> pcm(kRate * 3);
+        double low = 0.0, phase = 0.0;
+        for (size_t i = 0; i < pcm.size(); ++i) {
+            low += 0.1 * (white(rng) - low);
+            double x = 0.01 * low;
+            if (static_cast<int>(i) >= speechFrom && static_cast<int>(i) < speechTo) {
+                double t = static_cast<double>(i - speechFrom) / kRate;
+                phase += 2.0 * std::numbers::pi * (130.0 + 20.0 * t) / kRate;
+                double voiced = 0.0;
+                for (int h = 1; h < 25; ++h) {
+                    voiced += std::sin(h * phase) / h;
+                }
+                x += 0.08 * std::sin(std::numbers::pi * t / 0.6) * voiced;
+            }
+            pcm[i] = static_cast<int16_t>(std::lround(std::clamp(x, -1.0, 1.0) * 32767.0));
+        }
+
+        VoiceActivityDetector vad(kRate);
+        Endpointer endpointer(kRate);
+        Outcome outcome;
+        for (size_t i = 0; i + kStep <= pcm.size() && outcome.atMs < 0; i += kStep) {
+            if (i == static_cast<size_t>(speechTo + kRate / 10)) {
+                endpointer.onPartialResult("lights on");
+            }
+            vad.processFrame(pcm.data() + i, kStep);
+            auto result = endpointer.update(kStep, vad.getFeatures().speech);
+            if (result != Endpointer::Result::Continue) {
+                outcome = {result, static_cast<int>((i + kStep) * 1000 / kRate)};
+            }
+        }
+        int latency = outcome.atMs - speechTo * 1000 / kRate;
+        bool ok = outcome.result == Endpointer::Result::EndOfTurn && latency > 0 && latency < 500;
+        std::cout << "  turn ended " << latency << " ms after the speech" << std::endl;
+        std::cout << (ok ? "✓ " : "✗ ") << "End of turn under 500 ms" << std::endl;
+        return ok;
+    }
+};
+
+int main() {
+    std::cout << "=== Endpointer Test ===" << std::endl;
+
+    bool ok = SimpleEndpointerTest::testPauseLimits();
+    ok &= SimpleEndpointerTest::testUtteranceLimits();
+    ok &= SimpleEndpointerTest::testWithVad();
+
+    std::cout << "=== Test Complete ===" << std::endl;
+    return ok ? 0 : 1;
+}
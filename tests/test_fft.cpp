@@ -0,0 +1,109 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <complex>
+#include <cmath>
+#include <numbers>
+#include <algorithm>
+#include "dsp/fft.h"
+
+using jarvis::dsp::RealFft;
+
+class SimpleFftTest {
+public:
+    static std::vector<float> randomSignal(size_t n, std::mt19937& rng) {
+        std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+        std::vector<float> x(n);
+        for (auto& v : x) {
+            v = value(rng);
+        }
+        return x;
+    }
+
+    static bool testAgainstDft() {
+        std::cout << "Testing against a direct DFT..." << std::endl;
+
+        std::mt19937 rng(7);
+        bool ok = true;
+        for (size_t n : {4, 8, 16, 64, 256, 1024}) {
+            auto x = randomSignal(n, rng);
+            RealFft fft(n);
+            std::vector<std::complex<float>> spectrum(fft.bins());
+            fft.forward(x.data(), spectrum.data());
+
+            double worst = 0.0;
+            for (size_t k = 0; k < fft.bins(); ++k) {
+                std::complex<double> sum = 0.0;
+                for (size_t t = 0; t < n; ++t) {
+                    sum += static_cast<double>(x[t]) * std::polar(1.0, -2.0 * std::numbers::pi * k * t / n);
+                }
+                worst = std::max(worst, std::abs(sum - std::complex<double>(spectrum[k])));
+            }
+            // Rounding grows with log n; relative to sqrt(n), the size of a random bin
+            bool close = worst < 1e-5 * std::sqrt(static_cast<double>(n)) * std::log2(static_cast<double>(n));
+            std::cout << "  " << n << " points: worst error " << worst << std::endl;
+            ok &= close;
+        }
+        std::cout << (ok ? "✓ " : "✗ ") << "Every bin matches the DFT" << std::endl;
+        return ok;
+    }
+
+    static bool testRoundTrip() {
+        std::cout << "Testing inverse(forward(x))..." << std::endl;
+
+        std::mt19937 rng(8);
+        bool ok = true;
+        for (size_t n : {4, 32, 512, 4096}) {
+            auto x = randomSignal(n, rng);
+            RealFft fft(n);
+            std::vector<std::complex<float>> spectrum(fft.bins());
+            std::vector<float> y(n);
+            fft.forward(x.data(), spectrum.data());
+            fft.inverse(spectrum.data(), y.data());
+            float worst = 0.0f;
+            for (size_t i = 0; i < n; ++i) {
+                worst = std::max(worst, std::abs(x[i] - y[i]));
+            }
+            ok &= worst < 1e-5f;
+        }
+        std::cout << (ok ? "✓ " : "✗ ") << "Signals survive the round trip" << std::endl;
+        return ok;
+    }
+
+    static bool testTone() {
+        std::cout << "Testing a windowed tone..." << std::endl;
+
+        // A tone centred on bin 20 lands there and its Hann neighbours only
+        const size_t n = 256;
+        auto window = jarvis::dsp::hannWindow(n);
+        std::vector<float> x(n);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = window[i] * static_cast<float>(std::sin(2.0 * std::numbers::pi * 20.0 * i / n));
+        }
+        RealFft fft(n);
+        std::vector<std::complex<float>> spectrum(fft.bins());
+        std::vector<float> power(fft.bins());
+        fft.forward(x.data(), spectrum.data());
+        jarvis::dsp::powerSpectrum(spectrum.data(), power.data(), power.size());
+
+        bool ok = std::max_element(power.begin(), power.end()) - power.begin() == 20;
+        for (size_t k = 0; k < power.size(); ++k) {
+            if (k < 19 || k > 21) {
+                ok &= power[k] < 1e-6f * power[20];
+            }
+        }
+        std::cout << (ok ? "✓ " : "✗ ") << "Energy confined to the tone's bins" << std::endl;
+        return ok;
+    }
+};
+
+int main() {
+    std::cout << "=== FFT Test ===" << std::endl;
+
+    bool ok = SimpleFftTest::testAgainstDft();
+    ok &= SimpleFftTest::testRoundTrip();
+    ok &= SimpleFftTest::testTone();
+
+    std::cout << "=== Test Complete ===" << std::endl;
+    return ok ? 0 : 1;
+}
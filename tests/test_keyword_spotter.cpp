@@ -0,0 +1,286 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <random>
+#include <cstdio>
+#include <algorithm>
+#include <fstream>
+#include "speech/keyword_spotter.h"
+#include "speech/porcupine_engine.h"
+#include "speech/wake_word_detector.h"
+#include "audio/audio_source.h"
+#include "utils/config_manager.h"
+
+using jarvis::KeywordSpotter;
+using jarvis::WakeWordDetector;
+
+class SimpleKeywordSpotterTest {
+public:
+    static constexpr int kRate = KeywordSpotter::kSampleRate;
+
+    // A voiced "word": harmonics of f0 shaped by two formants gliding
+    // through a sequence of vowels
+    struct Vowel {
+        float f1;
+        float f2;
+    };
+
+    static const std::vector<Vowel>& jarvis() {
+        static const std::vector<Vowel> v = {{730, 1090}, {270, 2290}, {300, 870}};       // a-i-u
+        return v;
+    }
+    static const std::vector<Vowel>& stop() {
+        static const std::vector<Vowel> v = {{570, 840}, {530, 1840}, {730, 1090}};       // o-e-a
+        return v;
+    }
+    static const std::vector<Vowel>& distractor() {
+        static const std::vector<Vowel> v = {{270, 2290}, {730, 1090}, {570, 840}};       // i-a-o
+        return v;
+    }
+    static const std::vector<Vowel>& otherDistractor() {
+        static const std::vector<Vowel> v = {{530, 1840}, {300, 870}};                    // e-u
+        return v;
+    }
+
+    static void speak(std::vector<int16_t>& out, const std::vector<Vowel>& word, float seconds, float f0,
+                      float level) {
+        const size_t n = static_cast<size_t>(seconds * kRate);
+        const size_t ramp = kRate / 40;
+        double phase = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            float t = static_cast<float>(i) / n * (word.size() - 1);
+            size_t s = std::min(static_cast<size_t>(t), word.size() - 2);
+            float u = t - s;
+            float f1 = word[s].f1 + (word[s + 1].f1 - word[s].f1) * u;
+            float f2 = word[s].f2 + (word[s + 1].f2 - word[s].f2) * u;
+            float pitch = f0 * (1.0f + 0.03f * std::sin(6.0f * i / kRate));
+            phase += 2.0 * M_PI * pitch / kRate;
+
+            double x = 0.0;
+            for (int k = 1; k * pitch < 4000.0f; ++k) {
+                float f = k * pitch;
+                float a = std::exp(-std::pow((f - f1) / 90.0f, 2.0f)) + 0.6f * std::exp(-std::pow((f - f2) / 120.0f, 2.0f)) +
+                          0.2f * std::exp(-std::pow((f - 2600.0f) / 150.0f, 2.0f));
+                x += a * std::sin(k * phase);
+            }
+            float envelope = std::min({1.0f, static_cast<float>(i) / ramp, static_cast<float>(n - i) / ramp});
+            out.push_back(static_cast<int16_t>(std::clamp(x * level * envelope, -32767.0, 32767.0)));
+        }
+    }
+
+    static void pause(std::vector<int16_t>& out, float seconds) {
+        out.resize(out.size() + static_cast<size_t>(seconds * kRate), 0);
+    }
+
+    // Room noise under everything, as a microphone hears it
+    static void addNoise(std::vector<int16_t>& samples, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::normal_distribution<float> noise(0.0f, 30.0f);
+        for (auto& x : samples) {
+            x = static_cast<int16_t>(std::clamp(x + noise(rng), -32767.0f, 32767.0f));
+        }
+    }
+
+    // A recording as a user would make one: the word with a little silence around it
+    static std::vector<int16_t> recording(const std::vector<Vowel>& word, float seconds, float f0, unsigned seed) {
+        std::vector<int16_t> out;
+        pause(out, 0.3f);
+        speak(out, word, seconds, f0, 3000.0f);
+        pause(out, 0.3f);
+        addNoise(out, seed);
+        return out;
+    }
+
+    static std::vector<std::string> writeRecordings(const std::string& name, const std::vector<Vowel>& word) {
+        std::vector<std::string> paths;
+        const float f0s[] = {110.0f, 125.0f, 140.0f};
+        const float lengths[] = {0.55f, 0.6f, 0.7f};
+        for (int i = 0; i < 3; ++i) {
+            auto samples = recording(word, lengths[i], f0s[i], 100 + i);
+            std::string path = "test_keyword_" + name + "_" + std::to_string(i) + ".wav";
+            if (jarvis::FileAudioSource::writeWav(path, samples.data(), samples.size(), kRate, 1)) {
+                paths.push_back(path);
+            }
+        }
+        return paths;
+    }
+
+    static void removeRecordings(const std::vector<std::string>& paths) {
+        for (const auto& path : paths) {
+            std::remove(path.c_str());
+        }
+    }
+
+    // Runs a stream through the spotter and records (keyword, time) per detection
+    struct Detection {
+        int keyword;
+        float seconds;
+    };
+
+    static std::vector<Detection> run(KeywordSpotter& spotter, const std::vector<int16_t>& stream) {
+        std::vector<Detection> detections;
+        const size_t hop = spotter.frameLength();
+        for (size_t i = 0; i + hop <= stream.size(); i += hop) {
+            int keyword = spotter.process(stream.data() + i);
+            if (keyword != KeywordSpotter::kNoKeyword) {
+                detections.push_back({keyword, static_cast<float>(i + hop) / kRate});
+            }
+        }
+        return detections;
+    }
+
+    static bool testDetectsEnrolledKeyword() {
+        std::cout << "Testing detection of an enrolled keyword..." << std::endl;
+
+        auto paths = writeRecordings("jarvis", jarvis());
+        KeywordSpotter spotter;
+        int index = spotter.enroll("jarvis", paths);
+        removeRecordings(paths);
+        if (index != 0) {
+            std::cout << "✗ Enrollment failed" << std::endl;
+            return false;
+        }
+
+        // The keyword said by a new voice at new speeds, between distractor words
+        std::vector<int16_t> stream;
+        std::vector<float> ends;
+        auto say = [&](const std::vector<Vowel>& word, float seconds, float f0, float level) {
+            speak(stream, word, seconds, f0, level);
+            if (&word == &jarvis()) {
+                ends.push_back(static_cast<float>(stream.size()) / kRate);
+            }
+            pause(stream, 0.8f);
+        };
+        pause(stream, 1.0f);
+        say(jarvis(), 0.6f, 118.0f, 3000.0f);
+        say(distractor(), 0.6f, 118.0f, 3000.0f);
+        say(jarvis(), 0.5f, 150.0f, 1500.0f);
+        say(otherDistractor(), 0.5f, 150.0f, 3000.0f);
+        say(stop(), 0.6f, 130.0f, 3000.0f);
+        say(jarvis(), 0.8f, 100.0f, 6000.0f);
+        addNoise(stream, 7);
+
+        auto detections = run(spotter, stream);
+        bool ok = detections.size() == ends.size();
+        for (size_t i = 0; ok && i < ends.size(); ++i) {
+            ok = detections[i].keyword == 0 && std::abs(detections[i].seconds - ends[i]) < 0.25f;
+        }
+
+        std::cout << (ok ? "✓ " : "✗ ") << detections.size() << " of " << ends.size()
+                  << " keywords detected, none on distractors (threshold " << spotter.threshold(0) << ")"
+                  << std::endl;
+        return ok;
+    }
+
+    static bool testRoutesByIndex() {
+        std::cout << "Testing several keywords in one spotter..." << std::endl;
+
+        KeywordSpotter spotter;
+        std::vector<std::vector<int16_t>> wake, halt;
+        for (unsigned i = 0; i < 3; ++i) {
+            wake.push_back(recording(jarvis(), 0.55f + 0.07f * i, 110.0f + 15.0f * i, 200 + i));
+            halt.push_back(recording(stop(), 0.45f + 0.07f * i, 110.0f + 15.0f * i, 300 + i));
+        }
+        bool ok = spotter.enroll("jarvis", wake) == 0 && spotter.enroll("stop", halt) == 1 &&
+                  spotter.keywordCount() == 2;
+
+        std::vector<int16_t> stream;
+        pause(stream, 0.5f);
+        speak(stream, stop(), 0.5f, 135.0f, 3000.0f);
+        pause(stream, 0.8f);
+        speak(stream, jarvis(), 0.6f, 135.0f, 3000.0f);
+        pause(stream, 0.8f);
+        addNoise(stream, 11);
+
+        auto detections = run(spotter, stream);
+        ok &= detections.size() == 2 && detections[0].keyword == 1 && detections[1].keyword == 0;
+
+        // A restarted stream scores from scratch
+        spotter.reset();
+        ok &= run(spotter, stream).size() == detections.size();
+
+        std::cout << (ok ? "✓ " : "✗ ") << "Each keyword reported by its own index" << std::endl;
+        return ok;
+    }
+
+    static bool testUnusableRecordings() {
+        std::cout << "Testing enrollment from unusable recordings..." << std::endl;
+
+        // Missing files and recordings too short to hold a word enroll nothing
+        KeywordSpotter spotter;
+        std::vector<int16_t> blip;
+        speak(blip, jarvis(), 0.05f, 120.0f, 3000.0f);
+        bool ok = spotter.enroll("missing", std::vector<std::string>{"no_such_keyword.wav"}) ==
+                      KeywordSpotter::kNoKeyword &&
+                  spotter.enroll("blip", std::vector<std::vector<int16_t>>{blip}) == KeywordSpotter::kNoKeyword &&
+                  spotter.keywordCount() == 0;
+
+        std::cout << (ok ? "✓ " : "✗ ") << "No keyword enrolled" << std::endl;
+        return ok;
+    }
+
+    // The detector the pipeline and the core build from a wake_word section
+    static std::string engineFromConfig(const nlohmann::json& wakeWord, size_t& keywords) {
+        const std::string path = "test_keyword_config.json";
+        std::ofstream(path) << nlohmann::json{{"wake_word", wakeWord}}.dump();
+        jarvis::ConfigManager config;
+        bool loaded = config.load(path);
+        std::remove(path.c_str());
+
+        WakeWordDetector detector;
+        if (!loaded || !detector.initialize(WakeWordDetector::readSettings(config))) {
+            return "none";
+        }
+        keywords = detector.getKeywords().size();
+        return detector.getEngineName();
+    }
+
+    static bool testSelectedFromConfig() {
+        std::cout << "Testing engine selection from the config..." << std::endl;
+
+        auto jarvisPaths = writeRecordings("jarvis", jarvis());
+        auto stopPaths = writeRecordings("stop", stop());
+        bool ok = true;
+
+        // The shipped section with only the wake word's recordings filled in
+        size_t keywords = 0;
+        nlohmann::json shipped = {{"engine", "auto"},
+                                  {"model_path", "models/porcupine_params.pv"},
+                                  {"keyword_path", "models/hey-jarvis.ppn"},
+                                  {"recordings", jarvisPaths},
+                                  {"keywords", nlohmann::json::array()}};
+        if (!jarvis::PorcupineEngine::available()) {
+            ok &= engineFromConfig(shipped, keywords) == std::string("builtin") && keywords == 1;
+        }
+        shipped["engine"] = "builtin";
+        ok &= engineFromConfig(shipped, keywords) == std::string("builtin") && keywords == 1;
+
+        // A keyword list replaces the single wake word
+        nlohmann::json list = {{"engine", "builtin"},
+                               {"keywords", {{{"name", "jarvis"}, {"recordings", jarvisPaths}},
+                                             {{"name", "stop"}, {"recordings", stopPaths}}}}};
+        ok &= engineFromConfig(list, keywords) == std::string("builtin") && keywords == 2;
+
+        // The built-in engine cannot run without recordings
+        shipped["recordings"] = nlohmann::json::array();
+        ok &= engineFromConfig(shipped, keywords) == std::string("none");
+
+        removeRecordings(jarvisPaths);
+        removeRecordings(stopPaths);
+        std::cout << (ok ? "✓ " : "✗ ") << "The configured recordings select the built-in engine" << std::endl;
+        return ok;
+    }
+};
+
+int main() {
+    std::cout << "=== Keyword Spotter Test ===" << std::endl;
+
+    bool ok = SimpleKeywordSpotterTest::testDetectsEnrolledKeyword();
+    ok &= SimpleKeywordSpotterTest::testRoutesByIndex();
+    ok &= SimpleKeywordSpotterTest::testUnusableRecordings();
+    ok &= SimpleKeywordSpotterTest::testSelectedFromConfig();
+
+    std::cout << "=== Test Complete ===" << std::endl;
+    return ok ? 0 : 1;
+}
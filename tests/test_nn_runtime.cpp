@@ -0,0 +1,242 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include "nn/model.h"
+#include "nn/session.h"
+
+using jarvis::nn::Model;
+using jarvis::nn::ModelWriter;
+using jarvis::nn::Session;
+
+class SimpleNnRuntimeTest {
+public:
+    static std::vector<float> randomFloats(size_t n, float range, std::mt19937& rng) {
+        std::uniform_real_distribution<float> value(-range, range);
+        std::vector<float> v(n);
+        for (auto& x : v) {
+            x = value(rng);
+        }
+        return v;
+    }
+
+    static float sigmoid(float x) { return 1.0f / (1.0f + std::exp(-x)); }
+
+    // The float network the file is quantized from, stepped the same way
+    struct Reference {
+        size_t inputs = 12, channels = 24, kernel = 3, hidden = 20, outputs = 4;
+        std::vector<float> conv, convBias, wx, wh, bx, bh, dense, denseBias;
+        std::vector<float> window, h;
+
+        explicit Reference(std::mt19937& rng) {
+            conv = randomFloats(channels * kernel * inputs, 0.3f, rng);
+            convBias = randomFloats(channels, 0.1f, rng);
+            wx = randomFloats(3 * hidden * channels, 0.3f, rng);
+            wh = randomFloats(3 * hidden * hidden, 0.3f, rng);
+            bx = randomFloats(3 * hidden, 0.1f, rng);
+            bh = randomFloats(3 * hidden, 0.1f, rng);
+            dense = randomFloats(outputs * hidden, 0.5f, rng);
+            denseBias = randomFloats(outputs, 0.1f, rng);
+            reset();
+        }
+
+        void reset() {
+            window.assign(kernel * inputs, 0.0f);
+            h.assign(hidden, 0.0f);
+        }
+
+        ModelWriter writer() const {
+            ModelWriter writer(inputs);
+            writer.addConv1d(channels, kernel, conv, convBias, Model::Activation::Relu);
+            writer.addGru(hidden, wx, wh, bx, bh);
+            writer.addDense(outputs, dense, denseBias, Model::Activation::Sigmoid);
+            return writer;
+        }
+
+        std::vector<float> step(const float* x) {
+            std::rotate(window.begin(), window.begin() + inputs, window.end());
+            std::copy(x, x + inputs, window.end() - inputs);
+            std::vector<float> c(channels);
+            for (size_t o = 0; o < channels; ++o) {
+                float sum = convBias[o];
+                for (size_t k = 0; k < window.size(); ++k) {
+                    sum += conv[o * window.size() + k] * window[k];
+                }
+                c[o] = std::max(sum, 0.0f);
+            }
+
+            std::vector<float> gx(3 * hidden), gh(3 * hidden);
+            for (size_t r = 0; r < 3 * hidden; ++r) {
+                gx[r] = bx[r];
+                gh[r] = bh[r];
+                for (size_t k = 0; k < channels; ++k) gx[r] += wx[r * channels + k] * c[k];
+                for (size_t k = 0; k < hidden; ++k) gh[r] += wh[r * hidden + k] * h[k];
+            }
+            for (size_t i = 0; i < hidden; ++i) {
+                float r = sigmoid(gx[i] + gh[i]);
+                float z = sigmoid(gx[hidden + i] + gh[hidden + i]);
+                float n = std::tanh(gx[2 * hidden + i] + r * gh[2 * hidden + i]);
+                h[i] = (1.0f - z) * n + z * h[i];
+            }
+
+            std::vector<float> y(outputs);
+            for (size_t o = 0; o < outputs; ++o) {
+                float sum = denseBias[o];
+                for (size_t k = 0; k < hidden; ++k) sum += dense[o * hidden + k] * h[k];
+                y[o] = sigmoid(sum);
+            }
+            return y;
+        }
+    };
+
+    static bool testMatchesFloat() {
+        std::cout << "Testing int8 inference against the float network..." << std::endl;
+
+        std::mt19937 rng(5);
+        Reference reference(rng);
+        const char* path = "test_nn_runtime.jnn";
+        Model model;
+        bool ok = reference.writer().save(path) && model.load(path);
+        if (!ok) {
+            std::cout << "✗ Failed to write or map " << path << std::endl;
+            return false;
+        }
+        ok &= model.inputSize() == 12 && model.outputSize() == 4 && model.layers().size() == 3 &&
+              model.layers()[0].type == Model::LayerType::Conv1d && model.layers()[1].type == Model::LayerType::Gru &&
+              model.layers()[1].macs() == 60 * 24 + 60 * 20;
+
+        // A hundred steps, long enough for the GRU state to carry quantization error along
+        Session session(model);
+        session.setTiming(true);
+        float worst = 0.0f;
+        for (int t = 0; t < 100; ++t) {
+            auto x = randomFloats(12, 1.0f, rng);
+            auto expected = reference.step(x.data());
+            const float* y = session.process(x.data());
+            for (size_t o = 0; o < 4; ++o) {
+                worst = std::max(worst, std::abs(y[o] - expected[o]));
+            }
+        }
+        ok &= worst < 0.02f;
+
+        for (const auto& timing : session.timings()) {
+            ok &= timing.steps == 100 && timing.totalUs > 0.0;
+        }
+        std::remove(path);
+
+        std::cout << (ok ? "✓ " : "✗ ") << "Outputs within " << worst << " of float over 100 steps" << std::endl;
+        return ok;
+    }
+
+    static bool testReset() {
+        std::cout << "Testing stream reset..." << std::endl;
+
+        std::mt19937 rng(9);
+        Reference reference(rng);
+        const char* path = "test_nn_runtime_reset.jnn";
+        Model model;
+        bool ok = reference.writer().save(path) && model.load(path);
+        std::remove(path);
+
+        // Conv history and GRU state are per session and cleared by reset()
+        auto inputs = randomFloats(12 * 20, 1.0f, rng);
+        Session first(model), second(model);
+        std::vector<float> a, b;
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int t = 0; t < 20; ++t) {
+                const float* y = first.process(inputs.data() + 12 * t);
+                (pass == 0 ? a : b).insert((pass == 0 ? a : b).end(), y, y + 4);
+                second.process(inputs.data() + 12 * (19 - t));
+            }
+            first.reset();
+        }
+        ok &= a == b;
+
+        std::cout << (ok ? "✓ " : "✗ ") << "Same outputs after reset, sessions independent" << std::endl;
+        return ok;
+    }
+
+    static bool testMalformedFiles() {
+        std::cout << "Testing malformed model files..." << std::endl;
+
+        std::mt19937 rng(13);
+        Reference reference(rng);
+        const char* path = "test_nn_runtime_bad.jnn";
+        bool ok = reference.writer().save(path);
+
+        std::vector<char> bytes;
+        if (FILE* in = std::fopen(path, "rb")) {
+            char buffer[4096];
+            for (size_t n; (n = std::fread(buffer, 1, sizeof(buffer), in)) > 0;) {
+                bytes.insert(bytes.end(), buffer, buffer + n);
+            }
+            std::fclose(in);
+        }
+        if (!ok || bytes.size() < sizeof(Model::FileHeader) + sizeof(Model::LayerRecord)) {
+            std::cout << "✗ Failed to write " << path << std::endl;
+            return false;
+        }
+        auto rejects = [&](std::vector<char> file) {
+            FILE* out = std::fopen(path, "wb");
+            std::fwrite(file.data(), 1, file.size(), out);
+            std::fclose(out);
+            Model model;
+            return !model.load(path) && !model.isLoaded();
+        };
+
+        // Truncated, wrong magic, a -128 weight, a layer fed the wrong size, sizes that overflow
+        ok &= rejects(std::vector<char>(bytes.begin(), bytes.end() - 64));
+        auto magic = bytes;
+        magic[0] = 'X';
+        ok &= rejects(magic);
+        Model::LayerRecord record;
+        std::memcpy(&record, bytes.data() + sizeof(Model::FileHeader), sizeof(record));
+        auto weight = bytes;
+        weight[record.weightsOffset] = -128;
+        ok &= rejects(weight);
+        auto sizes = bytes;
+        record.inputSize = 11;
+        std::memcpy(sizes.data() + sizeof(Model::FileHeader), &record, sizeof(record));
+        ok &= rejects(sizes);
+
+        // A lone conv layer whose 4 x 2^31 x 2^31 weight count wraps to zero bytes
+        auto overflow = bytes;
+        Model::FileHeader header;
+        std::memcpy(&header, overflow.data(), sizeof(header));
+        header.layerCount = 1;
+        header.inputSize = 1u << 31;
+        std::memcpy(overflow.data(), &header, sizeof(header));
+        record.type = static_cast<uint32_t>(Model::LayerType::Conv1d);
+        record.inputSize = 1u << 31;
+        record.kernelSize = 1u << 31;
+        record.outputSize = 4;
+        std::memcpy(overflow.data() + sizeof(Model::FileHeader), &record, sizeof(record));
+        ok &= rejects(overflow);
+
+        // Weights that do not match the layer are refused before anything is written
+        ModelWriter writer(4);
+        writer.addDense(2, std::vector<float>(7), std::vector<float>(2));
+        ok &= !writer.save(path);
+
+        Model missing;
+        ok &= !missing.load("no_such_model.jnn");
+        std::remove(path);
+
+        std::cout << (ok ? "✓ " : "✗ ") << "Every malformed file rejected" << std::endl;
+        return ok;
+    }
+};
+
+int main() {
+    std::cout << "=== NN Runtime Test ===" << std::endl;
+
+    bool ok = SimpleNnRuntimeTest::testMatchesFloat();
+    ok &= SimpleNnRuntimeTest::testReset();
+    ok &= SimpleNnRuntimeTest::testMalformedFiles();
+
+    std::cout << "=== Test Complete ===" << std::endl;
+    return ok ? 0 : 1;
+}
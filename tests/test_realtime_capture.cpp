@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "audio/audio_broadcast_buffer.h"
+#include "audio/audio_capture.h"
+#include "audio/audio_player.h"
+#include "audio/audio_source.h"
+#include "audio/realtime_capture_queue.h"
+
+// Count every heap allocation made while a thread is marked as real-time
+static thread_local bool inRealTimeCallback = false;
+static std::atomic<int> realTimeAllocations{0};
+
+void* operator new(std::size_t size) {
+    if (inRealTimeCallback) {
+        realTimeAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// GCC can't see that the replacement operator new above uses malloc
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// A tone whose reading thread is marked real-time between reads, so the
+// render and capture work AudioCapture does after each read is counted
+class RealTimeToneSource : public jarvis::AudioSource {
+public:
+    RealTimeToneSource(size_t blocks, size_t framesPerBuffer)
+        : tone_(16000, 1, 440.0, 0.3), framesLeft_(blocks * framesPerBuffer) {}
+
+    int getSampleRate() const override { return tone_.getSampleRate(); }
+    int getChannels() const override { return tone_.getChannels(); }
+
+    size_t read(int16_t* buffer, size_t frames) override {
+        inRealTimeCallback = false;
+        size_t n = tone_.read(buffer, std::min(frames, framesLeft_));
+        framesLeft_ -= n;
+        inRealTimeCallback = n > 0;
+        return n;
+    }
+
+private:
+    jarvis::ToneSource tone_;
+    size_t framesLeft_;
+};
+
+class SimpleRealTimeCaptureTest {
+public:
+    static bool testCaptureCallbackDoesNotAllocate() {
+        std::cout << "Testing the capture callback with a player attached for allocations..." << std::endl;
+
+        // 64-frame blocks at 16 kHz: 300 blocks take about 1.2 s in real time
+        const size_t framesPerBuffer = 64;
+        const size_t blocks = 300;
+        jarvis::AudioCapture capture;
+        capture.setSource(std::make_unique<RealTimeToneSource>(blocks, framesPerBuffer),
+                          jarvis::SourcePacing::RealTime);
+        capture.setCaptureMode(jarvis::CaptureMode::RealTimeSafe);
+        capture.initialize(16000, 1, framesPerBuffer);
+
+        // Played audio is rendered and written to the output history on the source thread
+        jarvis::AudioPlayer player;
+        player.initialize(16000, 1, framesPerBuffer);
+        jarvis::AudioBroadcastBuffer* history = player.enableOutputHistory(16000);
+        capture.attachPlayer(&player);
+        player.start();
+        for (int i = 0; i < 16; ++i) {
+            player.enqueue(std::vector<int16_t>(800, static_cast<int16_t>(i + 1)));
+        }
+
+        std::atomic<size_t> delivered{0};
+        capture.startCapture([&](const std::vector<int16_t>& block) { delivered += block.size(); });
+
+        // More chunks and a stop arrive while it runs, as they would mid-response
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        for (int i = 0; i < 8; ++i) {
+            player.enqueue(std::vector<int16_t>(800, 100));
+        }
+        player.stopAt(player.getOutputPosition() + 4000);
+        player.enqueue(std::vector<int16_t>(800, 200));
+
+        while (capture.isRunning()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        capture.stopCapture();
+        uint64_t rendered = player.getOutputPosition();
+        uint64_t recorded = history ? history->writePosition() : 0;
+        player.stop();
+
+        int allocations = realTimeAllocations.load();
+        bool ran = delivered == blocks * framesPerBuffer && rendered == blocks * framesPerBuffer &&
+                   recorded == rendered;
+        if (allocations == 0 && ran) {
+            std::cout << "✓ " << blocks << " blocks rendered, recorded and captured without allocating"
+                      << std::endl;
+        } else {
+            std::cout << "✗ " << allocations << " allocation(s); delivered " << delivered << ", rendered "
+                      << rendered << ", recorded " << recorded << " of " << blocks * framesPerBuffer
+                      << " samples" << std::endl;
+        }
+        return allocations == 0 && ran;
+    }
+
+    static void testCallbackDoesNotAllocate() {
+        std::cout << "Testing real-time callback path for allocations..." << std::endl;
+
+        const size_t framesPerBuffer = 256;
+        const size_t blocks = 2000;
+        jarvis::RealTimeCaptureQueue queue(16000 * 2);
+
+        std::atomic<bool> delivering{true};
+        std::atomic<size_t> delivered{0};
+        std::thread delivery([&]() {
+            std::vector<int16_t> block(framesPerBuffer);
+            while (delivering || queue.available() > 0) {
+                queue.waitForData(std::chrono::milliseconds(10));
+                while (queue.available() >= block.size()) {
+                    delivered += queue.pop(block.data(), block.size());
+                }
+            }
+        });
+
+        // Stand-in for the PortAudio callback thread
+        std::thread device([&]() {
+            std::vector<int16_t> input(framesPerBuffer, 100);
+            inRealTimeCallback = true;
+            for (size_t i = 0; i < blocks; ++i) {
+                queue.push(input.data(), input.size());
+                if (i % 16 == 0) {
+                    std::this_thread::yield();
+                }
+            }
+            inRealTimeCallback = false;
+        });
+
+        device.join();
+        delivering = false;
+        queue.interrupt();
+        delivery.join();
+
+        int allocations = realTimeAllocations.load();
+        if (allocations == 0) {
+            std::cout << "✓ No heap allocations on the callback thread" << std::endl;
+        } else {
+            std::cout << "✗ Callback thread allocated " << allocations << " times" << std::endl;
+        }
+
+        size_t expected = framesPerBuffer * blocks - queue.droppedSamples();
+        if (delivered == expected) {
+            std::cout << "✓ Delivered " << delivered << " samples ("
+                      << queue.droppedSamples() << " dropped)" << std::endl;
+        } else {
+            std::cout << "✗ Delivered " << delivered << " of " << expected << " samples" << std::endl;
+        }
+    }
+
+    static void testOverflowIsCounted() {
+        std::cout << "Testing overflow accounting..." << std::endl;
+
+        jarvis::RealTimeCaptureQueue queue(1024);
+        std::vector<int16_t> input(512, 1);
+
+        inRealTimeCallback = true;
+        for (int i = 0; i < 4; ++i) {
+            queue.push(input.data(), input.size());
+        }
+        queue.recordDeviceOverflow();
+        inRealTimeCallback = false;
+
+        if (queue.droppedSamples() == 1024 && queue.deviceOverflows() == 1) {
+            std::cout << "✓ Dropped samples and device overflows counted" << std::endl;
+        } else {
+            std::cout << "✗ Unexpected counters (dropped=" << queue.droppedSamples()
+                      << ", overflows=" << queue.deviceOverflows() << ")" << std::endl;
+        }
+    }
+
+    static void testTimestampsSurviveDrops() {
+        std::cout << "Testing frame indices across dropped blocks..." << std::endl;
+
+        jarvis::RealTimeCaptureQueue queue(1024, 2, 16000);
+        std::vector<int16_t> input(512, 1);
+        auto t0 = std::chrono::steady_clock::now();
+
+        inRealTimeCallback = true;
+        queue.push(input.data(), input.size(), t0);
+        queue.push(input.data(), input.size(), t0 + std::chrono::milliseconds(16));
+        queue.push(input.data(), input.size(), t0 + std::chrono::milliseconds(32)); // dropped
+        inRealTimeCallback = false;
+
+        std::vector<int16_t> output(512);
+        jarvis::AudioTimestamp first, second, third;
+        queue.pop(output.data(), 512, &first);
+        queue.pop(output.data(), 256, &second);
+        queue.pop(output.data(), 256, &third);
+
+        inRealTimeCallback = true;
+        queue.push(input.data(), input.size(), t0 + std::chrono::milliseconds(48));
+        inRealTimeCallback = false;
+        jarvis::AudioTimestamp fourth;
+        queue.pop(output.data(), 512, &fourth);
+
+        // 256 stereo frames per block; the third block's frames are skipped, not reused
+        bool ok = first.frameIndex == 0 && first.captureTime == t0 &&
+                  second.frameIndex == 256 && third.frameIndex == 384 &&
+                  third.captureTime == t0 + std::chrono::milliseconds(24) &&
+                  fourth.frameIndex == 768;
+        if (ok) {
+            std::cout << "✓ Popped blocks carry exact frame indices and capture times" << std::endl;
+        } else {
+            std::cout << "✗ Unexpected frame indices " << first.frameIndex << ", " << second.frameIndex
+                      << ", " << third.frameIndex << ", " << fourth.frameIndex << std::endl;
+        }
+    }
+};
+
+int main() {
+    std::cout << "=== Real-Time Capture Test ===" << std::endl;
+
+    SimpleRealTimeCaptureTest::testCallbackDoesNotAllocate();
+    bool ok = SimpleRealTimeCaptureTest::testCaptureCallbackDoesNotAllocate();
+    SimpleRealTimeCaptureTest::testOverflowIsCounted();
+    SimpleRealTimeCaptureTest::testTimestampsSurviveDrops();
+
+    std::cout << "=== Test Complete ===" << std::endl;
+    return ok && realTimeAllocations.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <numbers>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include "audio/spectral_features.h"
+
+using jarvis::SpectralFeatures;
+
+class SimpleSpectralFeaturesTest {
+public:
+    static constexpr int kRate = 16000;
+
+    static std::vector<float> randomSignal(size_t n, std::mt19937& rng) {
+        std::uniform_real_distribution<float> value(-0.5f, 0.5f);
+        std::vector<float> x(n);
+        for (auto& v : x) {
+            v = value(rng);
+        }
+        return x;
+    }
+
+    static bool sameFrame(const SpectralFeatures::Frame& a, const SpectralFeatures::Frame& b) {
+        return a.index == b.index && a.endPosition == b.endPosition && a.power == b.power && a.logMel == b.logMel;
+    }
+
+    static bool testLayout() {
+        std::cout << "Testing the frame layout..." << std::endl;
+
+        SpectralFeatures features(kRate);
+        bool ok = features.windowSize() == 400 && features.hopSize() == 160 && features.fftSize() == 512 &&
+                  features.numBins() == 257 && features.numMels() == 40 && features.capacity() >= 500;
+
+        // The first frame completes with the first full window, then one per hop
+        std::vector<float> x(399, 0.0f);
+        ok &= features.process(x) == 0 && features.framesWritten() == 0;
+        x.assign(1 + 160 * 3, 0.0f);
+        ok &= features.process(x) == 4 && features.framesWritten() == 4;
+        ok &= features.endPosition(0) == 400 && features.endPosition(3) == 880;
+
+        uint64_t index = 0;
+        ok &= !features.frameEndingBy(399, index);
+        ok &= features.frameEndingBy(400, index) && index == 0;
+        ok &= features.frameEndingBy(879, index) && index == 2;
+        ok &= features.frameEndingBy(880, index) && index == 3;
+
+        std::cout << (ok ? "✓ " : "✗ ") << "25 ms windows every 10 ms, on the input timeline" << std::endl;
+        return ok;
+    }
+
+    static bool testBlockSizes() {
+        std::cout << "Testing block size independence..." << std::endl;
+
+        std::mt19937 rng(3);
+        auto x = randomSignal(kRate, rng);
+        SpectralFeatures whole(kRate), split(kRate);
+        whole.process(x);
+        for (size_t i = 0; i < x.size();) {
+            size_t n = std::min<size_t>(1 + (i * 7) % 333, x.size() - i);
+            split.process(std::span<const float>(x.data() + i, n));
+            i += n;
+        }
+
+        bool ok = whole.framesWritten() == split.framesWritten() && whole.framesWritten() == 98;
+        SpectralFeatures::Frame a, b;
+        for (uint64_t k = 0; k < whole.framesWritten(); ++k) {
+            ok &= whole.read(k, a) && split.read(k, b) && sameFrame(a, b);
+        }
+        std::cout << (ok ? "✓ " : "✗ ") << "Identical frames from any split of the input" << std::endl;
+        return ok;
+    }
+
+    static bool testTone() {
+        std::cout << "Testing a tone..." << std::endl;
+
+        // 1 kHz lands in bin 32 of 512 and in the mel filter centred nearest it
+        std::vector<float> x(kRate / 2);
+        for (size_t i = 0; i < x.size(); ++i) {
+            x[i] = 0.5f * static_cast<float>(std::sin(2.0 * std::numbers::pi * 1000.0 * i / kRate));
+        }
+        SpectralFeatures features(kRate);
+        features.process(x);
+        SpectralFeatures::Frame frame;
+        bool ok = features.read(features.framesWritten() - 1, frame);
+        size_t peakBin = std::max_element(frame.power.begin(), frame.power.end()) - frame.power.begin();
+        size_t peakMel = std::max_element(frame.logMel.begin(), frame.logMel.end()) - frame.logMel.begin();
+
+        const auto& bank = features.filterbank();
+        size_t expectedMel = 0;
+        float bestWeight = 0.0f;
+        for (size_t m = 0; m < bank.numMels(); ++m) {
+            size_t first = bank.firstBin(m);
+            if (32 >= first && 32 < first + bank.weights(m).size() && bank.weights(m)[32 - first] > bestWeight) {
+                bestWeight = bank.weights(m)[32 - first];
+                expectedMel = m;
+            }
+        }
+        ok &= peakBin == 32 && peakMel == expectedMel;
+
+        // Silence sits at the log floor, not at minus infinity
+        std::vector<float> silence(kRate / 10, 0.0f);
+        features.process(silence);
+        ok &= features.read(features.framesWritten() - 1, frame) &&
+              std::all_of(frame.logMel.begin(), frame.logMel.end(), [](float v) { return std::isfinite(v); });
+
+        std::cout << (ok ? "✓ " : "✗ ") << "Peak bin " << peakBin << ", peak mel " << peakMel << std::endl;
+        return ok;
+    }
+
+    static bool testOverwrite() {
+        std::cout << "Testing readers that fall behind..." << std::endl;
+
+        SpectralFeatures::Params params;
+        params.historyMs = 200;
+        SpectralFeatures features(kRate, params);
+        std::mt19937 rng(4);
+        features.process(randomSignal(kRate, rng));
+
+        SpectralFeatures::Frame frame;
+        uint64_t oldest = features.oldestFrame();
+        bool ok = features.capacity() == 32 && oldest == features.framesWritten() - 32;
+        ok &= !features.read(oldest - 1, frame) && features.read(oldest, frame);
+        ok &= !features.read(features.framesWritten(), frame);
+
+        std::cout << (ok ? "✓ " : "✗ ") << "Overwritten and future frames are refused" << std::endl;
+        return ok;
+    }
+
+    static bool testConcurrentReader() {
+        std::cout << "Testing a reader racing the writer..." << std::endl;
+
+        // Every frame a reader accepts must be the frame the writer published,
+        // even with a ring small enough that it is overwritten under the reader
+        std::mt19937 rng(5);
+        auto x = randomSignal(kRate * 20, rng);
+        SpectralFeatures::Params params;
+        params.historyMs = 20000;
+        SpectralFeatures reference(kRate, params);
+        reference.process(x);
+
+        params.historyMs = 50;
+        SpectralFeatures features(kRate, params);
+        std::atomic<bool> done{false};
+        std::thread writer([&]() {
+            for (size_t i = 0; i < x.size(); i += 160) {
+                features.process(std::span<const float>(x.data() + i, 160));
+            }
+            done = true;
+        });
+
+        uint64_t accepted = 0, refused = 0, wrong = 0;
+        SpectralFeatures::Frame frame, expected;
+        while (!done) {
+            uint64_t written = features.framesWritten();
+            uint64_t index = written > 3 ? written - 3 : 0;
+            if (features.read(index, frame)) {
+                ++accepted;
+                wrong += !reference.read(index, expected) || !sameFrame(frame, expected);
+            } else {
+                ++refused;
+            }
+        }
+        writer.join();
+
+        std::cout << "  " << accepted << " frames read, " << refused << " refused, " << wrong << " wrong" << std::endl;
+        bool ok = wrong == 0 && accepted > 0;
+        std::cout << (ok ? "✓ " : "✗ ") << "No torn frames" << std::endl;
+        return ok;
+    }
+};
+
+int main() {
+    std::cout << "=== Spectral Features Test ===" << std::endl;
+
+    bool ok = SimpleSpectralFeaturesTest::testLayout();
+    ok &= SimpleSpectralFeaturesTest::testBlockSizes();
+    ok &= SimpleSpectralFeaturesTest::testTone();
+    ok &= SimpleSpectralFeaturesTest::testOverwrite();
+    ok &= SimpleSpectralFeaturesTest::testConcurrentReader();
+
+    std::cout << "=== Test Complete ===" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,321 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <numbers>
+#include <algorithm>
+#include "audio/voice_activity_detector.h"
+#include "audio/spectral_features.h"
+
+using jarvis::SpectralFeatures;
+using jarvis::VoiceActivityDetector;
+
+class SimpleVoiceActivityDetectorTest {
+public:
+    static constexpr int kRate = 16000;
+    static constexpr size_t kBlock = 160;
+
+    static std::vector<int16_t> toPcm(const std::vector<double>& x) {
+        std::vector<int16_t> pcm(x.size());
+        for (size_t i = 0; i < x.size(); ++i) {
+            pcm[i] = static_cast<int16_t>(std::clamp(std::lround(x[i] * 32768.0), -32768L, 32767L));
+        }
+        return pcm;
+    }
+
+    // Fan rumble: low-passed noise with mains hum, at a given RMS
+    static std::vector<double> hvacNoise(double seconds, double rms, std::mt19937& rng) {
+        std::normal_distribution<double> white(0.0, 1.0);
+        size_t n = static_cast<size_t>(seconds * kRate);
+        std::vector<double> x(n);
+        double low = 0.0, lower = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            low += 0.08 * (white(rng) - low);
+            lower += 0.08 * (low - lower);
+            x[i] = lower + 0.02 * white(rng) + 0.1 * std::sin(2.0 * std::numbers::pi * 120.0 * i / kRate);
+        }
+        scale(x, rms);
+        return x;
+    }
+
+    static std::vector<double> whiteNoise(double seconds, double rms, std::mt19937& rng) {
+        std::normal_distribution<double> white(0.0, rms);
+        std::vector<double> x(static_cast<size_t>(seconds * kRate));
+        for (auto& v : x) {
+            v = white(rng);
+        }
+        return x;
+    }
+
+    // Voiced syllables: a gliding harmonic series shaped by two formants,
+    // four syllables a second with short gaps. active[i] marks the syllables.
+    static std::vector<double> speech(double seconds, double rms, std::vector<bool>& active) {
+        size_t n = static_cast<size_t>(seconds * kRate);
+        std::vector<double> x(n);
+        active.assign(n, false);
+        double phase = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            double t = static_cast<double>(i) / kRate;
+            double syllable = std::fmod(t, 0.25) / 0.25;
+            if (syllable > 0.8) {
+                continue;
+            }
+            double envelope = std::sin(std::numbers::pi * syllable / 0.8);
+            double f0 = 120.0 + 30.0 * std::sin(2.0 * std::numbers::pi * 1.3 * t);
+            phase += 2.0 * std::numbers::pi * f0 / kRate;
+            double sample = 0.0;
+            for (int h = 1; h * f0 < 4000.0; ++h) {
+                double f = h * f0;
+                double formants = 1.0 / (1.0 + std::pow((f - 600.0) / 200.0, 2)) +
+                                  0.5 / (1.0 + std::pow((f - 1700.0) / 300.0, 2));
+                sample += (formants + 0.05) * std::sin(h * phase) / h;
+            }
+            x[i] = envelope * sample;
+            active[i] = envelope > 0.3;
+        }
+        scale(x, rms);
+        return x;
+    }
+
+    static void scale(std::vector<double>& x, double rms) {
+        double sum = 0.0;
+        for (double v : x) {
+            sum += v * v;
+        }
+        double current = std::sqrt(sum / std::max<size_t>(1, x.size()));
+        for (auto& v : x) {
+            v *= rms / std::max(current, 1e-12);
+        }
+    }
+
+    static void add(std::vector<double>& into, const std::vector<double>& x, size_t at) {
+        for (size_t i = 0; i < x.size() && at + i < into.size(); ++i) {
+            into[at + i] += x[i];
+        }
+    }
+
+    struct Trace {
+        std::vector<bool> speech;       // per block
+        std::vector<bool> voiceActive;  // processFrame() result per block
+    };
+
+    // With shared set, spectra come from an STFT stage fed alongside, as in the pipeline
+    static Trace run(VoiceActivityDetector& vad, const std::vector<int16_t>& pcm, bool shared = false) {
+        SpectralFeatures features(kRate);
+        if (shared) {
+            vad.useSharedSpectrum(features);
+        }
+        std::vector<float> samples(kBlock), power(features.numBins());
+        Trace trace;
+        for (size_t i = 0; i + kBlock <= pcm.size(); i += kBlock) {
+            bool active = false;
+            if (!shared) {
+                active = vad.processFrame(pcm.data() + i, kBlock);
+            } else {
+                for (size_t j = 0; j < kBlock; ++j) {
+                    samples[j] = pcm[i + j] / 32768.0f;
+                }
+                features.process(samples);
+                uint64_t index = 0;
+                if (features.frameEndingBy(i + kBlock, index) && features.readPower(index, power.data())) {
+                    active = vad.processSpectrum(pcm.data() + i, kBlock, power.data());
+                }
+            }
+            trace.voiceActive.push_back(active);
+            trace.speech.push_back(vad.getFeatures().speech);
+        }
+        return trace;
+    }
+
+    // Fraction of blocks in [from, to) seconds flagged as speech, optionally only where mask is set
+    static double speechFraction(const Trace& trace, double from, double to,
+                                 const std::vector<bool>* mask = nullptr, size_t maskOffset = 0) {
+        size_t hits = 0, total = 0;
+        for (size_t b = static_cast<size_t>(from * kRate / kBlock);
+             b < std::min(trace.speech.size(), static_cast<size_t>(to * kRate / kBlock)); ++b) {
+            if (mask) {
+                size_t sample = b * kBlock + kBlock / 2;
+                if (sample < maskOffset || sample - maskOffset >= mask->size() || !(*mask)[sample - maskOffset]) {
+                    continue;
+                }
+            }
+            hits += trace.speech[b];
+            ++total;
+        }
+        return total ? static_cast<double>(hits) / total : 0.0;
+    }
+
+    static bool testStationaryNoise() {
+        std::cout << "Testing rejection of steady noise..." << std::endl;
+
+        // Both well above the old fixed 0.01 RMS threshold
+        std::mt19937 rng(1);
+        bool ok = true;
+        for (bool shared : {false, true}) {
+            for (int kind = 0; kind < 2; ++kind) {
+                auto noise = kind == 0 ? hvacNoise(6.0, 0.05, rng) : whiteNoise(6.0, 0.03, rng);
+                VoiceActivityDetector vad(kRate);
+                Trace trace = run(vad, toPcm(noise), shared);
+                double falseRate = speechFraction(trace, 1.5, 6.0);
+                bool ended = !trace.voiceActive.back();
+                std::cout << "  " << (shared ? "shared STFT, " : "") << (kind == 0 ? "fan rumble" : "white noise")
+                          << ": speech in " << falseRate * 100.0 << "% of frames after adapting, "
+                          << (ended ? "no voice" : "voice still active") << " at the end" << std::endl;
+                ok &= falseRate < 0.05 && ended;
+            }
+        }
+        std::cout << (ok ? "✓ " : "✗ ") << "Steady noise is learned as the floor" << std::endl;
+        return ok;
+    }
+
+    static bool testSpeechInNoise() {
+        std::cout << "Testing speech over noise..." << std::endl;
+
+        std::mt19937 rng(2);
+        bool ok = true;
+        for (bool shared : {false, true}) {
+            for (double snrDb : {20.0, 10.0, 5.0}) {
+                auto signal = hvacNoise(7.0, 0.03, rng);
+                std::vector<bool> active;
+                auto voice = speech(2.0, 0.03 * std::pow(10.0, snrDb / 20.0), active);
+                add(signal, voice, 3 * kRate);
+
+                VoiceActivityDetector vad(kRate);
+                vad.setSilenceTimeout(500);
+                Trace trace = run(vad, toPcm(signal), shared);
+                double hitRate = speechFraction(trace, 3.0, 5.0, &active, 3 * kRate);
+                double falseRate = speechFraction(trace, 1.5, 3.0) + speechFraction(trace, 5.3, 7.0);
+                bool activeDuring = trace.voiceActive[static_cast<size_t>(4.5 * kRate / kBlock)];
+                bool endedAfter = !trace.voiceActive.back();
+                std::cout << "  " << (shared ? "shared STFT, " : "") << snrDb << " dB SNR: syllables detected "
+                          << hitRate * 100.0 << "%, noise flagged " << falseRate * 100.0 << "%" << std::endl;
+                ok &= hitRate > (snrDb > 6.0 ? 0.9 : 0.7) && falseRate < 0.1 && activeDuring && endedAfter;
+            }
+        }
+        std::cout << (ok ? "✓ " : "✗ ") << "Syllables detected, the utterance ends in the noise after it" << std::endl;
+        return ok;
+    }
+
+    static bool testNoiseStep() {
+        std::cout << "Testing a rise in the noise level..." << std::endl;
+
+        // The fan turns on two seconds in, 30 dB louder than the room
+        std::mt19937 rng(3);
+        auto signal = whiteNoise(2.0, 0.003, rng);
+        auto fan = hvacNoise(4.0, 0.1, rng);
+        signal.resize(signal.size() + fan.size(), 0.0);
+        add(signal, fan, 2 * kRate);
+
+        VoiceActivityDetector vad(kRate);
+        Trace trace = run(vad, toPcm(signal));
+        double settled = speechFraction(trace, 4.0, 6.0);
+        auto floors = vad.getNoiseFloorDb();
+        bool floorRose = *std::max_element(floors.begin(), floors.end()) > -40.0f;
+        std::cout << "  speech in " << settled * 100.0 << "% of frames once adapted, loudest band floor "
+                  << *std::max_element(floors.begin(), floors.end()) << " dB" << std::endl;
+
+        bool ok = settled < 0.05 && floorRose;
+        std::cout << (ok ? "✓ " : "✗ ") << "The floor follows the noise up within the window" << std::endl;
+        return ok;
+    }
+
+    static bool testGateAndBlockSizes() {
+        std::cout << "Testing the level gate and block sizes..." << std::endl;
+
+        bool ok = true;
+        VoiceActivityDetector::Params params;
+        params.minRms = 0.05f;
+        VoiceActivityDetector quiet(kRate, params);
+        std::vector<bool> active;
+        auto pcm = toPcm(speech(1.0, 0.02, active));
+        ok &= !quiet.processFrame(pcm.data(), pcm.size()) && quiet.getSpeechProbability() == 0.0f;
+
+        // Analysis frames span blocks, so any split gives the same decisions
+        std::mt19937 rng(4);
+        auto signal = hvacNoise(3.0, 0.01, rng);
+        add(signal, speech(1.0, 0.05, active), kRate);
+        pcm = toPcm(signal);
+        VoiceActivityDetector whole(kRate), split(kRate);
+        whole.processFrame(pcm.data(), pcm.size());
+        for (size_t i = 0; i < pcm.size();) {
+            size_t n = std::min<size_t>(1 + i % 701, pcm.size() - i);
+            split.processFrame(pcm.data() + i, n);
+            i += n;
+        }
+        ok &= whole.getSpeechProbability() == split.getSpeechProbability() &&
+              whole.getNoiseFloorDb() == split.getNoiseFloorDb();
+
+        std::cout << (ok ? "✓ " : "✗ ") << "Quiet audio gated, results independent of block size" << std::endl;
+        return ok;
+    }
+
+    // A frame with exactly the given sum of squares, alternating in sign so
+    // it has zero crossings whenever it is analysed
+    static std::vector<int16_t> frameWithEnergy(uint64_t sumSquares, size_t n) {
+        std::vector<int16_t> frame(n, 0);
+        for (size_t i = 1; i < n && sumSquares > 0; ++i) {
+            int64_t value = std::min<int64_t>(32767, static_cast<int64_t>(std::sqrt(static_cast<double>(sumSquares))));
+            while (static_cast<uint64_t>(value * value) > sumSquares) --value;
+            while (value < 32767 && static_cast<uint64_t>((value + 1) * (value + 1)) <= sumSquares) ++value;
+            frame[i] = static_cast<int16_t>(i % 2 ? -value : value);
+            sumSquares -= static_cast<uint64_t>(value * value);
+        }
+        return sumSquares == 0 ? frame : std::vector<int16_t>();
+    }
+
+    static bool testGateBoundary() {
+        std::cout << "Testing the level gate at its threshold..." << std::endl;
+
+        // floor(minRms^2 * 2^30 * n) is exact in double for these frame
+        // lengths; a frame with that energy is silence, one step more is not
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> logLevel(-4.0f, std::log10(0.5f));
+        std::vector<float> levels = {0.002f, 0.01f, 0.05f, 1.0f / 3.0f, 1e-4f, 0.5f};
+        for (int i = 0; i < 200; ++i) {
+            levels.push_back(std::pow(10.0f, logLevel(rng)));
+        }
+
+        bool ok = true;
+        int checked = 0;
+        for (int frameMs : {16, 20, 32}) {
+            size_t n = static_cast<size_t>(frameMs) * kRate / 1000;
+            for (float level : levels) {
+                VoiceActivityDetector::Params params;
+                params.minRms = level;
+                params.frameMs = frameMs;
+                double exact = static_cast<double>(level) * static_cast<double>(level) * 1073741824.0 * n;
+                uint64_t limit = static_cast<uint64_t>(std::floor(exact));
+
+                for (uint64_t energy : {limit, limit + 1}) {
+                    auto frame = frameWithEnergy(energy, n);
+                    VoiceActivityDetector vad(kRate, params);
+                    if (frame.empty()) {
+                        ok = false;
+                        continue;
+                    }
+                    vad.processFrame(frame.data(), frame.size());
+                    bool analysed = vad.getFeatures().zeroCrossingRate > 0.0f;
+                    ok &= analysed == (energy > limit);
+                    ++checked;
+                }
+            }
+        }
+
+        std::cout << "  " << checked << " frames on either side of the threshold" << std::endl;
+        std::cout << (ok ? "✓ " : "✗ ") << "Frames at the threshold are silence, one step above are not" << std::endl;
+        return ok;
+    }
+};
+
+int main() {
+    std::cout << "=== Voice Activity Detector Test ===" << std::endl;
+
+    bool ok = SimpleVoiceActivityDetectorTest::testStationaryNoise();
+    ok &= SimpleVoiceActivityDetectorTest::testSpeechInNoise();
+    ok &= SimpleVoiceActivityDetectorTest::testNoiseStep();
+    ok &= SimpleVoiceActivityDetectorTest::testGateAndBlockSizes();
+    ok &= SimpleVoiceActivityDetectorTest::testGateBoundary();
+
+    std::cout << "=== Test Complete ===" << std::endl;
+    return ok ? 0 : 1;
+}